@@ -0,0 +1,404 @@
+#include "../src/common/sdk.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/json.hpp>
+#include <boost/program_options.hpp>
+
+#include "../src/common/boost_logger.h"
+#include "../src/common/cmd_parser.h"
+#include "../src/common/constants.h"
+#include "../src/common/json_loader.h"
+#include "../src/common/metrics.h"
+#include "../src/game_db/local_database.h"
+#include "../src/game_db/mock_database.h"
+#include "../src/http_server/http_server.h"
+#include "../src/http_server/request_handler.h"
+
+// End-to-end load test: game_server runs in this process on a loopback port, thousands of Beast clients
+// on a separate io_context join a game, then poll the state and send random moves until the time is up.
+// Reports request throughput, latency percentiles per request type and the tick time distribution.
+
+namespace {
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace json = boost::json;
+namespace po = boost::program_options;
+using tcp = net::ip::tcp;
+using namespace std::literals;
+using Clock = std::chrono::steady_clock;
+
+struct BenchArgs {
+    std::string config_file = "./data/config.json"s;
+    std::string www_root = "./static"s;
+    std::string map_id{};               // empty - first map of the config
+    uint32_t clients{1000};
+    uint32_t duration{10};              // seconds of measurement
+    uint32_t warmup{2};                 // seconds before measurement (joins happen here)
+    uint32_t client_threads{0};         // 0 - half of the cores
+    uint32_t server_threads{0};         // 0 - half of the cores
+    uint32_t tick_period{50};
+    uint32_t think_time{100};           // milliseconds between requests of one client (0 - closed loop)
+    double action_ratio{0.3};           // share of move actions among requests after join
+    uint16_t port{18080};
+    bool enable_bots{false};
+    bool local_database{false};
+};
+
+[[nodiscard]] std::optional<BenchArgs> ParseBenchArgs(int argc, const char* const argv[]) {
+    BenchArgs args;
+    po::options_description options("Usage: game_server_bench [options]");
+    options.add_options()
+        ("help,h", "Show help")
+        ("config-file,c", po::value(&args.config_file)->value_name("file"s), "Game config (default - ./data/config.json)")
+        ("www-root,w", po::value(&args.www_root)->value_name("dir"s), "Static files root (default - ./static)")
+        ("map", po::value(&args.map_id)->value_name("id"s), "Map to join (default - first map of the config)")
+        ("clients", po::value(&args.clients)->value_name("count"s), "Concurrent clients, one connection each (default - 1000)")
+        ("duration", po::value(&args.duration)->value_name("seconds"s), "Measurement time (default - 10)")
+        ("warmup", po::value(&args.warmup)->value_name("seconds"s), "Time before measurement, clients join here (default - 2)")
+        ("client-threads", po::value(&args.client_threads)->value_name("count"s), "Threads running clients (default - half of the cores)")
+        ("server-threads", po::value(&args.server_threads)->value_name("count"s), "Threads running the server (default - half of the cores)")
+        ("tick-period,t", po::value(&args.tick_period)->value_name("milliseconds"s), "Server tick period (default - 50)")
+        ("think-time", po::value(&args.think_time)->value_name("milliseconds"s),
+            "Mean pause between requests of a client, 0 - send right after the response (default - 100)")
+        ("action-ratio", po::value(&args.action_ratio)->value_name("share"s), "Share of move actions among state polls (default - 0.3)")
+        ("port", po::value(&args.port)->value_name("port"s), "Loopback port of the server (default - 18080)")
+        ("bots,b", po::bool_switch(&args.enable_bots), "Add bots to every game session")
+        ("lcl_db,l", po::bool_switch(&args.local_database), "Use local in-memory database instead of no database");
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, options), vm);
+        po::notify(vm);
+    } catch (const po::error& e) {
+        std::cerr << "Command line parsing error: " << e.what() << std::endl;
+        std::cout << options << std::endl;
+        return std::nullopt;
+    }
+    if (vm.contains("help"s)) {
+        std::cout << options;
+        return std::nullopt;
+    }
+    if (args.clients == 0 || args.duration == 0 || args.tick_period == 0
+        || args.action_ratio < 0.0 || args.action_ratio > 1.0) {
+        std::cerr << "Error: clients, duration and tick-period must be positive, action-ratio in [0, 1]" << std::endl;
+        return std::nullopt;
+    }
+    const unsigned half_cores = std::max(1u, std::thread::hardware_concurrency() / 2);
+    if (args.client_threads == 0) args.client_threads = half_cores;
+    if (args.server_threads == 0) args.server_threads = half_cores;
+    return args;
+}
+
+// Every client holds a connection and a server-side socket, so the default limit of 1024 is hit quickly
+void RaiseOpenFileLimit() {
+#if defined(__linux__)
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+#endif
+}
+
+struct LoadStats {
+    metrics::Histogram join;
+    metrics::Histogram state;
+    metrics::Histogram action;
+    std::atomic<std::uint64_t> http_errors{0};         // non-200 responses
+    std::atomic<std::uint64_t> failed_clients{0};      // connection or protocol failure, client stopped
+    std::atomic<bool> measuring{false};
+    std::atomic<bool> stopping{false};
+};
+
+class BenchClient : public std::enable_shared_from_this<BenchClient> {
+public:
+    BenchClient(net::io_context& ioc, tcp::endpoint server, const BenchArgs& args, std::string name,
+                std::string map_id, std::uint64_t seed, LoadStats& stats)
+        : stream_(net::make_strand(ioc))
+        , timer_(stream_.get_executor())
+        , server_(server)
+        , args_(args)
+        , name_(std::move(name))
+        , map_id_(std::move(map_id))
+        , rng_(seed)
+        , stats_(stats) {
+    }
+
+    void Start() {
+        stream_.async_connect(server_, beast::bind_front_handler(&BenchClient::OnConnect, shared_from_this()));
+    }
+
+private:
+    enum class Op { JOIN, STATE, ACTION };
+
+    void OnConnect(beast::error_code ec) {
+        if (ec) {
+            return Fail();
+        }
+        Send(Op::JOIN);
+    }
+
+    void Send(Op op) {
+        op_ = op;
+        request_ = {};
+        request_.version(11);
+        request_.set(http::field::host, "127.0.0.1");
+        switch (op) {
+            case Op::JOIN:
+                request_.method(http::verb::post);
+                request_.target(std::string(http_handler::api_paths::GAME_JOIN));
+                request_.body() = json::serialize(json::object{
+                    {json_fields::USER_NAME, name_}, {json_fields::MAP_ID, map_id_}});
+                break;
+            case Op::STATE:
+                request_.method(http::verb::get);
+                request_.target(std::string(http_handler::api_paths::GAME_STATE));
+                break;
+            case Op::ACTION:
+                request_.method(http::verb::post);
+                request_.target(std::string(http_handler::api_paths::PLAYER_ACTION));
+                request_.body() = json::serialize(json::object{{json_fields::MOVE, RandomMove()}});
+                break;
+        }
+        if (op != Op::JOIN) {
+            request_.set(http::field::authorization, auth_header_);
+        }
+        if (!request_.body().empty()) {
+            request_.set(http::field::content_type, std::string(http_handler::ContentType::APPLICATION_JSON));
+        }
+        request_.prepare_payload();
+
+        sent_at_ = Clock::now();
+        http::async_write(stream_, request_, beast::bind_front_handler(&BenchClient::OnWrite, shared_from_this()));
+    }
+
+    void OnWrite(beast::error_code ec, std::size_t) {
+        if (ec) {
+            return Fail();
+        }
+        response_ = {};
+        http::async_read(stream_, buffer_, response_, beast::bind_front_handler(&BenchClient::OnRead, shared_from_this()));
+    }
+
+    void OnRead(beast::error_code ec, std::size_t) {
+        if (ec) {
+            return Fail();
+        }
+        if (stats_.measuring.load(std::memory_order_relaxed)) {
+            HistogramFor(op_).Observe(Clock::now() - sent_at_);
+        }
+        if (response_.result() != http::status::ok) {
+            stats_.http_errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (op_ == Op::JOIN && !ReadToken()) {
+            return Fail();
+        }
+        if (stats_.stopping.load(std::memory_order_relaxed)) {
+            return Close();
+        }
+
+        const auto next = std::bernoulli_distribution{args_.action_ratio}(rng_) ? Op::ACTION : Op::STATE;
+        if (args_.think_time == 0) {
+            return Send(next);
+        }
+        // Uniform jitter around the mean keeps clients from polling in lockstep
+        std::uniform_int_distribution<uint32_t> pause(args_.think_time / 2, args_.think_time * 3 / 2);
+        timer_.expires_after(std::chrono::milliseconds(pause(rng_)));
+        timer_.async_wait([self = shared_from_this(), next](beast::error_code ec) {
+            if (!ec) {
+                self->Send(next);
+            }
+        });
+    }
+
+    bool ReadToken() {
+        if (response_.result() != http::status::ok) {
+            return false;
+        }
+        try {
+            auto value = json::parse(response_.body());
+            auth_header_ = std::string(http_handler::api_paths::BEARER)
+                           + std::string(value.as_object().at(json_fields::AUTH_TOKEN).as_string());
+            return true;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    const char* RandomMove() {
+        static constexpr const char* MOVES[] = {
+            app::move_values::LEFT, app::move_values::RIGHT, app::move_values::UP, app::move_values::DOWN,
+            app::move_values::STOP};
+        return MOVES[std::uniform_int_distribution<size_t>{0, std::size(MOVES) - 1}(rng_)];
+    }
+
+    metrics::Histogram& HistogramFor(Op op) {
+        switch (op) {
+            case Op::JOIN: return stats_.join;
+            case Op::ACTION: return stats_.action;
+            default: return stats_.state;
+        }
+    }
+
+    void Fail() {
+        stats_.failed_clients.fetch_add(1, std::memory_order_relaxed);
+        Close();
+    }
+
+    void Close() {
+        beast::error_code ec;
+        stream_.socket().shutdown(tcp::socket::shutdown_both, ec);
+        stream_.close();
+    }
+
+    beast::tcp_stream stream_;
+    net::steady_timer timer_;
+    tcp::endpoint server_;
+    const BenchArgs& args_;
+    std::string name_;
+    std::string map_id_;
+    std::string auth_header_;
+    std::mt19937_64 rng_;
+    LoadStats& stats_;
+
+    Op op_ = Op::JOIN;
+    Clock::time_point sent_at_;
+    http::request<http::string_body> request_;
+    http::response<http::string_body> response_;
+    beast::flat_buffer buffer_;
+};
+
+void PrintLatency(std::string_view name, const metrics::Histogram& histogram) {
+    auto ms = [&](double q) { return static_cast<double>(histogram.ValueAtQuantile(q)) / 1000.0; };
+    std::cout << "  " << std::left << std::setw(8) << name << std::right
+              << std::setw(10) << histogram.Count()
+              << std::setw(10) << ms(0.5) << std::setw(10) << ms(0.99) << std::setw(10) << ms(0.999) << '\n';
+}
+
+} // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto args = ParseBenchArgs(argc, argv);
+        if (!args) {
+            return EXIT_FAILURE;
+        }
+        boost_logger::InitBoostLogSetFilter(boost::log::trivial::warning);
+        RaiseOpenFileLimit();
+
+        // 1. Server: same setup as game_server with --no_db (or --lcl_db), listening on loopback
+        parse::Args server_args;
+        server_args.config_file = args->config_file;
+        server_args.www_root = args->www_root;
+        server_args.tick_period = args->tick_period;
+        server_args.enable_bots = args->enable_bots;
+        server_args.no_database = !args->local_database;
+        server_args.local_database = args->local_database;
+
+        auto game = json_loader::LoadGame(server_args.config_file);
+        if (game.GetMaps().empty()) {
+            throw std::runtime_error("No maps in " + server_args.config_file);
+        }
+        const std::string map_id = args->map_id.empty() ? *game.GetMaps().front().GetId() : args->map_id;
+
+        std::unique_ptr<db::DatabaseInterface> database;
+        if (args->local_database) {
+            database = std::make_unique<db::LocalDatabase>();
+        } else {
+            database = std::make_unique<db::MockDatabase>();
+        }
+
+        net::io_context server_ioc(static_cast<int>(args->server_threads));
+        app::Application app(game, server_args, server_ioc, *database);
+        auto handler = std::make_shared<http_handler::RequestHandler>(app, server_ioc);
+        const tcp::endpoint endpoint{net::ip::make_address("127.0.0.1"), args->port};
+        http_server::ServeHttp(server_ioc, endpoint, [handler](auto&&, auto&& req, auto& arena, auto&& send) {
+            (*handler)(std::forward<decltype(req)>(req), arena, std::forward<decltype(send)>(send));
+        });
+        std::vector<std::jthread> server_threads;
+        for (uint32_t i = 0; i < args->server_threads; ++i) {
+            server_threads.emplace_back([&server_ioc] { server_ioc.run(); });
+        }
+
+        // 2. Clients on their own io_context
+        LoadStats stats;
+        net::io_context client_ioc(static_cast<int>(args->client_threads));
+        for (uint32_t i = 0; i < args->clients; ++i) {
+            std::make_shared<BenchClient>(client_ioc, endpoint, *args, "bench-" + std::to_string(i), map_id,
+                                          std::uint64_t{i} + 1, stats)->Start();
+        }
+        std::vector<std::jthread> client_threads;
+        for (uint32_t i = 0; i < args->client_threads; ++i) {
+            client_threads.emplace_back([&client_ioc] { client_ioc.run(); });
+        }
+
+        // 3. Warm up, measure, stop clients after their current request
+        std::this_thread::sleep_for(std::chrono::seconds(args->warmup));
+        stats.measuring = true;
+        const auto measure_start = Clock::now();
+        std::this_thread::sleep_for(std::chrono::seconds(args->duration));
+        stats.measuring = false;
+        const std::chrono::duration<double> measured = Clock::now() - measure_start;
+        stats.stopping = true;
+
+        // Clients close their connections after the current request; give stuck ones a few seconds
+        const auto give_up_at = Clock::now() + 5s;
+        while (!client_ioc.stopped() && Clock::now() < give_up_at) {
+            std::this_thread::sleep_for(10ms);
+        }
+        client_ioc.stop();
+        client_threads.clear();
+        server_ioc.stop();              // the ticker keeps the server busy forever
+        server_threads.clear();
+
+        // 4. Report
+        const auto requests = stats.join.Count() + stats.state.Count() + stats.action.Count();
+        std::cout << std::fixed << std::setprecision(3)
+                  << "clients: " << args->clients << ", client threads: " << args->client_threads
+                  << ", server threads: " << args->server_threads << ", measured: " << measured.count() << " s\n"
+                  << "requests: " << requests << ", throughput: " << std::setprecision(1)
+                  << static_cast<double>(requests) / measured.count() << " req/s"
+                  << ", http errors: " << stats.http_errors << ", failed clients: " << stats.failed_clients << "\n\n"
+                  << std::setprecision(3)
+                  << "latency, ms     count       p50       p99      p999\n";
+        PrintLatency("join", stats.join);
+        PrintLatency("state", stats.state);
+        PrintLatency("action", stats.action);
+
+        // Tick histograms of the server cover the whole run (warmup included)
+        auto& registry = metrics::Registry::Instance();
+        std::cout << "\ntick, ms        count       p50       p99      p999\n";
+        PrintLatency("duration", registry.GetHistogram("game_tick_duration_seconds", "Wall time of one game tick"));
+        PrintLatency("lag", registry.GetHistogram("game_tick_lag_seconds", "Delay of a tick wakeup past its deadline"));
+        std::cout << "  overruns: "
+                  << registry.GetCounter("game_tick_overruns_total", "Ticks that finished after the next tick deadline").Value()
+                  << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "game_server_bench: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
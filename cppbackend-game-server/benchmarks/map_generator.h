@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/game_model/game_extra_data.h"
+#include "../src/game_model/game_map.h"
+
+// Synthetic maps of configurable size for the model benchmarks
+namespace bench {
+
+struct GridMapOptions {
+    int columns = 10;               // vertical roads
+    int rows = 10;                  // horizontal roads
+    int cell = 10;                  // distance between neighbouring roads
+    int offices = 4;                // placed at random crossings
+    double speed = 3.0;
+    int bag_capacity = 3;
+    std::uint32_t seed = 1;
+};
+
+inline const model::Map::Id GRID_MAP_ID{"grid"};
+
+// Grid of roads crossing at every (column * cell, row * cell).
+// Call BuildRoadIndex() (or pass the map to Game::AddMap) before use.
+inline model::Map MakeGridMap(const GridMapOptions& options = {}) {
+    model::Map map(GRID_MAP_ID, "Grid " + std::to_string(options.columns) + "x" + std::to_string(options.rows));
+    const int width = (options.columns - 1) * options.cell;
+    const int height = (options.rows - 1) * options.cell;
+    for (int row = 0; row < options.rows; ++row) {
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, model_geom::Point2D{0, row * options.cell}, width));
+    }
+    for (int column = 0; column < options.columns; ++column) {
+        map.AddRoad(model::Road(model::Road::VERTICAL, model_geom::Point2D{column * options.cell, 0}, height));
+    }
+
+    std::mt19937 gen{options.seed};
+    std::uniform_int_distribution<int> column_dist(0, options.columns - 1);
+    std::uniform_int_distribution<int> row_dist(0, options.rows - 1);
+    for (int i = 0; i < options.offices; ++i) {
+        map.AddOffice(model::Office(model::Office::Id{"office" + std::to_string(i)},
+                                    {column_dist(gen) * options.cell, row_dist(gen) * options.cell}, {0, 0}));
+    }
+    map.SetDefaultSpeed({options.speed, options.speed});
+    map.SetDefaultCapacity(options.bag_capacity);
+    return map;
+}
+
+// Loot types and generator settings for MakeGridMap maps
+inline std::shared_ptr<extra_data::GameExtraData> MakeExtraData(std::chrono::milliseconds loot_period,
+                                                               double loot_probability) {
+    auto extra = std::make_shared<extra_data::GameExtraData>();
+    extra->AddLootGeneratorConfig({loot_period, loot_probability});
+    std::vector<extra_data::LootData> loot_types;
+    for (extra_data::LootDataType type = 0; type < 3; ++type) {
+        extra_data::LootData loot;
+        loot.map_id = GRID_MAP_ID;
+        loot.type_id = type;
+        loot.name = "loot" + std::to_string(type);
+        loot.value = 10 * (type + 1);
+        loot_types.push_back(std::move(loot));
+    }
+    extra->AddLootTypes(GRID_MAP_ID, std::move(loot_types));
+    return extra;
+}
+
+// Random points on the roads of a built map
+inline std::vector<app_geom::Position2D> RandomRoadPoints(const model::Map& map, size_t count, std::uint32_t seed = 2) {
+    std::mt19937 gen{seed};
+    std::vector<app_geom::Position2D> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        points.push_back(map.GetRandomPoint(gen));
+    }
+    return points;
+}
+
+} // namespace bench
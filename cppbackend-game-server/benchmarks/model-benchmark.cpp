@@ -0,0 +1,235 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+
+#include "map_generator.h"
+#include "../src/common/game_utils/collision_detector.h"
+#include "../src/common/metrics.h"
+#include "../src/game_model/dog.h"
+#include "../src/game_model/game_model.h"
+#include "../src/game_model/loot_storage.h"
+#include "../src/game_model/road_engine/road_graph.h"
+
+using namespace std::literals;
+
+namespace {
+
+constexpr std::array DIRECTIONS = {
+    app_geom::Direction2D::LEFT, app_geom::Direction2D::RIGHT,
+    app_geom::Direction2D::UP, app_geom::Direction2D::DOWN,
+};
+
+// Square grid of range(0) x range(0) roads
+model::Map MakeBuiltGridMap(int size) {
+    auto map = bench::MakeGridMap({.columns = size, .rows = size});
+    map.BuildRoadIndex();
+    return map;
+}
+
+// N items and M gatherers spread over a 1000 x 1000 field, every gatherer moves up to 10 units
+collision_detector::ItemGatherer MakeGatherProvider(size_t items, size_t gatherers) {
+    std::mt19937 gen{1};
+    std::uniform_real_distribution<double> coord(0.0, 1000.0);
+    std::uniform_real_distribution<double> step(-10.0, 10.0);
+
+    collision_detector::ItemGatherer provider;
+    for (size_t i = 0; i < items; ++i) {
+        provider.AddItem({{coord(gen), coord(gen)}, 0.0});
+    }
+    for (size_t i = 0; i < gatherers; ++i) {
+        const app_geom::Position2D start{coord(gen), coord(gen)};
+        provider.AddGatherer({start, {start.x + step(gen), start.y + step(gen)}, 0.6});
+    }
+    return provider;
+}
+
+void BM_FindGatherEvents(benchmark::State& state) {
+    const auto items = static_cast<size_t>(state.range(0));
+    const auto gatherers = static_cast<size_t>(state.range(1));
+    const auto provider = MakeGatherProvider(items, gatherers);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(collision_detector::FindGatherEvents(provider));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(items * gatherers));
+}
+BENCHMARK(BM_FindGatherEvents)->ArgsProduct({{10, 100, 1000}, {10, 100, 1000}});
+
+// Same input, candidates from the item grid (rebuilt on every call, as in GameSession)
+void BM_FindGatherEventsGrid(benchmark::State& state) {
+    const auto items = static_cast<size_t>(state.range(0));
+    const auto gatherers = static_cast<size_t>(state.range(1));
+    const auto provider = MakeGatherProvider(items, gatherers);
+    spatial::SpatialGrid grid;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(collision_detector::FindGatherEvents(provider, grid));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(items * gatherers));
+}
+BENCHMARK(BM_FindGatherEventsGrid)->ArgsProduct({{10, 100, 1000}, {10, 100, 1000}});
+
+void BM_FindRoadsAtPosition(benchmark::State& state) {
+    const auto map = MakeBuiltGridMap(static_cast<int>(state.range(0)));
+    const auto points = bench::RandomRoadPoints(map, 1024);
+    const auto& engine = map.GetRoadEngine();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.FindRoadsAtPosition(points[i++ % points.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindRoadsAtPosition)->RangeMultiplier(4)->Range(4, 256);
+
+// Same query Dog::Move makes when the target leaves the current road
+void BM_ChooseRoadForMovement(benchmark::State& state) {
+    const auto map = MakeBuiltGridMap(static_cast<int>(state.range(0)));
+    const auto points = bench::RandomRoadPoints(map, 1024);
+    const auto& engine = map.GetRoadEngine();
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& from = points[i % points.size()];
+        const auto dir = DIRECTIONS[i % DIRECTIONS.size()];
+        const auto step = utils::Speed2DFromDirection2D(dir, {0.5, 0.5});
+        const app_geom::Position2D to{from.x + step.x, from.y + step.y};
+        benchmark::DoNotOptimize(engine.ChooseRoadForMovement(from, to, dir));
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ChooseRoadForMovement)->RangeMultiplier(4)->Range(4, 256);
+
+void BM_RoadGraphFindPath(benchmark::State& state) {
+    const auto map = MakeBuiltGridMap(static_cast<int>(state.range(0)));
+    const model::RoadGraph graph(map.GetRoads(), map.GetRoadEngine());
+    const auto points = bench::RandomRoadPoints(map, 1024);
+    size_t i = 0, expansions = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(graph.FindPath(points[i % points.size()], points[(i + 1) % points.size()], &expansions));
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["expansions/path"] = benchmark::Counter(
+        static_cast<double>(expansions) / static_cast<double>(state.iterations()));
+}
+BENCHMARK(BM_RoadGraphFindPath)->RangeMultiplier(2)->Range(4, 64);
+
+// One dog running across the grid, turning whenever it stops at a road end
+void BM_DogMove(benchmark::State& state) {
+    const auto map = MakeBuiltGridMap(static_cast<int>(state.range(0)));
+    model::Dog dog{0, "dog", &map};
+    size_t turn = 0;
+    dog.SetDirection(DIRECTIONS[turn]);
+    for (auto _ : state) {
+        dog.Move(50ms);
+        if (dog.GetSpeed() == app_geom::Speed2D::Zero()) {
+            dog.SetDirection(DIRECTIONS[++turn % DIRECTIONS.size()]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DogMove)->RangeMultiplier(4)->Range(4, 256);
+
+void BM_GenerateLoots(benchmark::State& state) {
+    const auto map = MakeBuiltGridMap(64);
+    const auto extra = bench::MakeExtraData(1s, 0.5);
+    const auto& loot_types = extra->GetLootTypes(bench::GRID_MAP_ID);
+    const auto count = static_cast<size_t>(state.range(0));
+    loot::LootStorage storage;
+    storage.Seed(1);
+    for (auto _ : state) {
+        storage.GenerateLoots(count, map.GetRoads(), loot_types);
+        state.PauseTiming();
+        storage.Clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_GenerateLoots)->RangeMultiplier(10)->Range(1, 1000);
+
+// Full tick of one session: range(0) x range(0) grid, range(1) dogs, bots if range(2) != 0.
+// Retirement is off so the population stays constant; dogs stopped at road ends are turned
+// every tick (a cheap pass over the dogs, as players would send new moves).
+void BM_UpdateGameState(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    const auto dogs = static_cast<std::uint32_t>(state.range(1));
+
+    model::Game game{bench::MakeExtraData(1s, 0.5)};
+    game.AddMap(bench::MakeGridMap({.columns = size, .rows = size, .offices = size}));
+    game.SetEnableRetirement(false);
+    game.SetCreateBots(state.range(2) != 0);
+    game.SetBotOptions({.seed = 1});
+    game.SetLootSeed(1);
+
+    boost::asio::io_context ioc;
+    auto* session = game.FindGameSession(game.RequestGameSession(bench::GRID_MAP_ID, ioc).first);
+    const auto points = bench::RandomRoadPoints(*session->GetMap(), dogs);
+    std::vector<model::Dog*> dog_ptrs;
+    for (std::uint32_t id = 0; id < dogs; ++id) {
+        auto* dog = session->RequestDog(id, "dog" + std::to_string(id));
+        dog->SetPosition(points[id]);
+        dog->SetDirection(DIRECTIONS[id % DIRECTIONS.size()]);
+        dog_ptrs.push_back(dog);
+    }
+
+    size_t turn = 0;
+    for (auto _ : state) {
+        session->UpdateGameState(50ms);
+        for (auto* dog : dog_ptrs) {
+            if (dog->GetSpeed() == app_geom::Speed2D::Zero()) {
+                dog->SetDirection(DIRECTIONS[++turn % DIRECTIONS.size()]);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["loot"] = static_cast<double>(session->GetLootStorage().GetLootObjects().size());
+}
+BENCHMARK(BM_UpdateGameState)
+    ->ArgsProduct({{8, 64}, {10, 100, 1000}, {0}})
+    ->Args({64, 100, 1});
+
+// Tick time distribution of the whole game loop with bots: range(0) x range(0) grid, range(1) sessions
+// of one player and BOTS_PER_SESSION bots each, bot planning budget range(2) (0 - plan right away).
+// Every Game::UpdateAllGameSessions call is observed into a histogram like game_tick_duration_seconds;
+// p50 / p99 / max are reported in microseconds, so the budget's effect on tick spikes is visible.
+void BM_BotTickLatency(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    const auto sessions = static_cast<std::uint32_t>(state.range(1));
+
+    auto extra = bench::MakeExtraData(1s, 0.5);
+    extra->SetMaxPlayersPerSession(1);
+    model::Game game{std::move(extra)};
+    game.AddMap(bench::MakeGridMap({.columns = size, .rows = size, .offices = size}));
+    game.SetEnableRetirement(false);
+    game.SetCreateBots(true);
+    game.SetBotOptions({.seed = 1, .plan_budget = static_cast<size_t>(state.range(2))});
+    game.SetLootSeed(1);
+
+    boost::asio::io_context ioc;
+    for (std::uint32_t id = 0; id < sessions; ++id) {
+        auto* session = game.FindGameSession(game.RequestGameSession(bench::GRID_MAP_ID, ioc).first);
+        (void)session->RequestDog(id, "dog" + std::to_string(id));
+    }
+
+    metrics::Histogram ticks;
+    for (auto _ : state) {
+        const auto start = std::chrono::steady_clock::now();
+        game.UpdateAllGameSessions(50ms);
+        ticks.Observe(std::chrono::steady_clock::now() - start);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["p50_us"] = static_cast<double>(ticks.ValueAtQuantile(0.5));
+    state.counters["p99_us"] = static_cast<double>(ticks.ValueAtQuantile(0.99));
+    state.counters["max_us"] = static_cast<double>(ticks.ValueAtQuantile(1.0));
+}
+BENCHMARK(BM_BotTickLatency)
+    ->ArgsProduct({{64, 128}, {100}, {0, 2000, 10000}})
+    ->Iterations(2000)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,135 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/json.hpp>
+
+#include "../src/common/utils.h"
+#include "../src/game_db/mock_database.h"
+#include "../src/http_server/api_handler.h"
+#include "../src/http_server/request_json.h"
+
+using namespace std::literals;
+using namespace http_handler;
+
+namespace {
+
+namespace json = boost::json;
+
+constexpr auto ACTION_BODY = R"({"move": "L"})"sv;
+constexpr auto JOIN_BODY = R"({"userName": "Scooby Doo", "mapId": "map1"})"sv;
+
+// Generic path of ApiHandler before the fast path: DOM in the request arena, then field lookup
+void BM_ParseActionDom(benchmark::State& state) {
+    http_server::RequestArena arena;
+    for (auto _ : state) {
+        json::value value = json::parse(ACTION_BODY, arena.JsonStorage());
+        std::string move(value.as_object().at(json_fields::MOVE).as_string().c_str());
+        benchmark::DoNotOptimize(utils::StringToDirection2D(move));
+        arena.Reset();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseActionDom);
+
+void BM_ParseActionFast(benchmark::State& state) {
+    for (auto _ : state) {
+        auto move = request_json::ParseActionBody(ACTION_BODY);
+        benchmark::DoNotOptimize(utils::StringToDirection2D(*move));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseActionFast);
+
+void BM_ParseJoinDom(benchmark::State& state) {
+    http_server::RequestArena arena;
+    for (auto _ : state) {
+        json::value value = json::parse(JOIN_BODY, arena.JsonStorage());
+        const auto& obj = value.as_object();
+        std::string user_name(obj.at(json_fields::USER_NAME).as_string().c_str());
+        std::string map_id(obj.at(json_fields::MAP_ID).as_string().c_str());
+        benchmark::DoNotOptimize(user_name);
+        benchmark::DoNotOptimize(map_id);
+        arena.Reset();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseJoinDom);
+
+void BM_ParseJoinFast(benchmark::State& state) {
+    for (auto _ : state) {
+        auto body = request_json::ParseJoinBody(JOIN_BODY);
+        std::string user_name(body->user_name);
+        std::string map_id(body->map_id);
+        benchmark::DoNotOptimize(user_name);
+        benchmark::DoNotOptimize(map_id);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseJoinFast);
+
+model::Game MakeGame() {
+    const model::Map::Id map_id{"map1"s};
+    auto extra = std::make_shared<extra_data::GameExtraData>();
+    extra->AddLootGeneratorConfig({5s, 0.5});
+    extra_data::LootData loot_data;
+    loot_data.map_id = map_id;
+    loot_data.name = "coin";
+    loot_data.file = "assets/coin.obj";
+    loot_data.type = "obj";
+    loot_data.value = 5;
+    extra->AddLootTypes(map_id, {loot_data});
+
+    model::Game game{extra};
+    model::Map map(map_id, "Map 1");
+    map.AddRoad(model::Road(model::Road::HORIZONTAL, model_geom::Point2D{0, 0}, 40));
+    map.AddRoad(model::Road(model::Road::VERTICAL, model_geom::Point2D{0, 0}, 40));
+    map.SetDefaultSpeed({1.0, 1.0});
+    map.SetDefaultCapacity(3);
+    game.AddMap(std::move(map));
+    return game;
+}
+
+// Whole off-strand action request on one thread: routing, token check, body parsing, posting
+// to the session inbox and the response; range(0) players take turns, as on a busy server.
+// items_per_second - actions per second one core handles.
+void BM_ActionRequest(benchmark::State& state) {
+    boost::asio::io_context ioc;
+    auto game = MakeGame();
+    parse::Args args;
+    args.no_database = true;
+    db::MockDatabase database;
+    app::Application app(game, args, ioc, database);
+    const ApiHandler handler(app);
+
+    std::vector<std::string> authorizations;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        const auto& player = app.AddPlayer("dog" + std::to_string(i), "map1");
+        authorizations.push_back("Bearer " + **app.GetPlayers().FindTokenByPlayer(player));
+    }
+
+    http_server::RequestArena arena;
+    size_t next = 0;
+    for (auto _ : state) {
+        StringRequest req{http::verb::post, api_paths::PLAYER_ACTION, 11};
+        req.set(http::field::authorization, authorizations[next]);
+        req.set(http::field::content_type, ContentType::APPLICATION_JSON);
+        req.body() = ACTION_BODY;
+        req.prepare_payload();
+        auto res = handler.HandleApiRequest(std::move(req), &arena);
+        arena.Reset();
+        if (res.result() != http::status::ok) {
+            state.SkipWithError("action request rejected");
+            break;
+        }
+        next = next + 1 == authorizations.size() ? 0 : next + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ActionRequest)->Arg(1)->Arg(1000);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <string_view>
+
+#include "../src/http_server/api_router.h"
+
+using namespace std::literals;
+using namespace http_handler;
+
+namespace {
+
+// Handlers do the minimum, so the benchmark measures routing itself
+struct BenchTarget {
+    StringResponse Handle(const RequestContext&) const {
+        return StringResponse{};
+    }
+};
+
+using Spec = RouteSpec<BenchTarget>;
+
+// Same shape as the production table in ApiHandler::RouteTable()
+constexpr auto BENCH_ROUTES = routing::SortRoutes(std::array{
+    Spec{api_paths::MAPS_BASE, {.allowed_methods = Methods({http::verb::get, http::verb::head})}, &BenchTarget::Handle},
+    Spec{api_paths::MAP_BY_ID, {.allowed_methods = Methods({http::verb::get, http::verb::head})}, &BenchTarget::Handle},
+    Spec{api_paths::GAME_JOIN, {.allowed_methods = Methods({http::verb::post})}, &BenchTarget::Handle},
+    Spec{api_paths::GAME_PLAYERS, {.allowed_methods = Methods({http::verb::get, http::verb::head})}, &BenchTarget::Handle},
+    Spec{api_paths::GAME_STATE, {.allowed_methods = Methods({http::verb::get, http::verb::head})}, &BenchTarget::Handle},
+    Spec{api_paths::PLAYER_ACTION, {.allowed_methods = Methods({http::verb::post})}, &BenchTarget::Handle},
+    Spec{api_paths::GAME_TICK, {.allowed_methods = Methods({http::verb::post})}, &BenchTarget::Handle},
+    Spec{api_paths::GAME_RECORDS, {.allowed_methods = Methods({http::verb::get, http::verb::head})}, &BenchTarget::Handle},
+});
+
+constexpr std::array TARGETS = {
+    "/api/v1/game/state"sv,
+    "/api/v1/game/player/action"sv,
+    "/api/v1/maps"sv,
+    "/api/v1/maps/map1"sv,
+    "/api/v1/game/records?start=0&maxItems=100"sv,
+    "/api/v1/unknown/path"sv,
+};
+
+// Path lookup only (static binary search / dynamic segment match)
+void BM_RouterMatch(benchmark::State& state) {
+    ApiRouter<BenchTarget> router(BENCH_ROUTES);
+    const std::string_view target = TARGETS[static_cast<size_t>(state.range(0))];
+    PathParams params;
+    for (auto _ : state) {
+        auto path = routing::NormalizePath(target);
+        benchmark::DoNotOptimize(path);
+        benchmark::DoNotOptimize(router.Match(path, params));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(std::string(target));
+}
+BENCHMARK(BM_RouterMatch)->DenseRange(0, static_cast<int>(TARGETS.size()) - 1);
+
+// Full Route(): match + rule checks + handler call
+void BM_RouterRoute(benchmark::State& state) {
+    ApiRouter<BenchTarget> router(BENCH_ROUTES);
+    BenchTarget target;
+    StringRequest req{http::verb::get, "/api/v1/maps/map1"sv, 11};
+    for (auto _ : state) {
+        auto ctx = MakeRequestContext(req, nullptr);
+        benchmark::DoNotOptimize(router.Route(target, ctx));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RouterRoute);
+
+} // namespace
+
+BENCHMARK_MAIN();
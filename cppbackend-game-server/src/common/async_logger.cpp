@@ -0,0 +1,281 @@
+#include "async_logger.h"
+
+#include <boost/date_time/c_local_time_adjustor.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "boost_logger.h"
+
+namespace async_logger {
+
+namespace {
+
+// Same timestamp format as Boost.Log TimeStamp attribute (local time, ISO extended)
+std::string FormatTimestamp(std::chrono::system_clock::time_point time) {
+    namespace pt = boost::posix_time;
+    using local_adj = boost::date_time::c_local_adjustor<pt::ptime>;
+
+    auto since_epoch = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch());
+    pt::ptime utc = pt::from_time_t(0) + pt::microseconds(since_epoch.count());
+    return pt::to_iso_extended_string(local_adj::utc_to_local(utc));
+}
+
+void AppendEscaped(std::string& out, std::string_view value) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += "\\u00";
+                    out += HEX[(c >> 4) & 0xF];
+                    out += HEX[c & 0xF];
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+void AppendKey(std::string& out, std::string_view key) {
+    AppendEscaped(out, key);
+    out += ':';
+}
+
+// A logger created at the address of a destroyed one must not reuse its thread slots
+std::uint64_t NextLoggerId() {
+    static std::atomic<std::uint64_t> next_id{1};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string IpToString(const LogRecord& record) {
+    namespace ip = boost::asio::ip;
+    if (record.ip_v6) {
+        return ip::address_v6(record.ip).to_string();
+    }
+    ip::address_v4::bytes_type bytes;
+    std::copy_n(record.ip.begin(), bytes.size(), bytes.begin());
+    return ip::address_v4(bytes).to_string();
+}
+
+} // namespace
+
+AsyncLogger::AsyncLogger(Options options)
+    : options_(options)
+    , id_(NextLoggerId()) {
+    options_.sample_rate = std::max(1u, options_.sample_rate);
+    buffer_.reserve(MAX_BATCH * 256);
+}
+
+AsyncLogger::~AsyncLogger() {
+    Stop();
+}
+
+void AsyncLogger::Start() {
+    if (worker_.joinable()) {
+        return;
+    }
+    worker_ = std::jthread([this](std::stop_token stop) {
+        Run(stop);
+    });
+}
+
+void AsyncLogger::Stop() {
+    if (!worker_.joinable()) {
+        return;
+    }
+    worker_.request_stop();
+    worker_.join();
+}
+
+bool AsyncLogger::Sample() noexcept {
+    if (options_.sample_rate == 1) {
+        return true;
+    }
+    thread_local std::uint64_t counter = 0;
+    if (counter++ % options_.sample_rate == 0) {
+        return true;
+    }
+    // Single writer: a plain load and store, no read-modify-write
+    auto& slot = ThreadSlot().count;
+    slot.store(slot.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return false;
+}
+
+AsyncLogger::SampledOutSlot& AsyncLogger::ThreadSlot() {
+    thread_local std::uint64_t owner = 0;
+    thread_local SampledOutSlot* slot = nullptr;
+    if (owner != id_) {
+        std::lock_guard lock{slots_mutex_};
+        slot = &sampled_out_slots_.emplace_back();
+        owner = id_;
+    }
+    return *slot;
+}
+
+std::uint64_t AsyncLogger::SampledOut() const {
+    std::lock_guard lock{slots_mutex_};
+    std::uint64_t sum = 0;
+    for (const auto& slot : sampled_out_slots_) {
+        sum += slot.count.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+void AsyncLogger::LogRequestReceived(const boost::asio::ip::address& ip,
+                                     std::string_view uri,
+                                     std::string_view method) noexcept {
+    bool pushed = ring_.TryPush([&](LogRecord& record) {
+        record.kind = LogRecord::Kind::REQUEST;
+        record.time = std::chrono::system_clock::now();
+        record.ip_v6 = ip.is_v6();
+        if (record.ip_v6) {
+            record.ip = ip.to_v6().to_bytes();
+        } else {
+            auto bytes = ip.to_v4().to_bytes();
+            std::copy(bytes.begin(), bytes.end(), record.ip.begin());
+        }
+        record.uri.Assign(uri);
+        record.method.Assign(method);
+    });
+    if (!pushed) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AsyncLogger::LogResponseSent(std::int64_t response_time,
+                                  int code,
+                                  std::string_view content_type) noexcept {
+    bool pushed = ring_.TryPush([&](LogRecord& record) {
+        record.kind = LogRecord::Kind::RESPONSE;
+        record.time = std::chrono::system_clock::now();
+        record.response_time = response_time;
+        record.code = code;
+        record.has_content_type = !content_type.empty();
+        record.content_type.Assign(content_type);
+    });
+    if (!pushed) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AsyncLogger::Run(std::stop_token stop) {
+    auto last_stats = std::chrono::steady_clock::now();
+    while (!stop.stop_requested()) {
+        size_t count = DrainBatch();
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_stats >= options_.stats_period) {
+            FormatStats();
+            last_stats = now;
+        }
+        Flush();
+
+        if (count == 0) {
+            std::this_thread::sleep_for(options_.idle_sleep);
+        }
+    }
+    // Drain what is left
+    while (DrainBatch() > 0) {
+        Flush();
+    }
+    FormatStats();
+    Flush();
+}
+
+size_t AsyncLogger::DrainBatch() {
+    size_t count = 0;
+    while (count < MAX_BATCH && ring_.TryPop([this](const LogRecord& record) { FormatRecord(record); })) {
+        ++count;
+    }
+    return count;
+}
+
+// {"timestamp":"...","data":{...},"message":"..."} - same layout as boost_logger::MyFormatterJSON
+void AsyncLogger::FormatRecord(const LogRecord& record) {
+    namespace fields = boost_logger::fields;
+    namespace messages = boost_logger::messages;
+
+    buffer_ += '{';
+    AppendKey(buffer_, fields::timestamp);
+    AppendEscaped(buffer_, FormatTimestamp(record.time));
+    buffer_ += ',';
+    AppendKey(buffer_, fields::data);
+    buffer_ += '{';
+    if (record.kind == LogRecord::Kind::REQUEST) {
+        AppendKey(buffer_, fields::ip);
+        AppendEscaped(buffer_, IpToString(record));
+        buffer_ += ',';
+        AppendKey(buffer_, fields::uri);
+        AppendEscaped(buffer_, record.uri.View());
+        buffer_ += ',';
+        AppendKey(buffer_, fields::method);
+        AppendEscaped(buffer_, record.method.View());
+    } else {
+        AppendKey(buffer_, fields::response_time);
+        buffer_ += std::to_string(record.response_time);
+        buffer_ += ',';
+        AppendKey(buffer_, fields::code);
+        buffer_ += std::to_string(record.code);
+        buffer_ += ',';
+        AppendKey(buffer_, fields::content_type);
+        if (record.has_content_type) {
+            AppendEscaped(buffer_, record.content_type.View());
+        } else {
+            buffer_ += "null";
+        }
+    }
+    buffer_ += "},";
+    AppendKey(buffer_, fields::message);
+    AppendEscaped(buffer_, record.kind == LogRecord::Kind::REQUEST ? messages::request_received
+                                                                   : messages::response_sent);
+    buffer_ += "}\n";
+}
+
+// Reports drop/sample counters when they changed since the last report
+void AsyncLogger::FormatStats() {
+    std::uint64_t dropped = Dropped();
+    std::uint64_t sampled_out = SampledOut();
+    if (dropped == reported_dropped_ && sampled_out == reported_sampled_out_) {
+        return;
+    }
+
+    buffer_ += '{';
+    AppendKey(buffer_, boost_logger::fields::timestamp);
+    AppendEscaped(buffer_, FormatTimestamp(std::chrono::system_clock::now()));
+    buffer_ += ',';
+    AppendKey(buffer_, boost_logger::fields::data);
+    buffer_ += '{';
+    AppendKey(buffer_, boost_logger::fields::dropped);
+    buffer_ += std::to_string(dropped - reported_dropped_);
+    buffer_ += ',';
+    AppendKey(buffer_, boost_logger::fields::sampled_out);
+    buffer_ += std::to_string(sampled_out - reported_sampled_out_);
+    buffer_ += "},";
+    AppendKey(buffer_, boost_logger::fields::message);
+    AppendEscaped(buffer_, boost_logger::messages::log_records_skipped);
+    buffer_ += "}\n";
+
+    reported_dropped_ = dropped;
+    reported_sampled_out_ = sampled_out;
+}
+
+// One write per batch
+void AsyncLogger::Flush() {
+    if (buffer_.empty()) {
+        return;
+    }
+    if (options_.output != nullptr || !boost_logger::WriteToConsoleSink(buffer_)) {
+        std::FILE* output = options_.output != nullptr ? options_.output : stdout;
+        std::fwrite(buffer_.data(), 1, buffer_.size(), output);
+        std::fflush(output);
+    }
+    buffer_.clear();
+}
+
+} // namespace async_logger
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <boost/asio/ip/address.hpp>
+
+namespace async_logger {
+
+using namespace std::literals;
+
+// Bounded lock-free MPSC queue (D. Vyukov's bounded queue, single consumer side).
+// Each cell carries a sequence number, so producers never block each other or the consumer:
+// TryPush fails (and the caller counts a drop) when the ring is full.
+template <typename T, size_t Capacity>
+class MpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    MpscRing()
+        : cells_(std::make_unique<Cell[]>(Capacity)) {
+        for (size_t i = 0; i < Capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // fill(T&) writes the record in place; returns false if the ring is full
+    template <typename Fill>
+    bool TryPush(Fill&& fill) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & MASK];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(cell.data);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // consume(const T&) is called for the oldest record; only one thread may call TryPop
+    template <typename Consume>
+    bool TryPop(Consume&& consume) {
+        Cell& cell = cells_[dequeue_pos_ & MASK];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq != dequeue_pos_ + 1) {
+            return false;       // empty (or producer is still writing this cell)
+        }
+        consume(static_cast<const T&>(cell.data));
+        cell.sequence.store(dequeue_pos_ + Capacity, std::memory_order_release);
+        ++dequeue_pos_;
+        return true;
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T data{};
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) size_t dequeue_pos_ = 0;
+};
+
+// Fixed-capacity string inside a record (longer values are truncated)
+template <size_t N>
+struct FixedString {
+    std::uint16_t size = 0;
+    std::array<char, N> data{};
+
+    void Assign(std::string_view value) noexcept {
+        size = static_cast<std::uint16_t>(std::min(value.size(), N));
+        std::copy_n(value.data(), size, data.data());
+    }
+
+    [[nodiscard]] std::string_view View() const noexcept {
+        return {data.data(), size};
+    }
+};
+
+// Compact binary log record: no heap, formatting happens on the background thread
+struct LogRecord {
+    enum class Kind : std::uint8_t { REQUEST, RESPONSE };
+
+    Kind kind = Kind::REQUEST;
+    std::chrono::system_clock::time_point time;
+
+    // REQUEST
+    std::array<unsigned char, 16> ip{};
+    bool ip_v6 = false;
+    FixedString<16> method;
+    FixedString<224> uri;
+
+    // RESPONSE
+    std::int64_t response_time = 0;
+    int code = 0;
+    bool has_content_type = false;
+    FixedString<64> content_type;
+};
+
+struct Options {
+    std::uint32_t sample_rate = 1;                      // log 1 of sample_rate requests (1 - every request)
+    std::chrono::milliseconds idle_sleep = 2ms;         // formatter sleep when the ring is empty
+    std::chrono::seconds stats_period = 10s;            // how often drop/sample counters are reported
+    // nullptr - the Boost.Log console sink (boost_logger::WriteToConsoleSink), stdout if there is none
+    std::FILE* output = nullptr;
+};
+
+// Asynchronous request/response logger.
+// Request path: one TryPush of a fixed-size record (no allocation, no locks, no formatting).
+// Background thread: drains the ring in batches, formats the same JSON lines as
+// boost_logger::MyFormatterJSON and writes each batch at once, under the lock of the Boost.Log console sink,
+// so its lines never interleave with other log records.
+// Under overload records are dropped (never blocks); drops and sampled-out requests are reported
+// periodically and in full on Stop.
+class AsyncLogger {
+public:
+    static constexpr size_t RING_CAPACITY = 8192;
+    static constexpr size_t MAX_BATCH = 256;
+
+    explicit AsyncLogger(Options options = {});
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    void Start();
+    // Stops the formatter thread after draining everything already queued
+    void Stop();
+
+    // Sampling decision for one request (its response shares the decision)
+    [[nodiscard]] bool Sample() noexcept;
+
+    void LogRequestReceived(const boost::asio::ip::address& ip,
+                            std::string_view uri,
+                            std::string_view method) noexcept;
+
+    void LogResponseSent(std::int64_t response_time,
+                         int code,
+                         std::string_view content_type) noexcept;
+
+    [[nodiscard]] std::uint64_t Dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    // Sum over all request threads, exact once those threads are idle
+    [[nodiscard]] std::uint64_t SampledOut() const;
+
+private:
+    // Requests skipped by sampling on one thread: only that thread writes, so there is no shared
+    // cache line on the request path, and the formatter can still read every count
+    struct alignas(64) SampledOutSlot {
+        std::atomic<std::uint64_t> count{0};
+    };
+
+    SampledOutSlot& ThreadSlot();
+
+    void Run(std::stop_token stop);
+    size_t DrainBatch();
+    void FormatRecord(const LogRecord& record);
+    void FormatStats();
+    void Flush();
+
+    Options options_;
+    const std::uint64_t id_;                            // tells threads' cached slots of another logger apart
+    MpscRing<LogRecord, RING_CAPACITY> ring_;
+    std::atomic<std::uint64_t> dropped_{0};
+    mutable std::mutex slots_mutex_;
+    std::deque<SampledOutSlot> sampled_out_slots_;      // one per request thread, stable addresses
+
+    // formatter thread state
+    std::string buffer_;
+    std::uint64_t reported_dropped_ = 0;
+    std::uint64_t reported_sampled_out_ = 0;
+    std::jthread worker_;
+};
+
+} // namespace async_logger
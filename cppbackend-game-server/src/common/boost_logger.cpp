@@ -4,6 +4,16 @@
 
 namespace boost_logger {
 
+namespace {
+
+using ConsoleSink = sinks::synchronous_sink<sinks::text_ostream_backend>;
+
+// Set once by SendBoostLogToStream before any other thread logs
+boost::shared_ptr<ConsoleSink> console_sink;
+std::ostream* console_stream = nullptr;
+
+} // namespace
+
 void InitBoostLog() {
     // logging::trivial::logger::get();
 }
@@ -57,13 +67,25 @@ void SendBoostLogToStream() {
     // This adds TimeStamp, ProcessID, ThreadID attributes
     logging::add_common_attributes();
 
-    logging::add_console_log(
-        std::cout,
+    console_stream = &std::cout;
+    console_sink = logging::add_console_log(
+        *console_stream,
         keywords::format = &MyFormatterJSON,
         keywords::auto_flush = true
         );
 }
 
+bool WriteToConsoleSink(std::string_view lines) {
+    if (!console_sink) {
+        return false;
+    }
+    // The sink's backend mutex: held while Boost.Log writes a record and its line end
+    auto backend = console_sink->locked_backend();
+    console_stream->write(lines.data(), static_cast<std::streamsize>(lines.size()));
+    console_stream->flush();
+    return true;
+}
+
 void SendBoostLogToFile() {
     // This adds TimeStamp, ProcessID, ThreadID attributes
     logging::add_common_attributes();
@@ -100,7 +122,7 @@ void LogServerExited(int code, const std::string &exception) {
         << messages::server_exited;
 }
 
-void LogRequestReceived(const std::string &ip, const std::string &uri, const std::string &method) {
+void LogRequestReceived(const std::string &ip, std::string_view uri, std::string_view method) {
     BOOST_LOG_TRIVIAL(info)
     << logging::add_value(additional_data,
                           json::object{
@@ -111,7 +133,7 @@ void LogRequestReceived(const std::string &ip, const std::string &uri, const std
     << messages::request_received;
 }
 
-void LogResponseSent(int response_time, int code, const std::string &content_type) {
+void LogResponseSent(int response_time, int code, std::string_view content_type) {
     json::object data{
         {fields::response_time, response_time},
         {fields::code, code}
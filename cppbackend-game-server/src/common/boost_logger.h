@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include <boost/log/trivial.hpp>     // для BOOST_LOG_TRIVIAL
 #include <boost/log/core.hpp>        // для logging::core
@@ -50,6 +51,10 @@ namespace fields {
     constexpr const char* response_time = "response_time";
     constexpr const char* content_type = "content_type";
 
+    // Поля для статистики асинхронного логгера
+    constexpr const char* dropped = "dropped";
+    constexpr const char* sampled_out = "sampled_out";
+
     // Поля для ошибок
     constexpr const char* text = "text";
     constexpr const char* where = "where";
@@ -62,6 +67,7 @@ namespace messages {
     constexpr const char* request_received = "request received";
     constexpr const char* response_sent = "response sent";
     constexpr const char* error = "error";
+    constexpr const char* log_records_skipped = "log records skipped";
     }
 
     // Значения для поля "where" в ошибках
@@ -85,6 +91,10 @@ void InitBoostLogSetFilter(const logging::trivial::severity_level &level = loggi
 
 void SendBoostLogToStream();
 
+// Writes ready-made log lines to the console sink of SendBoostLogToStream while holding the sink's lock,
+// so they never interleave with Boost.Log records. Returns false if there is no console sink.
+bool WriteToConsoleSink(std::string_view lines);
+
 void SendBoostLogToFile();
 
 // Удобные обертки для логирования
@@ -93,12 +103,12 @@ void LogServerStarted(int port, const std::string& address);
 void LogServerExited(int code = 0, const std::string& exception = "");
 
 void LogRequestReceived(const std::string& ip,
-                        const std::string& uri,
-                        const std::string& method);
+                        std::string_view uri,
+                        std::string_view method);
 
 void LogResponseSent(int response_time,
                      int code,
-                     const std::string& content_type = "");
+                     std::string_view content_type = {});
 
 void LogError(int code,
               const std::string& text,
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <optional>
 #include <string>
@@ -12,18 +14,47 @@ constexpr static inline const char* TICK_PERIOD = "tick-period";
 constexpr static inline const char* CONFIG_FILE = "config-file";
 constexpr static inline const char* WWW_ROOT = "www-root";
 constexpr static inline const char* SPAWN_POINTS = "randomize-spawn-points";
+constexpr static inline uint32_t MAX_IO_SHARDS = 256;
+constexpr static inline uint32_t MAX_BOT_THREADS = 256;
+constexpr static inline uint32_t MAX_SHARD_COUNT = 64;
+constexpr static inline uint32_t MIN_COMPRESS_LEVEL = 1;
+constexpr static inline uint32_t MAX_COMPRESS_LEVEL = 9;
+constexpr static inline std::string_view SHARD_MODE_FRONT = "front";
+constexpr static inline std::string_view SHARD_MODE_WORKER = "worker";
 
 using namespace std::literals;
 
 struct Args {
     uint32_t tick_period{0};
+    bool fixed_step{false};                 // tick handler always gets tick_period, late ticks are caught up
+    uint32_t max_catch_up{5};               // max ticks run at once to catch up in fixed-step mode
     std::string config_file = "./data/config.json"s;
     std::string www_root = "./static"s;
     std::string state_file{};
     uint32_t save_state_period{0};
     bool randomize_spawn_points{false};     // players spawns randomly
     bool enable_bots{false};                // enable-bots for each GameSession
+    uint32_t bot_threads{0};                // extra threads for bot decisions (0 - decide on the tick thread)
+    uint64_t bot_seed{0};                   // base seed of bot random streams (0 - random)
+    uint32_t bot_plan_budget{0};            // bot path search expansions per game tick, all sessions together (0 - unlimited)
+    uint64_t game_seed{0};                  // base seed of loot placement and random spawn points (0 - random)
+    std::string record_replay{};            // file to record joins, actions and ticks for game_replay
     bool no_database{false};         // if remote database used to save Players score
+    uint32_t io_shards{0};                  // number of io_context shards with own SO_REUSEPORT acceptor (0/1 - single io_context)
+    bool pin_threads{false};                // pin shard threads to CPU cores
+    bool async_log{false};                  // request/response log lines formatted & written by background thread
+    uint32_t log_sample{1};                 // log 1 of N requests in async-log mode
+    std::string shard_mode{};               // multi-process mode: "front" or "worker" (empty - single process)
+    uint32_t shard_count{1};                // number of worker processes
+    uint32_t shard_index{0};                // this worker's index in [0, shard_count)
+    std::string shard_socket_dir = "/tmp/game_server_shards"s;  // Unix sockets of the workers
+    uint32_t token_rate{0};                 // API requests per second per player token (0 - unlimited)
+    uint32_t ip_rate{0};                    // API requests per second per client IP (0 - unlimited)
+    uint32_t rate_burst{0};                 // token bucket size (0 - one second worth of requests)
+    uint32_t max_in_flight{0};              // API requests admitted and not answered, over it - 503 (0 - unlimited)
+    bool compress{false};                   // gzip / deflate response bodies negotiated by Accept-Encoding
+    uint32_t compress_min_size{1024};       // smaller response bodies are sent uncompressed
+    uint32_t compress_level{1};             // zlib level of bodies compressed per response (1 - fast .. 9 - smallest)
     // Hidden options
     bool local_database{false};             // if local database used to save Players score
 };
@@ -46,6 +77,63 @@ struct Args {
         return false;
     }
 
+    // Validate max_catch_up
+    if (args.max_catch_up == 0) {
+        error_message = "Error: max-catch-up must be at least 1";
+        return false;
+    }
+
+    // Validate io_shards
+    if (args.io_shards > MAX_IO_SHARDS) {
+        error_message = "Error: io-shards cannot exceed " + std::to_string(MAX_IO_SHARDS);
+        return false;
+    }
+
+    // Validate bot_threads
+    if (args.bot_threads > MAX_BOT_THREADS) {
+        error_message = "Error: bot-threads cannot exceed " + std::to_string(MAX_BOT_THREADS);
+        return false;
+    }
+
+    // Validate log_sample
+    if (args.log_sample == 0) {
+        error_message = "Error: log-sample must be at least 1";
+        return false;
+    }
+
+    // Validate compress_level
+    if (args.compress_level < MIN_COMPRESS_LEVEL || args.compress_level > MAX_COMPRESS_LEVEL) {
+        error_message = "Error: compress-level must be in [" + std::to_string(MIN_COMPRESS_LEVEL) + ", "
+                        + std::to_string(MAX_COMPRESS_LEVEL) + "]";
+        return false;
+    }
+
+    // Validate sharding
+    if (!args.shard_mode.empty()) {
+        if (args.shard_mode != SHARD_MODE_FRONT && args.shard_mode != SHARD_MODE_WORKER) {
+            error_message = "Error: shard-mode must be 'front' or 'worker'";
+            return false;
+        }
+        if (args.shard_count == 0 || args.shard_count > MAX_SHARD_COUNT) {
+            error_message = "Error: shard-count must be in [1, " + std::to_string(MAX_SHARD_COUNT) + "]";
+            return false;
+        }
+        if (args.shard_index >= args.shard_count) {
+            error_message = "Error: shard-index must be less than shard-count";
+            return false;
+        }
+        if (args.shard_socket_dir.empty()) {
+            error_message = "Error: shard-socket-dir cannot be empty";
+            return false;
+        }
+        try {
+            fs::create_directories(args.shard_socket_dir);
+        } catch (const fs::filesystem_error& e) {
+            error_message = "Error creating directory: [" + args.shard_socket_dir + "] - " + std::string(e.what());
+            return false;
+        }
+    }
+
     // Validate config_file
     if (args.config_file.empty()) {
         error_message = "Error: config-file path cannot be empty";
@@ -71,6 +159,12 @@ struct Args {
         return false;
     }
 
+    // A replay starts from an empty world, a restored state would not be in the log
+    if (!args.record_replay.empty() && !args.state_file.empty()) {
+        error_message = "Error: record-replay cannot be combined with state-file";
+        return false;
+    }
+
     if (args.state_file.empty()) {
         return true;
     }
@@ -130,6 +224,16 @@ struct Args {
             po::value(&args.tick_period)->value_name("milliseconds"s),
             "Set period for automatic updating of game state")
 
+        // Опция --fixed-step, обновляет игровое состояние шагами фиксированной длины tick-period, пропущенные тики догоняются
+        ("fixed-step",
+            po::bool_switch(&args.fixed_step),
+            "Update game state in fixed steps of tick-period, catching up late ticks (bool flag, no value needed, default - false)")
+
+        // Опция --max-catch-up, задаёт максимальное число тиков, выполняемых подряд для догона в режиме --fixed-step
+        ("max-catch-up",
+            po::value(&args.max_catch_up)->value_name("ticks"s),
+            "Set max ticks run at once to catch up in fixed-step mode, older ticks are dropped (default - 5)")
+
         // Опция --state-file, задаёт путь к файлу сохранения игры
         ("state-file,s", po::value(&args.state_file)->value_name("file"s),
             "Set path to the game save file")
@@ -145,6 +249,31 @@ struct Args {
             po::bool_switch(&args.enable_bots),
             "Set bots for each GameSession (bool flag, no value needed, default - false)")
 
+        // Опция --bot-threads, задаёт число дополнительных потоков для параллельного расчёта решений ботов
+        ("bot-threads",
+            po::value(&args.bot_threads)->value_name("count"s),
+            "Set number of extra threads computing bot decisions in parallel (0 - on the tick thread, default - 0)")
+
+        // Опция --bot-seed, задаёт начальное значение генераторов случайных чисел ботов (воспроизводимое поведение)
+        ("bot-seed",
+            po::value(&args.bot_seed)->value_name("seed"s),
+            "Set seed of bot random streams for reproducible bot behaviour (0 - random seed, default - 0)")
+
+        // Опция --bot-plan-budget, ограничивает число шагов поиска пути ботов за тик (остальные боты ждут в очереди)
+        ("bot-plan-budget",
+            po::value(&args.bot_plan_budget)->value_name("expansions"s),
+            "Set bot path search budget per session tick in graph node expansions, waiting bots queue (0 - unlimited, default - 0)")
+
+        // Опция --game-seed, задаёт начальное значение генераторов случайных чисел для трофеев и точек появления собак
+        ("game-seed",
+            po::value(&args.game_seed)->value_name("seed"s),
+            "Set seed of loot placement and random spawn points for reproducible games (0 - random seed, default - 0)")
+
+        // Опция --record-replay, записывает входы игры (подключения, действия, тики, seed) в файл для game_replay
+        ("record-replay",
+            po::value(&args.record_replay)->value_name("file"s),
+            "Record joins, actions, ticks and seeds to a binary log replayable by game_replay (default - off)")
+
         // Опция --randomize-spawn-points, включает режим, при котором пёс игрока появляется в случайной точке случайно выбранной дороги карты
         ("randomize-spawn-points,r",
             po::bool_switch(&args.randomize_spawn_points),
@@ -158,7 +287,82 @@ struct Args {
         // if local database used to save Players score
         ("lcl_db,l",
             po::bool_switch(&args.local_database),
-            "Use Local (w\\o SQL) database to save Player's score (bool flag, no value needed, default - false)");
+            "Use Local (w\\o SQL) database to save Player's score (bool flag, no value needed, default - false)")
+
+        // Опция --io-shards, задаёт число io_context-шардов, каждый со своим acceptor (SO_REUSEPORT) и потоком
+        ("io-shards",
+            po::value(&args.io_shards)->value_name("count"s),
+            "Set number of io_context shards with own acceptor and thread (0 - single shared io_context, default - 0)")
+
+        // Опция --pin-threads, привязывает поток каждого шарда к отдельному ядру процессора
+        ("pin-threads",
+            po::bool_switch(&args.pin_threads),
+            "Pin shard threads to CPU cores (bool flag, no value needed, default - false)")
+
+        // Опция --async-log, переносит форматирование и запись логов запросов в фоновый поток
+        ("async-log",
+            po::bool_switch(&args.async_log),
+            "Log requests/responses asynchronously via lock-free ring buffer (bool flag, no value needed, default - false)")
+
+        // Опция --log-sample, логировать только каждый N-й запрос (в режиме --async-log)
+        ("log-sample",
+            po::value(&args.log_sample)->value_name("N"s),
+            "Log 1 of N requests in async-log mode (default - 1, every request)")
+
+        // Опция --shard-mode, многопроцессный режим: front принимает HTTP и направляет запросы воркерам по картам
+        ("shard-mode",
+            po::value(&args.shard_mode)->value_name("front|worker"s),
+            "Run as the front router or as a map shard worker of a multi-process server (default - single process)")
+
+        // Опция --shard-count, задаёт число процессов-воркеров
+        ("shard-count",
+            po::value(&args.shard_count)->value_name("count"s),
+            "Set number of shard worker processes (default - 1)")
+
+        // Опция --shard-index, задаёт номер этого воркера
+        ("shard-index",
+            po::value(&args.shard_index)->value_name("index"s),
+            "Set index of this shard worker, from 0 to shard-count - 1 (default - 0)")
+
+        // Опция --shard-socket-dir, задаёт каталог Unix-сокетов воркеров
+        ("shard-socket-dir",
+            po::value(&args.shard_socket_dir)->value_name("dir"s),
+            "Set directory of shard worker Unix sockets (default - /tmp/game_server_shards)")
+
+        // Опция --token-rate, ограничивает частоту API-запросов одного игрока (ответ 429)
+        ("token-rate",
+            po::value(&args.token_rate)->value_name("rps"s),
+            "Limit API requests per second per player token, over the limit - 429 (0 - unlimited, default - 0)")
+
+        // Опция --ip-rate, ограничивает частоту API-запросов с одного IP-адреса (ответ 429)
+        ("ip-rate",
+            po::value(&args.ip_rate)->value_name("rps"s),
+            "Limit API requests per second per client IP, over the limit - 429 (0 - unlimited, default - 0)")
+
+        // Опция --rate-burst, задаёт число запросов, допустимых подряд сверх средней частоты
+        ("rate-burst",
+            po::value(&args.rate_burst)->value_name("requests"s),
+            "Set requests allowed at once by token-rate / ip-rate (0 - one second worth of requests, default - 0)")
+
+        // Опция --max-in-flight, ограничивает число принятых и ещё не обработанных API-запросов (ответ 503)
+        ("max-in-flight",
+            po::value(&args.max_in_flight)->value_name("requests"s),
+            "Shed API requests with 503 while this many are admitted and not answered (0 - unlimited, default - 0)")
+
+        // Опция --compress, сжимает ответы (gzip / deflate) по заголовку Accept-Encoding
+        ("compress",
+            po::bool_switch(&args.compress),
+            "Compress response bodies with gzip / deflate negotiated by Accept-Encoding (bool flag, no value needed, default - false)")
+
+        // Опция --compress-min-size, задаёт минимальный размер сжимаемого тела ответа в байтах
+        ("compress-min-size",
+            po::value(&args.compress_min_size)->value_name("bytes"s),
+            "Set smallest response body compressed, smaller ones are sent as they are (default - 1024)")
+
+        // Опция --compress-level, задаёт уровень сжатия zlib для ответов, сжимаемых при каждом запросе
+        ("compress-level",
+            po::value(&args.compress_level)->value_name("1-9"s),
+            "Set zlib level of responses compressed per request, 1 - fastest .. 9 - smallest (default - 1)");
 
     po::options_description hidden("Hidden options");
 
@@ -211,6 +415,12 @@ struct Args {
         return std::nullopt;
     }
 
+    // Workers are started with one command line apart from --shard-index: each keeps its own snapshot,
+    // otherwise they overwrite each other's file and all restore every session
+    if (args.shard_mode == SHARD_MODE_WORKER && !args.state_file.empty()) {
+        args.state_file += ".shard-" + std::to_string(args.shard_index);
+    }
+
     // С опциями программы всё в порядке, возвращаем структуру args
     return args;
 }
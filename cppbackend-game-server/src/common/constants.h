@@ -16,7 +16,10 @@ namespace common_values {
     constexpr static inline size_t DEFAULT_LOOT_CONFIG_PERIOD = 100;
     constexpr static inline double DEFAULT_LOOT_CONFIG_PROBABILITY = 0.5;
     constexpr static inline size_t DOG_BOT_START_ID = 10001;     // big enough value to diff from real Player
-    constexpr static inline size_t MAX_PLAYERS_ON_MAP = 12;
+    constexpr static inline size_t DEFAULT_MAX_PLAYERS_PER_SESSION = 12;   // "maxPlayersPerSession" not set
+    constexpr static inline size_t BOTS_PER_SESSION = DEFAULT_MAX_PLAYERS_PER_SESSION / 2;
+    constexpr static inline double DEFAULT_INTEREST_RADIUS = 0.0;            // "interestRadius" not set - whole map
+    constexpr static inline size_t DEFAULT_SESSION_IDLE_TIME_SEC = 30;       // "sessionIdleTime" not set
     constexpr static inline double BOT_DIR_CHANGE_PROBABILITY = DEFAULT_DOG_SPEED / 10.0;
     constexpr static inline size_t SEC_TO_MSEC = 1000;
     constexpr static inline size_t MIN_TO_SEC = 60;
@@ -49,6 +52,9 @@ namespace json_fields {
     constexpr static inline const char* DEFAULT_BAG_CAPACITY = "defaultBagCapacity";
     constexpr static inline const char* BAG_CAPACITY = "bagCapacity";
     constexpr static inline const char* DOG_RETIREMENT_TIME = "dogRetirementTime";
+    constexpr static inline const char* MAX_PLAYERS_PER_SESSION = "maxPlayersPerSession";
+    constexpr static inline const char* INTEREST_RADIUS = "interestRadius";
+    constexpr static inline const char* SESSION_IDLE_TIME = "sessionIdleTime";
     constexpr static inline const char* GAME_RECORDS_OFFSET = "start";
     constexpr static inline const char* GAME_RECORDS_MAX_ITEMS = "maxItems";
 
@@ -105,6 +111,7 @@ struct ContentType {
     constexpr inline static std::string_view TEXT_HTML = "text/html"sv;
     constexpr inline static std::string_view TEXT_CSS = "text/css"sv;
     constexpr inline static std::string_view TEXT_PLAIN = "text/plain"sv;
+    constexpr inline static std::string_view PROMETHEUS_TEXT = "text/plain; version=0.0.4"sv;
     constexpr inline static std::string_view TEXT_JAVASCRIPT = "text/javascript"sv;
     constexpr inline static std::string_view APPLICATION_JSON = "application/json"sv;
     constexpr inline static std::string_view APPLICATION_XML = "application/xml"sv;
@@ -131,6 +138,9 @@ namespace error_codes {
     constexpr inline static std::string_view INVALID_TOKEN = "invalidToken"sv;
     constexpr inline static std::string_view UNKNOWN_TOKEN = "unknownToken"sv;
     constexpr inline static std::string_view ACTION_PARSE_ERROR = "actionParseError"sv;
+    constexpr inline static std::string_view SHARD_UNAVAILABLE = "shardUnavailable"sv;
+    constexpr inline static std::string_view TOO_MANY_REQUESTS = "tooManyRequests"sv;
+    constexpr inline static std::string_view SERVER_OVERLOADED = "serverOverloaded"sv;
 }
 
 // Сообщения об ошибках API
@@ -154,6 +164,9 @@ namespace error_messages {
     constexpr inline static std::string_view INVALID_ACTION_VALUE = "Invalid action-move value"sv;
     constexpr inline static std::string_view TICK_PARSE_ERROR = "Failed to parse tick value"sv;
     constexpr inline static std::string_view INVALID_TICK_VALUE = "Invalid tick value"sv;
+    constexpr inline static std::string_view SHARD_UNAVAILABLE = "Game shard is not available"sv;
+    constexpr inline static std::string_view TOO_MANY_REQUESTS = "Request rate limit exceeded"sv;
+    constexpr inline static std::string_view SERVER_OVERLOADED = "Server is overloaded, retry later"sv;
 }
 
 // Пути API
@@ -163,6 +176,7 @@ namespace api_paths {
     constexpr inline static std::string_view SLASH = "/"sv;
     constexpr inline static std::string_view COLON = ":"sv;
     constexpr inline static std::string_view ID = ":id"sv;
+    constexpr inline static std::string_view MAP_BY_ID = "/api/v1/maps/:id"sv;
     constexpr inline static std::string_view INDEX_HTML = "index.html"sv;
     constexpr inline static std::string_view GAME_BASE = "/api/v1/game"sv;
     constexpr inline static std::string_view GAME_JOIN = "/api/v1/game/join"sv;
@@ -172,6 +186,7 @@ namespace api_paths {
     constexpr inline static std::string_view BEARER = "Bearer "sv;
     constexpr inline static std::string_view GAME_TICK = "/api/v1/game/tick"sv;
     constexpr inline static std::string_view GAME_RECORDS = "/api/v1/game/records"sv;
+    constexpr inline static std::string_view METRICS = "/api/v1/metrics"sv;
 }
 
 // HTTP методы
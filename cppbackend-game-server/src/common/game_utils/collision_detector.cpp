@@ -57,4 +57,43 @@ std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provide
     return events;
 }
 
+std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provider, spatial::SpatialGrid& item_grid) {
+    std::vector<GatheringEvent> events;
+    const size_t items_count = provider.ItemsCount();
+
+    item_grid.Clear();
+    double max_item_width = 0.0;
+    for (size_t i = 0; i < items_count; ++i) {
+        const Item item = provider.GetItem(i);
+        item_grid.Add(static_cast<std::uint32_t>(i), item.position);
+        max_item_width = std::max(max_item_width, item.width);
+    }
+    item_grid.Build();
+
+    for (size_t g = 0; g < provider.GatherersCount(); ++g) {
+        const Gatherer gatherer = provider.GetGatherer(g);
+        if (gatherer.start_pos == gatherer.end_pos) {
+            continue;
+        }
+
+        const double reach = gatherer.width + max_item_width;
+        const app_geom::Position2D lo{std::min(gatherer.start_pos.x, gatherer.end_pos.x) - reach,
+                                      std::min(gatherer.start_pos.y, gatherer.end_pos.y) - reach};
+        const app_geom::Position2D hi{std::max(gatherer.start_pos.x, gatherer.end_pos.x) + reach,
+                                      std::max(gatherer.start_pos.y, gatherer.end_pos.y) + reach};
+        item_grid.ForEachInBox(lo, hi, [&](const spatial::Item& grid_item) {
+            const Item item = provider.GetItem(grid_item.id);
+            const double combined = gatherer.width + item.width;
+            CollectionResult res = TryCollectPoint(gatherer.start_pos, gatherer.end_pos, item.position);
+            if (res.proj_ratio >= 0.0 && res.proj_ratio <= 1.0 && res.sq_distance <= combined * combined) {
+                events.push_back({grid_item.id, g, res.sq_distance, res.proj_ratio});
+            }
+        });
+    }
+
+    // Grid visiting order is arbitrary - ties in time are broken by ids
+    SortEvents(events);
+    return events;
+}
+
 }  // namespace collision_detector
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace game_rng {
+
+    // Philox4x32-10 counter-based generator (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+    // Block i of a stream is a pure function of (seed, stream, i): streams are independent of each other
+    // and of the order in which they are advanced, so each bot can draw numbers on any thread and the
+    // outcome depends only on the seed. Satisfies UniformRandomBitGenerator (usable with <random> distributions).
+    class Philox4x32 {
+    public:
+        using result_type = std::uint32_t;
+        using Block = std::array<std::uint32_t, 4>;
+        using Key = std::array<std::uint32_t, 2>;
+
+        static constexpr int ROUNDS = 10;
+
+        constexpr Philox4x32(std::uint64_t seed, std::uint64_t stream) noexcept
+            : key_{Low(seed), High(seed)}
+            , counter_{0, 0, Low(stream), High(stream)} {
+        }
+
+        static constexpr result_type min() noexcept { return 0; }
+        static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+        constexpr result_type operator()() noexcept {
+            if (index_ == block_.size()) {
+                block_ = Generate(counter_, key_);
+                // 64-bit block index in the low counter words, stream id stays in the high ones
+                if (++counter_[0] == 0) {
+                    ++counter_[1];
+                }
+                index_ = 0;
+            }
+            return block_[index_++];
+        }
+
+        // Skips n outputs
+        constexpr void discard(unsigned long long n) noexcept {
+            for (; n > 0; --n) {
+                operator()();
+            }
+        }
+
+        // Raw block function: 10 rounds of Philox S-box over the counter
+        static constexpr Block Generate(Block counter, Key key) noexcept {
+            for (int round = 0; round < ROUNDS; ++round) {
+                if (round > 0) {
+                    key[0] += W0;
+                    key[1] += W1;
+                }
+                const std::uint64_t product0 = std::uint64_t{M0} * counter[0];
+                const std::uint64_t product1 = std::uint64_t{M1} * counter[2];
+                counter = {
+                    static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                    static_cast<std::uint32_t>(product1),
+                    static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                    static_cast<std::uint32_t>(product0)
+                };
+            }
+            return counter;
+        }
+
+    private:
+        static constexpr std::uint32_t M0 = 0xD2511F53;
+        static constexpr std::uint32_t M1 = 0xCD9E8D57;
+        static constexpr std::uint32_t W0 = 0x9E3779B9;     // golden ratio
+        static constexpr std::uint32_t W1 = 0xBB67AE85;     // sqrt(3) - 1
+
+        static constexpr std::uint32_t Low(std::uint64_t value) noexcept { return static_cast<std::uint32_t>(value); }
+        static constexpr std::uint32_t High(std::uint64_t value) noexcept { return static_cast<std::uint32_t>(value >> 32); }
+
+        Key key_;
+        Block counter_;
+        Block block_{};
+        size_t index_ = 4;          // block_ exhausted - generate on first call
+    };
+
+    // Known answer from the Random123 test vectors: zero counter, zero key
+    static_assert(Philox4x32::Generate({0, 0, 0, 0}, {0, 0}) ==
+                  Philox4x32::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+
+} // namespace game_rng
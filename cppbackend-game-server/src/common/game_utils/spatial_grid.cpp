@@ -0,0 +1,99 @@
+#include "spatial_grid.h"
+
+namespace spatial {
+
+    void SpatialGrid::Build() {
+        items_.clear();
+        cell_start_.clear();
+        by_id_.clear();
+        if (pending_.empty()) {
+            cols_ = rows_ = 0;
+            return;
+        }
+
+        // Bounding box of all items
+        double max_x = pending_.front().pos.x;
+        double max_y = pending_.front().pos.y;
+        min_x_ = max_x;
+        min_y_ = max_y;
+        for (const auto& item : pending_) {
+            min_x_ = std::min(min_x_, item.pos.x);
+            min_y_ = std::min(min_y_, item.pos.y);
+            max_x = std::max(max_x, item.pos.x);
+            max_y = std::max(max_y, item.pos.y);
+        }
+
+        // Cell size giving about ITEMS_PER_CELL items per cell for evenly spread items
+        const double width = std::max(max_x - min_x_, MIN_CELL_SIZE);
+        const double height = std::max(max_y - min_y_, MIN_CELL_SIZE);
+        const double cell_count = std::max(1.0, static_cast<double>(pending_.size()) / ITEMS_PER_CELL);
+        cell_size_ = std::max(std::sqrt(width * height / cell_count), MIN_CELL_SIZE);
+        cols_ = static_cast<size_t>(width / cell_size_) + 1;
+        rows_ = static_cast<size_t>(height / cell_size_) + 1;
+
+        // Counting sort by cell
+        cell_start_.assign(cols_ * rows_ + 1, 0);
+        for (const auto& item : pending_) {
+            ++cell_start_[Row(item.pos.y) * cols_ + Column(item.pos.x) + 1];
+        }
+        for (size_t cell = 1; cell < cell_start_.size(); ++cell) {
+            cell_start_[cell] += cell_start_[cell - 1];
+        }
+        items_.resize(pending_.size());
+        by_id_.resize(pending_.size());
+        for (const auto& item : pending_) {
+            auto& slot = cell_start_[Row(item.pos.y) * cols_ + Column(item.pos.x)];
+            items_[slot++] = item;
+        }
+        // Slots were advanced to the end of their cells - shift back to starts
+        for (size_t cell = cell_start_.size() - 1; cell > 0; --cell) {
+            cell_start_[cell] = cell_start_[cell - 1];
+        }
+        cell_start_[0] = 0;
+
+        for (std::uint32_t i = 0; i < by_id_.size(); ++i) {
+            by_id_[i] = i;
+        }
+        std::ranges::sort(by_id_, [this](std::uint32_t a, std::uint32_t b) {
+            return items_[a].id < items_[b].id;
+        });
+        pending_.clear();
+    }
+
+    const Item* SpatialGrid::Find(std::uint32_t id) const noexcept {
+        auto it = std::ranges::lower_bound(by_id_, id, {}, [this](std::uint32_t index) {
+            return items_[index].id;
+        });
+        if (it == by_id_.end() || items_[*it].id != id) {
+            return nullptr;
+        }
+        return &items_[*it];
+    }
+
+    size_t SpatialGrid::Column(double x) const noexcept {
+        if (x <= min_x_) {
+            return 0;
+        }
+        return std::min(static_cast<size_t>((x - min_x_) / cell_size_), cols_ - 1);
+    }
+
+    size_t SpatialGrid::Row(double y) const noexcept {
+        if (y <= min_y_) {
+            return 0;
+        }
+        return std::min(static_cast<size_t>((y - min_y_) / cell_size_), rows_ - 1);
+    }
+
+    // Keeps out sorted by distance and no longer than k
+    void SpatialGrid::Offer(const Item& item, double distance, size_t k, std::vector<Neighbor>& out) {
+        if (out.size() == k && distance >= out.back().distance) {
+            return;
+        }
+        auto pos = std::ranges::upper_bound(out, distance, {}, &Neighbor::distance);
+        out.insert(pos, Neighbor{item.id, item.pos, distance});
+        if (out.size() > k) {
+            out.pop_back();
+        }
+    }
+
+} // namespace spatial
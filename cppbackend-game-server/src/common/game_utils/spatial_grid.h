@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "geometry.h"
+
+namespace spatial {
+
+    struct Item {
+        std::uint32_t id{0};
+        app_geom::Position2D pos;
+    };
+
+    struct Neighbor {
+        std::uint32_t id{0};
+        app_geom::Position2D pos;
+        double distance{0.0};     // straight-line distance to the query point
+    };
+
+    // Uniform grid over a set of points, rebuilt from scratch when the set changes (e.g. once per tick).
+    // Items are stored bucketed by cell in one contiguous array (counting sort),
+    // so a query touches only the cells around the query point instead of every item.
+    // Storage is reused between builds - no allocation once the grid has grown to its working size.
+    class SpatialGrid {
+    public:
+        // Target average number of items per cell
+        static constexpr double ITEMS_PER_CELL = 2.0;
+        static constexpr double MIN_CELL_SIZE = 1.0;
+
+        // Collect items, then call Build()
+        void Clear() noexcept {
+            pending_.clear();
+            items_.clear();
+            cell_start_.clear();
+            by_id_.clear();
+        }
+
+        void Add(std::uint32_t id, app_geom::Position2D pos) {
+            pending_.push_back({id, pos});
+        }
+
+        // Buckets the collected items into cells; ids are expected to be unique
+        void Build();
+
+        [[nodiscard]] size_t Size() const noexcept { return items_.size(); }
+        [[nodiscard]] bool Empty() const noexcept { return items_.empty(); }
+
+        // Item with the given id, nullptr if absent
+        [[nodiscard]] const Item* Find(std::uint32_t id) const noexcept;
+
+        // Up to k items closest to pos (straight-line), accepted by filter(const Item&), sorted by distance.
+        // Result goes to out (cleared first) so callers can keep the buffer between queries.
+        template <typename Filter>
+        void KNearest(app_geom::Position2D pos, size_t k, Filter&& filter, std::vector<Neighbor>& out) const;
+
+        void KNearest(app_geom::Position2D pos, size_t k, std::vector<Neighbor>& out) const {
+            KNearest(pos, k, [](const Item&) { return true; }, out);
+        }
+
+        template <typename Filter>
+        [[nodiscard]] std::optional<Neighbor> Nearest(app_geom::Position2D pos, Filter&& filter) const {
+            std::vector<Neighbor> out;
+            KNearest(pos, 1, std::forward<Filter>(filter), out);
+            if (out.empty()) {
+                return std::nullopt;
+            }
+            return out.front();
+        }
+
+        [[nodiscard]] std::optional<Neighbor> Nearest(app_geom::Position2D pos) const {
+            return Nearest(pos, [](const Item&) { return true; });
+        }
+
+        // Calls fn(const Item&) for every item inside the box [lo, hi] (bounds included), in no particular order
+        template <typename Fn>
+        void ForEachInBox(app_geom::Position2D lo, app_geom::Position2D hi, Fn&& fn) const;
+
+        // Calls fn(const Item&) for every item not farther than radius from pos, in no particular order
+        template <typename Fn>
+        void ForEachInRadius(app_geom::Position2D pos, double radius, Fn&& fn) const {
+            const double sq_radius = radius * radius;
+            ForEachInBox({pos.x - radius, pos.y - radius}, {pos.x + radius, pos.y + radius}, [&](const Item& item) {
+                const double dx = item.pos.x - pos.x;
+                const double dy = item.pos.y - pos.y;
+                if (dx * dx + dy * dy <= sq_radius) {
+                    fn(item);
+                }
+            });
+        }
+
+    private:
+        double min_x_ = 0.0;
+        double min_y_ = 0.0;
+        double cell_size_ = MIN_CELL_SIZE;
+        size_t cols_ = 0;
+        size_t rows_ = 0;
+
+        std::vector<Item> pending_;             // items added since Clear()
+        std::vector<Item> items_;               // items ordered by cell
+        std::vector<std::uint32_t> cell_start_; // items of cell c are [cell_start_[c], cell_start_[c + 1])
+        std::vector<std::uint32_t> by_id_;      // indices into items_ ordered by item id
+
+        [[nodiscard]] size_t Column(double x) const noexcept;
+        [[nodiscard]] size_t Row(double y) const noexcept;
+
+        static void Offer(const Item& item, double distance, size_t k, std::vector<Neighbor>& out);
+    };
+
+    template <typename Filter>
+    void SpatialGrid::KNearest(app_geom::Position2D pos, size_t k, Filter&& filter, std::vector<Neighbor>& out) const {
+        out.clear();
+        if (items_.empty() || k == 0) {
+            return;
+        }
+
+        const size_t col = Column(pos.x);
+        const size_t row = Row(pos.y);
+        // Rings beyond this one lie completely outside the grid
+        const size_t max_ring = std::max(std::max(col, cols_ - 1 - col), std::max(row, rows_ - 1 - row));
+
+        auto visit_cell = [&](size_t c, size_t r) {
+            const size_t cell = r * cols_ + c;
+            for (std::uint32_t i = cell_start_[cell]; i < cell_start_[cell + 1]; ++i) {
+                const Item& item = items_[i];
+                if (filter(item)) {
+                    Offer(item, std::hypot(item.pos.x - pos.x, item.pos.y - pos.y), k, out);
+                }
+            }
+        };
+
+        for (size_t ring = 0; ring <= max_ring; ++ring) {
+            // Every item in ring r is at least (r - 1) cells away from the query point
+            if (out.size() == k && ring > 0 && static_cast<double>(ring - 1) * cell_size_ >= out.back().distance) {
+                break;
+            }
+            const auto left = static_cast<std::ptrdiff_t>(col) - static_cast<std::ptrdiff_t>(ring);
+            const auto right = static_cast<std::ptrdiff_t>(col) + static_cast<std::ptrdiff_t>(ring);
+            const auto top = static_cast<std::ptrdiff_t>(row) - static_cast<std::ptrdiff_t>(ring);
+            const auto bottom = static_cast<std::ptrdiff_t>(row) + static_cast<std::ptrdiff_t>(ring);
+            const auto cols = static_cast<std::ptrdiff_t>(cols_);
+            const auto rows = static_cast<std::ptrdiff_t>(rows_);
+
+            for (std::ptrdiff_t r = std::max<std::ptrdiff_t>(top, 0); r <= std::min(bottom, rows - 1); ++r) {
+                if (r == top || r == bottom) {
+                    // Full row of the ring
+                    for (std::ptrdiff_t c = std::max<std::ptrdiff_t>(left, 0); c <= std::min(right, cols - 1); ++c) {
+                        visit_cell(static_cast<size_t>(c), static_cast<size_t>(r));
+                    }
+                } else {
+                    // Only the two side cells
+                    if (left >= 0) {
+                        visit_cell(static_cast<size_t>(left), static_cast<size_t>(r));
+                    }
+                    if (right < cols && right != left) {
+                        visit_cell(static_cast<size_t>(right), static_cast<size_t>(r));
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename Fn>
+    void SpatialGrid::ForEachInBox(app_geom::Position2D lo, app_geom::Position2D hi, Fn&& fn) const {
+        if (items_.empty() || lo.x > hi.x || lo.y > hi.y) {
+            return;
+        }
+        // Column()/Row() clamp to the grid, so a box partly outside still visits the border cells
+        const size_t col_end = Column(hi.x);
+        const size_t row_end = Row(hi.y);
+        for (size_t r = Row(lo.y); r <= row_end; ++r) {
+            for (size_t c = Column(lo.x); c <= col_end; ++c) {
+                const size_t cell = r * cols_ + c;
+                for (std::uint32_t i = cell_start_[cell]; i < cell_start_[cell + 1]; ++i) {
+                    const Item& item = items_[i];
+                    if (item.pos.x >= lo.x && item.pos.x <= hi.x && item.pos.y >= lo.y && item.pos.y <= hi.y) {
+                        fn(item);
+                    }
+                }
+            }
+        }
+    }
+
+} // namespace spatial
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace timing {
+
+    // Hierarchical timing wheel over integer time (e.g. milliseconds of a game clock).
+    // Level L has 64 slots of 64^L time units each; an entry is placed by the highest 6-bit group in which
+    // its deadline differs from the current time, and moves one level down each time the wheel reaches its slot
+    // (cascade). Schedule is O(1); Advance costs O(fired + cascaded) plus at most 64 slot steps per level,
+    // however far time jumps - empty levels are skipped at their own granularity.
+    // No cancellation: the owner keeps the current deadline of each value and ignores stale entries.
+    template <typename T>
+    class TimingWheel {
+    public:
+        using Time = std::uint64_t;
+
+        explicit TimingWheel(Time now = 0) noexcept
+            : now_(now)
+        {}
+
+        [[nodiscard]] Time Now() const noexcept {
+            return now_;
+        }
+
+        [[nodiscard]] size_t Size() const noexcept {
+            size_t size = due_.size();
+            for (const auto count : level_sizes_) {
+                size += count;
+            }
+            return size;
+        }
+
+        // A deadline not after Now() fires on the next Advance
+        void Schedule(Time deadline, T value) {
+            if (deadline <= now_) {
+                due_.push_back({deadline, std::move(value)});
+            } else {
+                Place({deadline, std::move(value)});
+            }
+        }
+
+        // Moves the wheel to `now` (never backwards) and appends the values with deadline <= now to `expired`,
+        // ordered by deadline
+        void Advance(Time now, std::vector<T>& expired) {
+            for (auto& entry : due_) {
+                expired.push_back(std::move(entry.value));
+            }
+            due_.clear();
+
+            while (now_ < now) {
+                const int level = LowestOccupiedLevel();
+                if (level < 0) {
+                    now_ = now;
+                    break;
+                }
+                // Nothing can fire before the next slot boundary of the lowest occupied level
+                const Time step = Time{1} << (BITS * level);
+                const Time next = (now_ & ~(step - 1)) + step;
+                if (next > now || next < now_ /*overflow*/) {
+                    now_ = now;
+                    break;
+                }
+                now_ = next;
+
+                // Higher levels first: their entries may land in lower slots reached at this very time
+                for (int l = LEVELS - 1; l > 0; --l) {
+                    if ((now_ & ((Time{1} << (BITS * l)) - 1)) == 0) {
+                        Cascade(l);
+                    }
+                }
+                auto& slot = levels_[0][now_ & MASK];
+                level_sizes_[0] -= slot.size();
+                for (auto& entry : slot) {
+                    expired.push_back(std::move(entry.value));
+                }
+                slot.clear();
+            }
+        }
+
+    private:
+        struct Entry {
+            Time deadline;
+            T value;
+        };
+
+        static constexpr int BITS = 6;
+        static constexpr size_t SLOTS = size_t{1} << BITS;
+        static constexpr Time MASK = SLOTS - 1;
+        static constexpr int LEVELS = (64 + BITS - 1) / BITS;
+
+        Time now_ = 0;
+        std::array<std::array<std::vector<Entry>, SLOTS>, LEVELS> levels_{};
+        std::array<size_t, LEVELS> level_sizes_{};
+        std::vector<Entry> due_;
+
+        [[nodiscard]] int LowestOccupiedLevel() const noexcept {
+            for (int l = 0; l < LEVELS; ++l) {
+                if (level_sizes_[l] != 0) {
+                    return l;
+                }
+            }
+            return -1;
+        }
+
+        // deadline > now_
+        void Place(Entry entry) {
+            int level = LEVELS - 1;
+            while (level > 0 && (entry.deadline >> (BITS * level)) == (now_ >> (BITS * level))) {
+                --level;
+            }
+            const auto slot = (entry.deadline >> (BITS * level)) & MASK;
+            levels_[level][slot].push_back(std::move(entry));
+            ++level_sizes_[level];
+        }
+
+        void Cascade(int level) {
+            auto& slot = levels_[level][(now_ >> (BITS * level)) & MASK];
+            if (slot.empty()) {
+                return;
+            }
+            level_sizes_[level] -= slot.size();
+            auto entries = std::move(slot);
+            slot.clear();
+            for (auto& entry : entries) {
+                if (entry.deadline <= now_) {
+                    // Only possible for deadline == now_; fires with level 0 of this step
+                    levels_[0][now_ & MASK].push_back(std::move(entry));
+                    ++level_sizes_[0];
+                } else {
+                    Place(std::move(entry));
+                }
+            }
+        }
+    };
+
+} // namespace timing
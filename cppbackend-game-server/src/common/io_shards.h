@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace io_shards {
+
+namespace net = boost::asio;
+
+// Pins the calling thread to the given CPU core (modulo number of cores).
+// Returns false when pinning is not supported on this platform or fails.
+inline bool PinCurrentThreadToCore(unsigned core) {
+#if defined(__linux__)
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core % cores, &cpu_set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+// Group of independent io_context instances ("shards").
+// Each shard is driven by its own thread(s), so connections accepted on a shard
+// never migrate to another core: no cross-thread handoff on the accept/read/write path.
+// Shard 0 is the primary context (API strand, ticker, signals live there).
+class IoContextShards {
+public:
+    // count - number of shards; threads_per_shard - concurrency hint & threads to run each shard
+    explicit IoContextShards(unsigned count, unsigned threads_per_shard = 1)
+        : threads_per_shard_(std::max(1u, threads_per_shard)) {
+        count = std::max(1u, count);
+        contexts_.reserve(count);
+        for (unsigned i = 0; i < count; ++i) {
+            contexts_.push_back(std::make_unique<net::io_context>(static_cast<int>(threads_per_shard_)));
+        }
+    }
+
+    IoContextShards(const IoContextShards&) = delete;
+    IoContextShards& operator=(const IoContextShards&) = delete;
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return contexts_.size();
+    }
+
+    [[nodiscard]] bool IsSharded() const noexcept {
+        return contexts_.size() > 1;
+    }
+
+    net::io_context& Primary() noexcept {
+        return *contexts_.front();
+    }
+
+    net::io_context& Get(size_t index) noexcept {
+        return *contexts_[index % contexts_.size()];
+    }
+
+    // Runs all shards and blocks until every shard is stopped.
+    // The calling thread becomes the first worker of shard 0.
+    // When pin_threads is set (and there are several shards), workers of shard i are pinned to core i.
+    void Run(bool pin_threads) {
+        pin_threads = pin_threads && IsSharded();
+        std::vector<std::jthread> workers;
+        workers.reserve(contexts_.size() * threads_per_shard_ - 1);
+
+        for (size_t shard = 0; shard < contexts_.size(); ++shard) {
+            for (unsigned t = 0; t < threads_per_shard_; ++t) {
+                if (shard == 0 && t == 0) {
+                    continue;   // current thread
+                }
+                workers.emplace_back([this, shard, pin_threads] {
+                    if (pin_threads) {
+                        PinCurrentThreadToCore(static_cast<unsigned>(shard));
+                    }
+                    contexts_[shard]->run();
+                });
+            }
+        }
+
+        if (pin_threads) {
+            PinCurrentThreadToCore(0);
+        }
+        contexts_.front()->run();
+    }
+
+    void Stop() {
+        for (auto& ctx : contexts_) {
+            ctx->stop();
+        }
+    }
+
+private:
+    unsigned threads_per_shard_;
+    std::vector<std::unique_ptr<net::io_context>> contexts_;
+};
+
+} // namespace io_shards
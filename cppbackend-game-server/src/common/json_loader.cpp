@@ -296,6 +296,34 @@ void LoadDogRetirementTime(const json::object& root, extra_data::GameExtraData*
         }
 }
 
+void LoadSessionLimits(const json::object& root, extra_data::GameExtraData* extra_data)
+{
+    if (auto max_players = root.if_contains(json_fields::MAX_PLAYERS_PER_SESSION);
+        max_players && max_players->is_number()) {
+        const int value = max_players->to_number<int>();
+        if (value <= 0) {
+            throw std::runtime_error("Invalid JSON: 'maxPlayersPerSession' must be positive");
+        }
+        extra_data->SetMaxPlayersPerSession(static_cast<size_t>(value));
+    }
+    if (auto radius = root.if_contains(json_fields::INTEREST_RADIUS);
+        radius && radius->is_number()) {
+        const double value = radius->to_number<double>();
+        if (value < 0.0) {
+            throw std::runtime_error("Invalid JSON: 'interestRadius' must not be negative");
+        }
+        extra_data->SetInterestRadius(value);
+    }
+    if (auto idle_time = root.if_contains(json_fields::SESSION_IDLE_TIME);
+        idle_time && idle_time->is_number()) {
+        const int value = idle_time->to_number<int>();
+        if (value < 0) {
+            throw std::runtime_error("Invalid JSON: 'sessionIdleTime' must not be negative");
+        }
+        extra_data->SetSessionIdleTime(std::chrono::seconds{value});
+    }
+}
+
 } // namespace
 
 // Main function to load the entire game from JSON file
@@ -316,6 +344,8 @@ model::Game LoadGame(const std::filesystem::path &json_path)
     double default_dog_speed = LoadDefaultSpeed(root);
     int default_bag_capacity = LoadDefaultCapacity(root);
     LoadDogRetirementTime(root, extra_data.get());
+    // Размер сессии, радиус видимости и время до спячки пустой сессии (maxPlayersPerSession, interestRadius, sessionIdleTime)
+    LoadSessionLimits(root, extra_data.get());
 
     // 5. Проверяем наличие массива карт
     auto maps_it = root.if_contains(json_fields::MAPS);
@@ -0,0 +1,159 @@
+#include "metrics.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace metrics {
+
+namespace {
+
+// Exported histogram bounds: 2^k - 1 microseconds (15us .. ~33.5s).
+// A power of two starts a new bucket, so 2^k - 1 is the last value of a bucket and le="..." holds exactly (<=)
+constexpr unsigned EXPORT_MIN_EXPONENT = 4;
+constexpr unsigned EXPORT_MAX_EXPONENT = 25;
+
+std::string FormatSeconds(std::uint64_t us) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.6f", static_cast<double>(us) / 1e6);
+    return buf;
+}
+
+// name{labels} / name{labels,extra}
+std::string SeriesName(std::string_view name, std::string_view labels, std::string_view extra = {}) {
+    std::string result(name);
+    if (labels.empty() && extra.empty()) {
+        return result;
+    }
+    result += '{';
+    result += labels;
+    if (!labels.empty() && !extra.empty()) {
+        result += ',';
+    }
+    result += extra;
+    result += '}';
+    return result;
+}
+
+} // namespace
+
+size_t ThreadStripe() noexcept {
+    static std::atomic<size_t> next_stripe{0};
+    thread_local const size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % COUNTER_STRIPES;
+    return stripe;
+}
+
+std::uint64_t Histogram::CountAtMost(std::uint64_t limit_us) const noexcept {
+    std::uint64_t count = 0;
+    for (size_t i = 0; i < BUCKET_COUNT && BucketUpperBound(i) <= limit_us; ++i) {
+        count += buckets_[i].load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+std::uint64_t Histogram::ValueAtQuantile(double q) const noexcept {
+    std::uint64_t total = Count();
+    if (total == 0) {
+        return 0;
+    }
+    // q = 1 is the last observation, not one past it
+    auto rank = std::min(total - 1, static_cast<std::uint64_t>(q * static_cast<double>(total)));
+    std::uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen > rank) {
+            return BucketUpperBound(i);
+        }
+    }
+    return BucketUpperBound(BUCKET_COUNT - 1);
+}
+
+Registry& Registry::Instance() {
+    static Registry registry;
+    return registry;
+}
+
+Registry::Family& Registry::GetFamily(std::string_view name, std::string_view help, Type type) {
+    auto it = families_.find(name);
+    if (it == families_.end()) {
+        it = families_.emplace(std::string(name), Family{type, std::string(help), {}, {}, {}}).first;
+    } else if (it->second.type != type) {
+        throw std::logic_error("metrics::Registry: metric '" + std::string(name) + "' registered with another type");
+    }
+    return it->second;
+}
+
+Counter& Registry::GetCounter(std::string_view name, std::string_view help, std::string_view labels) {
+    std::lock_guard lock{mutex_};
+    auto& family = GetFamily(name, help, Type::COUNTER);
+    if (auto it = family.counters.find(labels); it != family.counters.end()) {
+        return *it->second;
+    }
+    auto& counter = counters_.emplace_back(std::make_unique<Counter>());
+    family.counters.emplace(std::string(labels), counter.get());
+    return *counter;
+}
+
+Gauge& Registry::GetGauge(std::string_view name, std::string_view help, std::string_view labels) {
+    std::lock_guard lock{mutex_};
+    auto& family = GetFamily(name, help, Type::GAUGE);
+    if (auto it = family.gauges.find(labels); it != family.gauges.end()) {
+        return *it->second;
+    }
+    auto& gauge = gauges_.emplace_back(std::make_unique<Gauge>());
+    family.gauges.emplace(std::string(labels), gauge.get());
+    return *gauge;
+}
+
+Histogram& Registry::GetHistogram(std::string_view name, std::string_view help, std::string_view labels) {
+    std::lock_guard lock{mutex_};
+    auto& family = GetFamily(name, help, Type::HISTOGRAM);
+    if (auto it = family.histograms.find(labels); it != family.histograms.end()) {
+        return *it->second;
+    }
+    auto& histogram = histograms_.emplace_back(std::make_unique<Histogram>());
+    family.histograms.emplace(std::string(labels), histogram.get());
+    return *histogram;
+}
+
+std::string Registry::Render() const {
+    std::lock_guard lock{mutex_};
+    std::string out;
+    out.reserve(16 * 1024);
+
+    for (const auto& [name, family] : families_) {
+        out += "# HELP " + name + " " + family.help + "\n";
+        switch (family.type) {
+            case Type::COUNTER:
+                out += "# TYPE " + name + " counter\n";
+                for (const auto& [labels, counter] : family.counters) {
+                    out += SeriesName(name, labels) + " " + std::to_string(counter->Value()) + "\n";
+                }
+                break;
+            case Type::GAUGE:
+                out += "# TYPE " + name + " gauge\n";
+                for (const auto& [labels, gauge] : family.gauges) {
+                    out += SeriesName(name, labels) + " " + std::to_string(gauge->Value()) + "\n";
+                }
+                break;
+            case Type::HISTOGRAM:
+                out += "# TYPE " + name + " histogram\n";
+                for (const auto& [labels, histogram] : family.histograms) {
+                    // Count first: buckets may grow while rendering, +Inf must not be below them
+                    std::uint64_t count = histogram->Count();
+                    for (unsigned exp = EXPORT_MIN_EXPONENT; exp <= EXPORT_MAX_EXPONENT; ++exp) {
+                        std::uint64_t bound_us = (std::uint64_t{1} << exp) - 1;
+                        std::uint64_t at_most = std::min(count, histogram->CountAtMost(bound_us));
+                        out += SeriesName(name + "_bucket", labels, "le=\"" + FormatSeconds(bound_us) + "\"")
+                             + " " + std::to_string(at_most) + "\n";
+                    }
+                    out += SeriesName(name + "_bucket", labels, "le=\"+Inf\"") + " " + std::to_string(count) + "\n";
+                    out += SeriesName(name + "_sum", labels) + " " + FormatSeconds(histogram->SumMicroseconds()) + "\n";
+                    out += SeriesName(name + "_count", labels) + " " + std::to_string(count) + "\n";
+                }
+                break;
+        }
+    }
+    return out;
+}
+
+} // namespace metrics
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace metrics {
+
+using namespace std::literals;
+
+// Number of per-thread stripes of a counter (threads share stripes round-robin)
+constexpr static inline size_t COUNTER_STRIPES = 16;
+// Cache line size used to keep stripes apart
+constexpr static inline size_t CACHE_LINE = 64;
+
+// Stripe of the calling thread (assigned once per thread)
+size_t ThreadStripe() noexcept;
+
+// Monotonic counter. Increments touch only the calling thread's stripe,
+// so hot paths on different threads never contend for one cache line.
+class Counter {
+public:
+    void Inc(std::uint64_t value = 1) noexcept {
+        stripes_[ThreadStripe()].value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t Value() const noexcept {
+        std::uint64_t sum = 0;
+        for (const auto& stripe : stripes_) {
+            sum += stripe.value.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+private:
+    struct alignas(CACHE_LINE) Stripe {
+        std::atomic<std::uint64_t> value{0};
+    };
+    std::array<Stripe, COUNTER_STRIPES> stripes_;
+};
+
+// Value that goes up and down (queue depth, connections in use)
+class Gauge {
+public:
+    void Set(std::int64_t value) noexcept {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    void Add(std::int64_t delta = 1) noexcept {
+        value_.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    void Sub(std::int64_t delta = 1) noexcept {
+        value_.fetch_sub(delta, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::int64_t Value() const noexcept {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::int64_t> value_{0};
+};
+
+// HDR-style latency histogram over microseconds.
+// Log-linear buckets: each power of two is split into SUB_BUCKETS linear buckets,
+// so relative error is below 1/SUB_BUCKETS for any value. Recording is one relaxed
+// fetch_add on the bucket plus sum/count - no locks, no allocation.
+class Histogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 3;
+    static constexpr std::uint64_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_EXPONENT = 40;        // values up to ~2^40 us (~12 days) are bucketed exactly
+    static constexpr size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    void Observe(std::chrono::microseconds value) noexcept {
+        auto us = static_cast<std::uint64_t>(std::max<std::int64_t>(0, value.count()));
+        buckets_[BucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+        sum_us_.fetch_add(us, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <typename Rep, typename Period>
+    void Observe(std::chrono::duration<Rep, Period> value) noexcept {
+        Observe(std::chrono::duration_cast<std::chrono::microseconds>(value));
+    }
+
+    [[nodiscard]] std::uint64_t Count() const noexcept {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t SumMicroseconds() const noexcept {
+        return sum_us_.load(std::memory_order_relaxed);
+    }
+
+    // Number of observations in buckets lying entirely at or below limit_us.
+    // Exact (every observation <= limit_us) when limit_us is a bucket upper bound, e.g. 2^k - 1
+    [[nodiscard]] std::uint64_t CountAtMost(std::uint64_t limit_us) const noexcept;
+
+    // Approximate value (upper bound of the bucket) at quantile q in [0, 1]
+    [[nodiscard]] std::uint64_t ValueAtQuantile(double q) const noexcept;
+
+    static constexpr size_t BucketIndex(std::uint64_t us) noexcept {
+        if (us < SUB_BUCKETS) {
+            return static_cast<size_t>(us);
+        }
+        unsigned exponent = static_cast<unsigned>(std::bit_width(us)) - 1;       // us in [2^exponent, 2^(exponent+1))
+        if (exponent > MAX_EXPONENT) {
+            return BUCKET_COUNT - 1;
+        }
+        unsigned shift = exponent - SUB_BUCKET_BITS;
+        std::uint64_t sub = (us >> shift) - SUB_BUCKETS;                         // [0, SUB_BUCKETS)
+        return static_cast<size_t>((shift + 1) * SUB_BUCKETS + sub);
+    }
+
+    // Largest value falling into the bucket
+    static constexpr std::uint64_t BucketUpperBound(size_t index) noexcept {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        std::uint64_t shift = index / SUB_BUCKETS - 1;
+        std::uint64_t sub = index % SUB_BUCKETS;
+        return ((SUB_BUCKETS + sub + 1) << shift) - 1;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<std::uint64_t> sum_us_{0};
+    std::atomic<std::uint64_t> count_{0};
+};
+
+// Observes the lifetime of the scope into a histogram
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& histogram) noexcept
+        : histogram_(histogram)
+        , start_(std::chrono::steady_clock::now()) {
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() {
+        histogram_.Observe(std::chrono::steady_clock::now() - start_);
+    }
+
+private:
+    Histogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Process-wide set of named metrics, rendered in Prometheus text exposition format.
+// Registration (Get*) takes a lock and should be done once - callers keep the returned
+// reference (e.g. in a function-local static); metric objects live as long as the process.
+// labels - ready Prometheus label set without braces, e.g. R"(endpoint="/api/v1/maps")"
+class Registry {
+public:
+    static Registry& Instance();
+
+    Counter& GetCounter(std::string_view name, std::string_view help, std::string_view labels = {});
+    Gauge& GetGauge(std::string_view name, std::string_view help, std::string_view labels = {});
+    // Histogram of durations, exported in seconds
+    Histogram& GetHistogram(std::string_view name, std::string_view help, std::string_view labels = {});
+
+    // Prometheus text format (version 0.0.4)
+    [[nodiscard]] std::string Render() const;
+
+private:
+    Registry() = default;
+
+    enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Family {
+        Type type;
+        std::string help;
+        // labels -> metric (std::map keeps output order stable)
+        std::map<std::string, Counter*, std::less<>> counters;
+        std::map<std::string, Gauge*, std::less<>> gauges;
+        std::map<std::string, Histogram*, std::less<>> histograms;
+    };
+
+    Family& GetFamily(std::string_view name, std::string_view help, Type type);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family, std::less<>> families_;
+    std::deque<std::unique_ptr<Counter>> counters_;
+    std::deque<std::unique_ptr<Gauge>> gauges_;
+    std::deque<std::unique_ptr<Histogram>> histograms_;
+};
+
+} // namespace metrics
@@ -1,17 +1,32 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
 #include <functional>
 #include <memory>
 
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
 
+#include "boost_logger.h"
+#include "metrics.h"
+
 namespace tick {
 
 namespace net = boost::asio;
 namespace sys = boost::system;
 
+struct TickerOptions {
+    std::chrono::milliseconds period;
+    bool fixed_step = false;        // handler always gets `period`, missed ticks are caught up by sub-steps
+    unsigned max_catch_up = 5;      // max handler calls per wakeup in fixed-step mode, older ticks are dropped
+};
+
 class Ticker : public std::enable_shared_from_this<Ticker> {
 public:
     using Strand = net::strand<net::io_context::executor_type>;
@@ -19,22 +34,56 @@ public:
 
     // Функция handler будет вызываться внутри strand с интервалом period
     Ticker(Strand strand, std::chrono::milliseconds period, Handler handler)
+        : Ticker(strand, TickerOptions{period}, std::move(handler)) {
+    }
+
+    Ticker(Strand strand, TickerOptions options, Handler handler)
         : strand_{strand}
-        , period_{period}
+        , period_{options.period}
+        , fixed_step_{options.fixed_step}
+        , max_catch_up_{std::max(options.max_catch_up, 1u)}
         , handler_{std::move(handler)} {
     }
 
+    // Safe to call multiple times - only the first call starts the loop
     void Start() {
-        last_tick_ = Clock::now();
+        if (started_.exchange(true)) {
+            return;
+        }
         net::dispatch(strand_, [self = shared_from_this()] {
+            self->last_tick_ = Clock::now();
+            self->next_deadline_ = self->last_tick_ + self->period_;
             self->ScheduleTick();
         });
     }
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    struct TickMetrics {
+        metrics::Histogram& lag;
+        metrics::Counter& overruns;
+        metrics::Counter& catch_up_steps;
+        metrics::Counter& dropped_steps;
+        metrics::Counter& errors;
+    };
+
+    static TickMetrics& GetTickMetrics() {
+        auto& registry = metrics::Registry::Instance();
+        static TickMetrics tick_metrics{
+            registry.GetHistogram("game_tick_lag_seconds", "Delay of a tick wakeup past its deadline"),
+            registry.GetCounter("game_tick_overruns_total", "Ticks that finished after the next tick deadline"),
+            registry.GetCounter("game_tick_catch_up_steps_total", "Extra fixed-step ticks run to catch up"),
+            registry.GetCounter("game_tick_dropped_steps_total", "Fixed-step ticks skipped over the catch-up limit"),
+            registry.GetCounter("game_tick_errors_total", "Tick handler calls that threw an exception"),
+        };
+        return tick_metrics;
+    }
+
+    // Deadlines are absolute, so time spent in the handler does not shift the next ticks
     void ScheduleTick() {
         assert(strand_.running_in_this_thread());
-        timer_.expires_after(period_);
+        timer_.expires_at(next_deadline_);
         timer_.async_wait([self = shared_from_this()](sys::error_code ec) {
             self->OnTick(ec);
         });
@@ -45,26 +94,64 @@ private:
         if (!strand_.running_in_this_thread()) {
             throw std::runtime_error("Ticker::OnTick: Strand mismatch detected.");
         }
+        if (ec) {
+            return;
+        }
+
+        auto& tick_metrics = GetTickMetrics();
+        const auto now = Clock::now();
+        const auto lag = std::max(now - next_deadline_, Clock::duration::zero());
+        tick_metrics.lag.Observe(lag);
 
-        if (!ec) {
-            auto this_tick = Clock::now();
-            auto delta = duration_cast<milliseconds>(this_tick - last_tick_);
-            last_tick_ = this_tick;
-            try {
-                handler_(delta);
-            } catch (...) {
+        if (fixed_step_) {
+            // One step for the deadline itself plus one for every whole period we are late
+            const auto due = static_cast<std::uint64_t>(1 + lag / period_);
+            const auto steps = std::min<std::uint64_t>(due, max_catch_up_);
+            for (std::uint64_t step = 0; step < steps; ++step) {
+                RunHandler(period_);
             }
-            ScheduleTick();
+            tick_metrics.catch_up_steps.Inc(steps - 1);
+            tick_metrics.dropped_steps.Inc(due - steps);
+            next_deadline_ += period_ * due;
+        } else {
+            RunHandler(duration_cast<milliseconds>(now - last_tick_));
+            next_deadline_ += period_;
         }
+        last_tick_ = now;
+
+        // Work ran past the next deadline. Fixed-step mode catches up on the next wakeup,
+        // variable mode restarts from now - the next delta already covers the lost time.
+        const auto finished = Clock::now();
+        if (finished >= next_deadline_) {
+            tick_metrics.overruns.Inc();
+            if (!fixed_step_) {
+                next_deadline_ = finished + period_;
+            }
+        }
+        ScheduleTick();
     }
 
-    using Clock = std::chrono::steady_clock;
+    void RunHandler(std::chrono::milliseconds delta) {
+        try {
+            handler_(delta);
+        } catch (const std::exception& e) {
+            GetTickMetrics().errors.Inc();
+            boost_logger::LogError(EXIT_FAILURE, e.what(), "Ticker::OnTick");
+        } catch (...) {
+            GetTickMetrics().errors.Inc();
+            boost_logger::LogError(EXIT_FAILURE, "unknown exception", "Ticker::OnTick");
+        }
+    }
 
     Strand strand_;
     std::chrono::milliseconds period_;
+    bool fixed_step_;
+    unsigned max_catch_up_;
     net::steady_timer timer_{strand_};
     Handler handler_;
-    std::chrono::steady_clock::time_point last_tick_;
+    std::atomic_bool started_{false};
+    Clock::time_point last_tick_;
+    Clock::time_point next_deadline_;
 };
 
-} // namespace ticker
+} // namespace tick
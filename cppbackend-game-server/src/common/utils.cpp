@@ -210,7 +210,12 @@ std::optional<app::Token> ExtractToken(const http_handler::StringRequest &req) {
         return std::nullopt;
     }
 
-    return app::Token{std::string(auth_value.substr(http_handler::api_paths::BEARER.size()))};
+    // Malformed token is the same as no token (401 invalidToken)
+    auto token = auth_value.substr(http_handler::api_paths::BEARER.size());
+    if (!app::IsTokenValid({token.data(), token.size()})) {
+        return std::nullopt;
+    }
+    return app::Token{std::string(token)};
 }
 
 std::string MethodsToString(const std::vector<boost::beast::http::verb> &methods) {
@@ -233,6 +238,16 @@ std::string MethodsToString(const std::vector<boost::beast::http::verb> &methods
     return result;
 }
 
+std::string MethodsToString(std::uint64_t methods_mask) {
+    std::vector<boost::beast::http::verb> methods;
+    for (unsigned bit = 0; bit < 64; ++bit) {
+        if (methods_mask & (std::uint64_t{1} << bit)) {
+            methods.push_back(static_cast<boost::beast::http::verb>(bit));
+        }
+    }
+    return MethodsToString(methods);
+}
+
 } // namespace http
 
 } // namespace utils
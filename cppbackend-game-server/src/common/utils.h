@@ -50,6 +50,9 @@ namespace utils {
     // Helper function to convert vector of HTTP methods to comma-separated string
     std::string MethodsToString(const std::vector<boost::beast::http::verb>& methods);
 
+    // Same for a bitmask of methods (bit N - verb with value N), methods in verb order
+    std::string MethodsToString(std::uint64_t methods_mask);
+
 } // namespace http
 
 } // namespace utils
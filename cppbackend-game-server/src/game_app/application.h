@@ -1,12 +1,16 @@
 #pragma once
 
+#include <random>
+
 #include <boost/signals2.hpp>
 
 #include "../common/cmd_parser.h"
+#include "../common/metrics.h"
 #include "game_clock.h"
 #include "game_state_persistence.h"
 #include "auto_save_manager.h"
 #include "player_score_recorder.h"
+#include "replay_log.h"
 
 namespace app {
 
@@ -27,8 +31,23 @@ public:
                            cmd_args_.state_file)
         , score_recorder_(db)
     {
+        // Zero seeds are replaced by random ones here, so a replay log gets the values actually used
+        const auto bot_seed = ResolveSeed(cmd_args_.bot_seed);
+        game_seed_ = ResolveSeed(cmd_args_.game_seed);
+        spawn_rng_.seed(game_seed_);
+        game_.SetLootSeed(game_seed_);
+
         game_.SetCreateBots(cmd_args_.enable_bots);
+        if (cmd_args_.bot_threads > 0) {
+            bot_workers_ = std::make_unique<model::BotWorkers>(cmd_args_.bot_threads);
+        }
+        game_.SetBotOptions({bot_seed, bot_workers_.get(), cmd_args_.bot_plan_budget});
         game_.SetEnableRetirement(!cmd_args_.no_database);
+        if (!cmd_args_.record_replay.empty()) {
+            replay_writer_ = std::make_unique<replay::ReplayWriter>(cmd_args_.record_replay, replay::ReplayHeader{
+                cmd_args_.config_file, game_seed_, bot_seed, cmd_args_.bot_plan_budget,
+                cmd_args_.enable_bots, cmd_args_.randomize_spawn_points, !cmd_args_.no_database});
+        }
         if (!cmd_args_.no_database) {
             SetupPlayerRetirementHandling();
         }
@@ -58,6 +77,16 @@ public:
     }
 
     void Tick(std::chrono::milliseconds time_delta) {
+        static auto& tick_duration = metrics::Registry::Instance().GetHistogram(
+            "game_tick_duration_seconds", "Wall time of one game tick (all sessions, autosave, subscribers)");
+        static auto& ticks_total = metrics::Registry::Instance().GetCounter(
+            "game_ticks_total", "Number of game ticks");
+        metrics::ScopedTimer timer(tick_duration);
+        ticks_total.Inc();
+        if (replay_writer_) {
+            replay_writer_->WriteTick(time_delta);
+        }
+
         clock_.Advance(time_delta);
         game_.UpdateAllGameSessions(time_delta);
         auto_save_manager_.OnTick(time_delta);
@@ -67,11 +96,36 @@ public:
     [[nodiscard]] const Player& AddPlayer(std::string_view name, std::string_view map) {
         auto new_player = &players_.AddPlayer(name, map, clock_.Now(), ioc_);
         if (cmd_args_.randomize_spawn_points) {
-            new_player->GetDog()->SetPosition(new_player->GetGameSession()->GetMap()->GetRandomPoint());
+            new_player->GetDog()->SetPosition(new_player->GetGameSession()->GetMap()->GetRandomPoint(spawn_rng_));
+        }
+        if (replay_writer_) {
+            replay_writer_->WriteJoin(name, map);
         }
         return *new_player;
     }
 
+    // Player's move action (recorded for replay)
+    void SetPlayerDirection(Player& player, app_geom::Direction2D dir) {
+        player.SetDirection(dir);
+        if (replay_writer_) {
+            replay_writer_->WriteAction(player.GetId(), dir);
+        }
+    }
+
+    // Player's move action applied at the start of the next tick. Safe from any thread unless a replay
+    // is recorded: the replay writer must see actions and ticks in the order the API strand runs them.
+    // Same outcome as SetPlayerDirection - nothing moves dogs between ticks.
+    void PostPlayerDirection(Player& player, app_geom::Direction2D dir) {
+        player.PostDirection(dir);
+        if (replay_writer_) {
+            replay_writer_->WriteAction(player.GetId(), dir);
+        }
+    }
+
+    [[nodiscard]] bool IsRecordingReplay() const noexcept {
+        return replay_writer_ != nullptr;
+    }
+
     // Optional: if external save/load needed
     void SaveGameState(const std::string& filename) const {
         GameStatePersistence::Save(game_, players_, filename);
@@ -104,9 +158,21 @@ private:
     db::DatabaseInterface& database_;
 
     GameClock clock_;
+    std::uint64_t game_seed_ = 0;
+    std::mt19937_64 spawn_rng_;                         // random spawn points (--randomize-spawn-points)
+    std::unique_ptr<replay::ReplayWriter> replay_writer_;  // --record-replay
+    std::unique_ptr<model::BotWorkers> bot_workers_;    // parallel bot decisions (--bot-threads)
     AutoSaveManager auto_save_manager_;
     PlayerScoreRecorder score_recorder_;
 
+    static std::uint64_t ResolveSeed(std::uint64_t seed) {
+        std::random_device random_device;
+        while (seed == 0) {
+            seed = (std::uint64_t{random_device()} << 32) | random_device();
+        }
+        return seed;
+    }
+
     // Sets up handling of player retirement events when a database is used.
     // Subscribes to Players::OnPlayerRetired to record the player's final score
     // and play duration into the database. This is only enabled when
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include "game_state_persistence.h"
+#include "../common/metrics.h"
 
 namespace app {
 
@@ -23,7 +24,12 @@ namespace app {
             accumulated_ += delta;
             if (accumulated_ >= period_) {
                 boost_logger::LogInfo("AutoSave after msec: " + std::to_string(accumulated_.count()));
-                GameStatePersistence::Save(game_, players_, filename_);
+                static auto& save_duration = metrics::Registry::Instance().GetHistogram(
+                    "game_autosave_duration_seconds", "Time to serialize and write the game state file");
+                {
+                    metrics::ScopedTimer timer(save_duration);
+                    GameStatePersistence::Save(game_, players_, filename_);
+                }
                 while (accumulated_ - period_ >= std::chrono::milliseconds::zero()) {
                     accumulated_ -= period_;
                 }
@@ -1,4 +1,7 @@
 #include "players.h"
+
+#include <algorithm>
+
 #include "../common/constants.h"
 
 namespace app {
@@ -22,44 +25,52 @@ Player& Players::AddPlayer(std::string_view name, std::string_view map,
 
     // create Player - Dog created automatically in Player Ctor
     auto player_id = next_player_id_++;
-    auto new_player = std::make_unique<Player>(player_id, std::string(name), session_ptr, join_time);
-    auto player_token = token_gen_();
+    auto new_player = std::make_shared<Player>(player_id, std::string(name), session_ptr, join_time);
 
-    // Store Player with token
-    token_to_player_.emplace(player_token, std::move(new_player));
+    // Store Player with token (a new token in the unlikely case of a collision)
+    auto player_key = token_gen_.NewKey();
+    while (!token_to_player_.Insert(player_key, new_player)) {
+        player_key = token_gen_.NewKey();
+    }
 
-    const auto player_it = token_to_player_.find(player_token);
     // update helper containers for quick lookup
-    player_id_to_token_.emplace(player_id, &(player_it->first));
-    player_id_to_player_.emplace(player_id, player_it->second.get());
+    player_id_to_token_.emplace(player_id, FormatToken(player_key));
+    player_id_to_player_.emplace(player_id, new_player.get());
+    AddToIndexes(*new_player);
 
     /// Ensure we are connected to this session's retirement signal.
     ConnectToDogDeletedSignal(session_ptr);
 
-    return *player_it->second;
+    return *new_player;
 }
 
 const Token* Players::FindTokenByPlayer(const Player &player) const {
     auto it = player_id_to_token_.find(player.GetId());
     if (it != player_id_to_token_.end()) {
-        return it->second;
+        return &it->second;
     }
     return nullptr;
 }
 
 const Player* Players::FindPlayerByToken(const Token &token) const {
-    auto it = token_to_player_.find(token);
-    if (it != token_to_player_.end()) {
-        return it->second.get();
+    // Malformed tokens are simply unknown. The table keeps the Player alive until it is retired (on the strand)
+    if (auto key = ParseTokenKey(*token)) {
+        return token_to_player_.Find(*key).get();
     }
     return nullptr;
 }
 
 Player* Players::FindPlayerByToken(const Token &token)
 {
-    auto it = token_to_player_.find(token);
-    if (it != token_to_player_.end()) {
-        return it->second.get();
+    if (auto key = ParseTokenKey(*token)) {
+        return token_to_player_.Find(*key).get();
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Player> Players::FindSharedPlayerByToken(const Token &token) {
+    if (auto key = ParseTokenKey(*token)) {
+        return token_to_player_.Find(*key);
     }
     return nullptr;
 }
@@ -71,31 +82,68 @@ const Player * Players::FindPlayerById(std::uint32_t player_id) const {
     return nullptr;
 }
 
-const std::map<uint32_t, const Player*> Players::GetPlayersAll() const {
-    std::map<std::uint32_t, const Player*> result;
-    for (const auto& [id, token] : player_id_to_token_) {
-        if (auto player = FindPlayerByToken(*token)) {
-            result.emplace(id, player);
-        }
+Player* Players::FindPlayerById(std::uint32_t player_id) {
+    if (auto token_it = player_id_to_token_.find(player_id); token_it != player_id_to_token_.end()) {
+        return FindPlayerByToken(token_it->second);
+    }
+    return nullptr;
+}
+
+std::span<const Player* const> Players::GetPlayersBySession(const model::GameSession::Id &session_id) const {
+    if (auto it = players_by_session_.find(session_id); it != players_by_session_.end()) {
+        return it->second;
+    }
+    return {};
+}
+
+std::span<const Player* const> Players::GetPlayersByMap(const model::Map::Id &map_id) const {
+    if (auto it = players_by_map_.find(map_id); it != players_by_map_.end()) {
+        return it->second;
+    }
+    return {};
+}
+
+namespace {
+
+// Player IDs only grow on join, so insertion is almost always at the end
+void InsertById(std::vector<const Player*>& players, const Player& player) {
+    auto it = std::ranges::lower_bound(players, player.GetId(), {}, &Player::GetId);
+    players.insert(it, &player);
+}
+
+void EraseById(std::vector<const Player*>& players, const Player& player) {
+    auto it = std::ranges::lower_bound(players, player.GetId(), {}, &Player::GetId);
+    if (it != players.end() && *it == &player) {
+        players.erase(it);
     }
-    return result;
 }
 
-const std::map<std::uint32_t, const Player *> Players::GetPlayersBySession(const model::GameSession::Id &session_id) const {
-    std::map<std::uint32_t, const Player*> result;
+} // namespace
 
-    auto session_ptr = game_.FindGameSession(session_id);
-    // players
-    for (const auto &dog_id: session_ptr->GetDogs() | std::views::keys) {
-        auto player = FindPlayerById(dog_id);
-        result.emplace(player->GetId(), player);
+void Players::AddToIndexes(const Player& player) {
+    const auto* session = player.GetGameSession();
+    InsertById(players_by_id_, player);
+    InsertById(players_by_map_[session->GetMap()->GetId()], player);
+    InsertById(players_by_session_[session->GetId()], player);
+}
+
+void Players::RemoveFromIndexes(const Player& player) {
+    const auto* session = player.GetGameSession();
+    EraseById(players_by_id_, player);
+    if (auto it = players_by_map_.find(session->GetMap()->GetId()); it != players_by_map_.end()) {
+        EraseById(it->second, player);
     }
-    // bots
-    for (const auto &dog_id: session_ptr->GetBots() | std::views::keys) {
-        auto player = FindPlayerById(dog_id);
-        result.emplace(player->GetId(), player);
+    if (auto it = players_by_session_.find(session->GetId()); it != players_by_session_.end()) {
+        EraseById(it->second, player);
+        // The last player left - the session goes idle, drop everything keyed by it until someone joins again
+        if (it->second.empty()) {
+            players_by_session_.erase(it);
+            if (auto conn_it = session_connections_.find(session->GetId()); conn_it != session_connections_.end()) {
+                conn_it->second.disconnect();
+                session_connections_.erase(conn_it);
+            }
+        }
     }
-    return result;
 }
 
 void Players::AddRestoredPlayer(uint32_t id, std::string_view name,
@@ -115,10 +163,15 @@ void Players::AddRestoredPlayer(uint32_t id, std::string_view name,
         throw std::runtime_error(error_msg);
     }
 
-    // Check for duplicate token
-    Token tkn(std::string{token});
-    if (token_to_player_.contains(tkn)) {
-        std::string error_msg = "Duplicate token: " + *tkn;
+    // Check token format and for duplicate token
+    auto key = ParseTokenKey(token);
+    if (!key) {
+        std::string error_msg = "Invalid token: " + std::string(token);
+        boost_logger::LogError(EXIT_FAILURE, error_msg, "Players::AddRestoredPlayer");
+        throw std::runtime_error(error_msg);
+    }
+    if (token_to_player_.Find(*key)) {
+        std::string error_msg = "Duplicate token: " + std::string(token);
         boost_logger::LogError(EXIT_FAILURE, error_msg, "Players::AddRestoredPlayer");
         throw std::runtime_error(error_msg);
     }
@@ -127,23 +180,22 @@ void Players::AddRestoredPlayer(uint32_t id, std::string_view name,
     // Player Ctor creates Dog - Dog verification done in GameSession::RequestDog
     // Player restored just after Application created with game_time=0 - Player join_time also=0
     bool restored_player = true;
-    auto player = std::make_unique<Player>(id, std::string(name), session,
+    auto player = std::make_shared<Player>(id, std::string(name), session,
             std::chrono::milliseconds::zero(),restored_player);
-    const Player* player_ptr = player.get();
 
-    // Insert player into token→player map (token is copied as key)
-    auto [it, inserted] = token_to_player_.emplace(tkn, std::move(player));
-    if (!inserted) {
+    // Insert player into token→player table
+    if (!token_to_player_.Insert(*key, player)) {
         // Should not happen - already checked for duplicate token,
         // but safeguard anyway.
         throw std::runtime_error("AddRestoredPlayer: failed to insert token");
     }
 
-    // Store a pointer to the token that now lives in the map's key.
-    player_id_to_token_[id] = &(it->first);
+    // Store the token string for responses and saving.
+    player_id_to_token_.insert_or_assign(id, Token{std::string(token)});
 
     // Store player pointer by ID.
-    player_id_to_player_[id] = it->second.get();
+    player_id_to_player_[id] = player.get();
+    AddToIndexes(*player);
 
     // Without this, a restored player would never trigger the retirement signal.
     ConnectToDogDeletedSignal(session);
@@ -162,31 +214,33 @@ void Players::ConnectToDogDeletedSignal(model::GameSession *session) {
         return;
     }
 
-    // Connect to the session's dog-deleted signal. This signal is emitted when a dog
-    // is retired due to idle timeout (or possibly other reasons in the future).
+    // Connect to the session's dog-deleted signal. This signal is emitted once per tick with
+    // all dogs retired due to idle timeout (or possibly other reasons in the future).
     auto connection = session->GetDogDeletedSignal().connect(
-        [this, session](uint32_t dog_id, loot::Score dog_score) {
-            // Ignore bots (they have IDs above a threshold and are managed separately)
-            if (dog_id >= common_values::DOG_BOT_START_ID)
-                return;
-
-            // Find the player associated with this dog ID
-            auto it = player_id_to_player_.find(dog_id);
-            if (it == player_id_to_player_.end()) {
-                // Should never happen for a real player, but safeguard
-                throw std::runtime_error("Players::ConnectToSessionRetirement: Player not found.");
+        [this, session](std::span<const model::GameSession::RetiredDog> dogs) {
+            for (const auto& [dog_id, dog_score] : dogs) {
+                // Ignore bots (they have IDs above a threshold and are managed separately)
+                if (dog_id >= common_values::DOG_BOT_START_ID)
+                    continue;
+
+                // Find the player associated with this dog ID
+                auto it = player_id_to_player_.find(dog_id);
+                if (it == player_id_to_player_.end()) {
+                    // Should never happen for a real player, but safeguard
+                    throw std::runtime_error("Players::ConnectToSessionRetirement: Player not found.");
+                }
+
+                const Player* player = it->second;
+
+                // Emit the public player-retired signal. This allows external components
+                // (like score recorder) to react before the player is removed.
+                // The player object is still valid at this point.
+                player_retired_signal_(dog_id, dog_score, *player);
+
+                // Finally, remove the player from all internal containers.
+                // This invalidates the player pointer, so it must not be used after this point.
+                RemoveRetiredPlayer(dog_id);
             }
-
-            const Player* player = it->second;
-
-            // Emit the public player-retired signal. This allows external components
-            // (like score recorder) to react before the player is removed.
-            // The player object is still valid at this point.
-            player_retired_signal_(dog_id, dog_score, *player);
-
-            // Finally, remove the player from all internal containers.
-            // This invalidates the player pointer, so it must not be used after this point.
-            RemoveRetiredPlayer(dog_id);
         }
     );
 
@@ -194,26 +248,17 @@ void Players::ConnectToDogDeletedSignal(model::GameSession *session) {
     session_connections_.emplace(session->GetId(), std::move(connection));
 }
 
-const std::map<uint32_t, const Player*> Players::GetPlayersByMap(const model::Map::Id &map_id) const {
-    std::map<std::uint32_t, const Player*> result;
-
-    // find all players on map
-    for (const auto &player: token_to_player_ | std::views::values) {
-        if (player->GetGameSession()->GetMap()->GetId() == map_id) {
-            result.emplace(player->GetId(), player.get());
-        }
-    }
-
-    return result;
-}
-
 void Player::SetDirection(app_geom::Direction2D dir) {
     if (dog_) {
-        // Forward direction to the actual game character
-        dog_->SetDirection(dir);
+        // Forward direction to the actual game character, through the session (retirement countdown)
+        session_->SetDogDirection(*dog_, dir);
     } else {
         throw std::runtime_error("Player::SetDirection: Dog not assigned to player.");
     }
 }
 
+void Player::PostDirection(app_geom::Direction2D dir) {
+    session_->PostDogDirection(action_slot_, dir);
+}
+
 } // namespace app
@@ -5,10 +5,13 @@
 #include <memory>
 #include <unordered_map>
 #include <optional>
+#include <span>
+#include <vector>
 
 #include "../game_model/game_model.h"
 #include "../common/tagged.h"
 #include "token.h"
+#include "token_table.h"
 
 namespace app {
 
@@ -20,6 +23,7 @@ public:
         , name_(std::move(name))
         , session_(session)
         , join_time_(join_time)
+        , action_slot_(std::make_shared<model::ActionSlot>(id))
     {
         dog_ = session_->RequestDog(id_, name_, restored);
     }
@@ -50,8 +54,12 @@ public:
         return dog_;
     }
 
+    // Applied at once (on the API strand)
     void SetDirection(app_geom::Direction2D dir);
 
+    // Applied at the start of the session's next tick; safe from any thread
+    void PostDirection(app_geom::Direction2D dir);
+
     [[nodiscard]] std::chrono::milliseconds GetJoinTime() const noexcept {
         return join_time_;
     }
@@ -62,6 +70,7 @@ private:
     model::GameSession* session_ = nullptr;
     model::Dog* dog_ = nullptr;
     std::chrono::milliseconds join_time_{};
+    std::shared_ptr<model::ActionSlot> action_slot_;
 };
 
 class Players {
@@ -89,20 +98,33 @@ public:
 
     const Token* FindTokenByPlayer(const Player& player) const;
 
+    // API strand only: the raw pointer is valid until the player retires, and retirement runs on the strand.
+    // The table lookup itself is lock-free, but off the strand the pointer may dangle - use FindSharedPlayerByToken
     const Player* FindPlayerByToken(const Token& token) const;
 
     Player* FindPlayerByToken(const Token& token);
 
+    // The lookup for any thread: shares ownership with the token table, so the player stays valid
+    // off the API strand even if it retires meanwhile
+    std::shared_ptr<Player> FindSharedPlayerByToken(const Token& token);
+
     const Player* FindPlayerById(std::uint32_t player_id) const;
 
+    Player* FindPlayerById(std::uint32_t player_id);
+
+    // Membership indexes below are kept up to date on join, restore and retirement.
+    // Spans are ordered by player ID and stay valid until the next of these changes. Bots are not players.
+
     // Get all players ordered by ID
-    const std::map<std::uint32_t, const Player*> GetPlayersAll() const;
+    std::span<const Player* const> GetPlayersAll() const noexcept {
+        return players_by_id_;
+    }
 
     // Get players for selected Map from all GameSessions
-    const std::map<std::uint32_t, const Player*> GetPlayersByMap(const model::Map::Id &map_id) const;
+    std::span<const Player* const> GetPlayersByMap(const model::Map::Id &map_id) const;
 
     // Get players for selected Map for current GameSession
-    const std::map<std::uint32_t, const Player*> GetPlayersBySession(const model::GameSession::Id& session_id) const;
+    std::span<const Player* const> GetPlayersBySession(const model::GameSession::Id& session_id) const;
 
     uint32_t GetNextPlayerId() const {
         return next_player_id_;
@@ -125,10 +147,12 @@ public:
         if (it == player_id_to_player_.end()) {
             throw std::runtime_error("Players::RemoveRetiredPlayer: Player not found");
         };
-        // Remove from token map
-        const Token* token = player_id_to_token_[player_id];
-        token_to_player_.erase(*token);
+        // Remove from token table
+        if (auto key = ParseTokenKey(*player_id_to_token_.at(player_id))) {
+            token_to_player_.Erase(*key);
+        }
         // Remove from helper maps
+        RemoveFromIndexes(*it->second);
         player_id_to_token_.erase(player_id);
         player_id_to_player_.erase(player_id);
     }
@@ -144,11 +168,17 @@ private:
     uint32_t next_player_id_ = 1;   // same used for Dog id
     TokenGen token_gen_;
 
-    // origin Token & Player data storage
-    std::unordered_map<Token, std::unique_ptr<Player>, util::TaggedHasher<Token>> token_to_player_;
+    // origin Player data storage, keyed by binary token
+    TokenTable<Player> token_to_player_;
     // helper containers for quick search
-    std::map<std::uint32_t, const Token*> player_id_to_token_;
+    std::map<std::uint32_t, Token> player_id_to_token_;
     std::unordered_map<std::uint32_t, const Player*> player_id_to_player_;
+    // membership indexes, each ordered by player ID
+    std::vector<const Player*> players_by_id_;
+    std::unordered_map<model::Map::Id, std::vector<const Player*>,
+                       util::TaggedHasher<model::Map::Id>> players_by_map_;
+    std::unordered_map<model::GameSession::Id, std::vector<const Player*>,
+                       util::TaggedHasher<model::GameSession::Id>> players_by_session_;
 
     std::function<void(model::GameSession* session)> player_retire_handler_{nullptr};
 
@@ -162,6 +192,9 @@ private:
     // Ensures that exactly one connection per session is stored in session_connections_.
     // Called when the first player joins a session (including restored players).
     void ConnectToDogDeletedSignal(model::GameSession* session);
+
+    void AddToIndexes(const Player& player);
+    void RemoveFromIndexes(const Player& player);
 };
 
 } // namespace app
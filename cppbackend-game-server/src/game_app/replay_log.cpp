@@ -0,0 +1,284 @@
+#include "replay_log.h"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "../common/boost_logger.h"
+
+namespace replay {
+
+namespace {
+
+constexpr std::string_view MAGIC = "GSRP";
+constexpr std::uint64_t FORMAT_VERSION = 1;
+
+enum HeaderFlags : std::uint64_t {
+    ENABLE_BOTS = 1 << 0,
+    RANDOMIZE_SPAWN_POINTS = 1 << 1,
+    ENABLE_RETIREMENT = 1 << 2,
+};
+
+void PutVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void PutString(std::string& out, std::string_view value) {
+    PutVarint(out, value.size());
+    out.append(value);
+}
+
+// Cursor over the loaded log, every read reports whether the data was complete
+class Input {
+public:
+    Input(const std::string& data, size_t& pos)
+        : data_(data)
+        , pos_(pos) {
+    }
+
+    bool GetByte(std::uint8_t& value) {
+        if (pos_ >= data_.size()) return false;
+        value = static_cast<std::uint8_t>(data_[pos_++]);
+        return true;
+    }
+
+    bool GetVarint(std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint8_t byte;
+            if (!GetByte(byte)) return false;
+            value |= std::uint64_t{byte & 0x7Fu} << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    bool GetString(std::string& value) {
+        std::uint64_t size;
+        if (!GetVarint(size) || size > data_.size() - pos_) return false;
+        value.assign(data_, pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+private:
+    const std::string& data_;
+    size_t& pos_;
+};
+
+[[noreturn]] void ThrowBadLog(const std::string& message) {
+    boost_logger::LogError(EXIT_FAILURE, message, "ReplayReader::ReplayReader");
+    throw std::runtime_error(message);
+}
+
+class Fnv1a {
+public:
+    void Add(std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash_ ^= (value >> (i * 8)) & 0xFF;
+            hash_ *= PRIME;
+        }
+    }
+
+    void Add(double value) {
+        Add(std::bit_cast<std::uint64_t>(value));
+    }
+
+    [[nodiscard]] std::uint64_t Get() const noexcept {
+        return hash_;
+    }
+
+private:
+    static constexpr std::uint64_t OFFSET_BASIS = 0xcbf29ce484222325ull;
+    static constexpr std::uint64_t PRIME = 0x100000001b3ull;
+    std::uint64_t hash_ = OFFSET_BASIS;
+};
+
+void HashDogs(Fnv1a& hash, const std::map<std::uint32_t, model::Dog>& dogs) {
+    hash.Add(std::uint64_t{dogs.size()});
+    for (const auto& [id, dog] : dogs) {
+        hash.Add(std::uint64_t{id});
+        hash.Add(dog.GetPosition().x);
+        hash.Add(dog.GetPosition().y);
+        hash.Add(dog.GetSpeed().x);
+        hash.Add(dog.GetSpeed().y);
+        hash.Add(static_cast<std::uint64_t>(dog.GetDirection()));
+        hash.Add(std::uint64_t{dog.GetScore()});
+        hash.Add(std::uint64_t{dog.GetBag().size()});
+        for (const auto* loot : dog.GetBag()) {
+            hash.Add(std::uint64_t{loot->object_id});
+        }
+    }
+}
+
+} // namespace
+
+ReplayWriter::ReplayWriter(const std::filesystem::path& path, const ReplayHeader& header)
+    : out_(path, std::ios::binary | std::ios::trunc)
+{
+    if (!out_) {
+        std::string error_msg = "Cannot open replay log " + path.string();
+        boost_logger::LogError(EXIT_FAILURE, error_msg, "ReplayWriter::ReplayWriter");
+        throw std::runtime_error(error_msg);
+    }
+    buffer_.reserve(FLUSH_THRESHOLD * 2);
+    buffer_.append(MAGIC);
+    PutVarint(buffer_, FORMAT_VERSION);
+    PutString(buffer_, header.config_file);
+    PutVarint(buffer_, header.game_seed);
+    PutVarint(buffer_, header.bot_seed);
+    PutVarint(buffer_, header.bot_plan_budget);
+    PutVarint(buffer_, (header.enable_bots ? ENABLE_BOTS : 0)
+                       | (header.randomize_spawn_points ? RANDOMIZE_SPAWN_POINTS : 0)
+                       | (header.enable_retirement ? ENABLE_RETIREMENT : 0));
+    FlushLocked();
+}
+
+ReplayWriter::~ReplayWriter() {
+    try {
+        Flush();
+    } catch (...) {
+    }
+}
+
+void ReplayWriter::WriteTick(std::chrono::milliseconds delta) {
+    std::lock_guard lock{mutex_};
+    buffer_.push_back(static_cast<char>(RecordType::TICK));
+    PutVarint(buffer_, static_cast<std::uint64_t>(delta.count()));
+    FlushIfFull();
+}
+
+void ReplayWriter::WriteJoin(std::string_view name, std::string_view map) {
+    std::lock_guard lock{mutex_};
+    buffer_.push_back(static_cast<char>(RecordType::JOIN));
+    PutString(buffer_, name);
+    PutString(buffer_, map);
+    FlushIfFull();
+}
+
+void ReplayWriter::WriteAction(std::uint32_t player_id, app_geom::Direction2D direction) {
+    std::lock_guard lock{mutex_};
+    buffer_.push_back(static_cast<char>(RecordType::ACTION));
+    PutVarint(buffer_, player_id);
+    PutVarint(buffer_, static_cast<std::uint64_t>(direction));
+    FlushIfFull();
+}
+
+void ReplayWriter::Flush() {
+    std::lock_guard lock{mutex_};
+    FlushLocked();
+}
+
+void ReplayWriter::FlushIfFull() {
+    if (buffer_.size() >= FLUSH_THRESHOLD) {
+        FlushLocked();
+    }
+}
+
+void ReplayWriter::FlushLocked() {
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    out_.flush();
+    buffer_.clear();
+}
+
+ReplayReader::ReplayReader(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        ThrowBadLog("Cannot open replay log " + path.string());
+    }
+    data_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    if (data_.compare(0, MAGIC.size(), MAGIC) != 0) {
+        ThrowBadLog("Not a replay log: " + path.string());
+    }
+    pos_ = MAGIC.size();
+
+    Input input{data_, pos_};
+    std::uint64_t version = 0, plan_budget = 0, flags = 0;
+    if (!input.GetVarint(version) || version != FORMAT_VERSION) {
+        ThrowBadLog("Unsupported replay log version in " + path.string());
+    }
+    if (!input.GetString(header_.config_file)
+        || !input.GetVarint(header_.game_seed)
+        || !input.GetVarint(header_.bot_seed)
+        || !input.GetVarint(plan_budget)
+        || !input.GetVarint(flags)) {
+        ThrowBadLog("Truncated replay log header in " + path.string());
+    }
+    header_.bot_plan_budget = static_cast<std::uint32_t>(plan_budget);
+    header_.enable_bots = (flags & ENABLE_BOTS) != 0;
+    header_.randomize_spawn_points = (flags & RANDOMIZE_SPAWN_POINTS) != 0;
+    header_.enable_retirement = (flags & ENABLE_RETIREMENT) != 0;
+}
+
+bool ReplayReader::Next(Record& record) {
+    const size_t record_start = pos_;
+    Input input{data_, pos_};
+
+    std::uint8_t type;
+    if (!input.GetByte(type)) return false;
+
+    bool complete = false;
+    std::uint64_t value = 0;
+    record.type = static_cast<RecordType>(type);
+    switch (record.type) {
+        case RecordType::TICK:
+            complete = input.GetVarint(value);
+            record.delta = std::chrono::milliseconds(value);
+            break;
+        case RecordType::JOIN:
+            complete = input.GetString(record.name) && input.GetString(record.map);
+            break;
+        case RecordType::ACTION:
+            complete = input.GetVarint(value);
+            record.player_id = static_cast<std::uint32_t>(value);
+            complete = complete && input.GetVarint(value)
+                       && value <= static_cast<std::uint64_t>(app_geom::Direction2D::DOWN);
+            record.direction = static_cast<app_geom::Direction2D>(value);
+            break;
+        default:
+            break;
+    }
+
+    if (!complete) {
+        boost_logger::LogInfo("ReplayReader: log ends with a broken record at offset " + std::to_string(record_start));
+        pos_ = data_.size();
+        return false;
+    }
+    return true;
+}
+
+std::uint64_t HashGameState(const model::Game& game) {
+    std::vector<const model::GameSession*> sessions;
+    sessions.reserve(game.GetSessions().size());
+    for (const auto& [id, session] : game.GetSessions()) {
+        sessions.push_back(&session);
+    }
+    std::ranges::sort(sessions, {}, [](const model::GameSession* session) { return *session->GetId(); });
+
+    Fnv1a hash;
+    for (const auto* session : sessions) {
+        hash.Add(std::uint64_t{*session->GetId()});
+        HashDogs(hash, session->GetDogs());
+        HashDogs(hash, session->GetBots());
+
+        const auto& loots = session->GetLootStorage().GetLootObjects();
+        hash.Add(std::uint64_t{loots.size()});
+        for (const auto& [id, loot] : loots) {
+            hash.Add(static_cast<std::uint64_t>(id));
+            hash.Add(loot.pos.x);
+            hash.Add(loot.pos.y);
+            hash.Add(std::uint64_t{loot.loot_data_ptr ? loot.loot_data_ptr->type_id : 0});
+            hash.Add(std::uint64_t{loot.collected});
+        }
+    }
+    return hash.Get();
+}
+
+} // namespace replay
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "../game_model/game_model.h"
+
+namespace replay {
+
+// Settings besides the recorded inputs that decide how a run evolves
+struct ReplayHeader {
+    std::string config_file;
+    std::uint64_t game_seed = 0;            // loot placement and random spawn points
+    std::uint64_t bot_seed = 0;
+    std::uint32_t bot_plan_budget = 0;
+    bool enable_bots = false;
+    bool randomize_spawn_points = false;
+    bool enable_retirement = false;
+};
+
+enum class RecordType : std::uint8_t {
+    TICK = 1,
+    JOIN = 2,
+    ACTION = 3,
+};
+
+// One recorded input of Application, only the fields of its type are set
+struct Record {
+    RecordType type = RecordType::TICK;
+    std::chrono::milliseconds delta{0};                             // TICK
+    std::string name;                                               // JOIN
+    std::string map;                                                // JOIN
+    std::uint32_t player_id = 0;                                    // ACTION
+    app_geom::Direction2D direction = app_geom::Direction2D::STOP;  // ACTION
+};
+
+// Appends Application inputs to a compact binary log: "GSRP" magic, format version and header,
+// then records of a type byte followed by LEB128 varint / length-prefixed string fields.
+// Records are buffered and written in blocks. Thread-safe.
+class ReplayWriter {
+public:
+    ReplayWriter(const std::filesystem::path& path, const ReplayHeader& header);
+    ~ReplayWriter();
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    void WriteTick(std::chrono::milliseconds delta);
+    void WriteJoin(std::string_view name, std::string_view map);
+    void WriteAction(std::uint32_t player_id, app_geom::Direction2D direction);
+
+    // Writes buffered records to the file
+    void Flush();
+
+private:
+    static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+    std::mutex mutex_;
+    std::ofstream out_;
+    std::string buffer_;
+
+    void FlushIfFull();
+    void FlushLocked();
+};
+
+// Loads a log written by ReplayWriter and iterates over its records
+class ReplayReader {
+public:
+    explicit ReplayReader(const std::filesystem::path& path);
+
+    [[nodiscard]] const ReplayHeader& GetHeader() const noexcept {
+        return header_;
+    }
+
+    // Reads the next record, false at the end of the log.
+    // A record cut off by a crash of the recording server ends the log.
+    bool Next(Record& record);
+
+private:
+    std::string data_;
+    size_t pos_ = 0;
+    ReplayHeader header_;
+};
+
+// FNV-1a hash of the simulated world: dogs, bots and loot of all sessions in id order
+[[nodiscard]] std::uint64_t HashGameState(const model::Game& game);
+
+} // namespace replay
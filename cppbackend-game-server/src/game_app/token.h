@@ -1,12 +1,15 @@
 #pragma once
 
-#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstring>
 #include <cstdint>
-#include <iomanip>
-#include <random>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include "../common/tagged.h"
+#include "../common/game_utils/chacha20.h"
 
 namespace app {
 
@@ -18,50 +21,131 @@ using Token = util::Tagged<std::string, detail::TokenTag>;
 
 constexpr inline static short TOKEN_LENGTH = 32;
 
-inline static bool IsTokenValid(std::string_view token) {
-    // Check if token has valid format (32 hex characters)
+namespace detail {
+
+// SWAR ("SIMD within a register") check of 8 ASCII characters at a time: true if all are hex digits
+constexpr bool IsHexWord(std::uint64_t word) noexcept {
+    constexpr std::uint64_t ONES = 0x0101010101010101ull;
+    constexpr std::uint64_t HIGH_BITS = 0x8080808080808080ull;
+    if (word & HIGH_BITS) {
+        return false;   // not ASCII
+    }
+    // For bytes below 0x80 high bit of (byte + 0x80 - lo) is set if byte >= lo, of (byte + 0x7F - hi) - if byte > hi
+    auto in_range = [](std::uint64_t bytes, std::uint8_t lo, std::uint8_t hi) {
+        return (bytes + ONES * (0x80 - lo)) & ~(bytes + ONES * (0x7F - hi)) & HIGH_BITS;
+    };
+    const std::uint64_t digits = in_range(word, '0', '9');
+    const std::uint64_t letters = in_range(word | ONES * 0x20, 'a', 'f');   // either case
+    return (digits | letters) == HIGH_BITS;
+}
+
+// Hex digit value by character, 0xFF - not a lowercase hex digit
+constexpr std::array<std::uint8_t, 256> HEX_DECODE = [] {
+    std::array<std::uint8_t, 256> table{};
+    table.fill(0xFF);
+    for (int i = 0; i < 10; ++i) {
+        table['0' + i] = static_cast<std::uint8_t>(i);
+    }
+    for (int i = 0; i < 6; ++i) {
+        table['a' + i] = static_cast<std::uint8_t>(10 + i);
+    }
+    return table;
+}();
+
+// Two hex digits by byte value
+constexpr std::array<std::array<char, 2>, 256> HEX_ENCODE = [] {
+    constexpr std::string_view DIGITS = "0123456789abcdef";
+    std::array<std::array<char, 2>, 256> table{};
+    for (size_t i = 0; i < table.size(); ++i) {
+        table[i] = {DIGITS[i >> 4], DIGITS[i & 0xF]};
+    }
+    return table;
+}();
+
+inline std::uint64_t LoadWord(const char* data) noexcept {
+    std::uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+}  // namespace detail
+
+// Checks token format: 32 hex characters (either case). Checked 8 characters at a time.
+inline bool IsTokenValid(std::string_view token) noexcept {
     if (token.length() != TOKEN_LENGTH) {
         return false;
     }
+    const char* data = token.data();
+    return detail::IsHexWord(detail::LoadWord(data))
+        && detail::IsHexWord(detail::LoadWord(data + 8))
+        && detail::IsHexWord(detail::LoadWord(data + 16))
+        && detail::IsHexWord(detail::LoadWord(data + 24));
+}
 
-    // Validate it contains only hex characters
-    if (!std::all_of(token.begin(), token.end(),
-                     [](char c) { return std::isxdigit(c); })) {
-        return false;
+// Binary form of a token: its 32 hex digits as two 64-bit halves (hi - first 16 digits).
+// Lookups compare and hash these instead of the string.
+struct TokenKey {
+    std::uint64_t hi = 0;
+    std::uint64_t lo = 0;
+
+    auto operator<=>(const TokenKey&) const = default;
+};
+
+struct TokenKeyHasher {
+    size_t operator()(const TokenKey& key) const noexcept {
+        // Halves are uniformly random, mixing is enough
+        return static_cast<size_t>(key.lo ^ (key.hi * 0x9E3779B97F4A7C15ull));
     }
+};
 
-    return true;
+// Parses a token as issued by TokenGen (32 lowercase hex digits)
+inline std::optional<TokenKey> ParseTokenKey(std::string_view token) noexcept {
+    if (token.size() != TOKEN_LENGTH) {
+        return std::nullopt;
+    }
+    auto parse_half = [](const char* digits, std::uint64_t& value) {
+        std::uint8_t invalid = 0;
+        value = 0;
+        for (int i = 0; i < TOKEN_LENGTH / 2; ++i) {
+            const std::uint8_t digit = detail::HEX_DECODE[static_cast<unsigned char>(digits[i])];
+            invalid |= digit;
+            value = (value << 4) | (digit & 0xF);
+        }
+        // Only 0xFF has the high bit set
+        return (invalid & 0x80) == 0;
+    };
+    TokenKey key;
+    if (!parse_half(token.data(), key.hi) || !parse_half(token.data() + TOKEN_LENGTH / 2, key.lo)) {
+        return std::nullopt;
+    }
+    return key;
+}
+
+inline Token FormatToken(const TokenKey& key) {
+    std::string token(TOKEN_LENGTH, '0');
+    for (int i = 0; i < 8; ++i) {
+        const int shift = (7 - i) * 8;
+        const auto& hi_digits = detail::HEX_ENCODE[(key.hi >> shift) & 0xFF];
+        const auto& lo_digits = detail::HEX_ENCODE[(key.lo >> shift) & 0xFF];
+        token[i * 2] = hi_digits[0];
+        token[i * 2 + 1] = hi_digits[1];
+        token[TOKEN_LENGTH / 2 + i * 2] = lo_digits[0];
+        token[TOKEN_LENGTH / 2 + i * 2 + 1] = lo_digits[1];
+    }
+    return Token{std::move(token)};
 }
 
 struct TokenGen {
     Token operator()() {
-        // Generate two 64-bit random numbers
-        std::uniform_int_distribution<std::uint64_t> dist;
-        std::uint64_t part1 = dist(generator1_);
-        std::uint64_t part2 = dist(generator2_);
-
-        // Convert to hex strings and concatenate
-        std::stringstream ss;
-        ss << std::hex << std::setfill('0')
-           << std::setw(16) << part1
-           << std::setw(16) << part2;
-
-        return Token{ss.str()};
+        return FormatToken(NewKey());
+    }
+
+    TokenKey NewKey() {
+        return TokenKey{engine_(), engine_()};
     }
 private:
-    std::random_device random_device_;
-    std::mt19937_64 generator1_{[this] {
-        std::uniform_int_distribution<std::mt19937_64::result_type> dist;
-        return dist(random_device_);
-    }()};
-    std::mt19937_64 generator2_{[this] {
-        std::uniform_int_distribution<std::mt19937_64::result_type> dist;
-        return dist(random_device_);
-    }()};
-    // Чтобы сгенерировать токен, получите из generator1_ и generator2_
-    // два 64-разрядных числа и, переведя их в hex-строки, склейте в одну.
-    // Вы можете поэкспериментировать с алгоритмом генерирования токенов,
-    // чтобы сделать их подбор ещё более затруднительным
+    // CSPRNG keyed from std::random_device, tokens cannot be predicted from the ones already issued
+    game_rng::ChaCha20 engine_;
 };
 
 } // namespace app
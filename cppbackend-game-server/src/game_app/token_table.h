@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "token.h"
+
+namespace app {
+
+// Concurrent token -> value table for read-mostly lookups (every authenticated request reads it,
+// only joins and retirements write).
+//
+// Keys are spread over ShardCount shards by the token's high half. Each shard publishes an immutable
+// snapshot of its map through an atomic pointer (RCU-style):
+//  - Find is lock-free: it registers in the shard's current reader epoch (an atomic increment),
+//    loads the snapshot and copies the found shared_ptr out, so the value outlives a later Erase;
+//  - Insert / Erase copy the shard's map under the shard mutex, publish the copy, then wait until
+//    readers of the previous epoch are gone before deleting the old snapshot.
+// Writers pay O(shard size) per change, which is fine while joins are rare next to reads.
+template <typename Value, size_t ShardCount = 16>
+class TokenTable {
+    static_assert(ShardCount > 0 && (ShardCount & (ShardCount - 1)) == 0, "ShardCount must be a power of two");
+
+public:
+    using Map = std::unordered_map<TokenKey, std::shared_ptr<Value>, TokenKeyHasher>;
+
+    TokenTable() {
+        for (auto& shard : shards_) {
+            shard.snapshot.store(new Map{});
+        }
+    }
+
+    ~TokenTable() {
+        for (auto& shard : shards_) {
+            delete shard.snapshot.load();
+        }
+    }
+
+    TokenTable(const TokenTable&) = delete;
+    TokenTable& operator=(const TokenTable&) = delete;
+
+    // nullptr if the key is unknown. Safe from any thread, concurrently with writers.
+    [[nodiscard]] std::shared_ptr<Value> Find(const TokenKey& key) const {
+        const Shard& shard = ShardOf(key);
+        ReadGuard guard{shard};
+        const Map& map = *shard.snapshot.load();
+        if (auto it = map.find(key); it != map.end()) {
+            return it->second;
+        }
+        return nullptr;
+    }
+
+    // false if the key is already present (the table is unchanged then)
+    bool Insert(const TokenKey& key, std::shared_ptr<Value> value) {
+        Shard& shard = ShardOf(key);
+        std::lock_guard lock{shard.write_mutex};
+        const Map* current = shard.snapshot.load();
+        if (current->contains(key)) {
+            return false;
+        }
+        auto next = std::make_unique<Map>(*current);
+        next->emplace(key, std::move(value));
+        Publish(shard, next.release());
+        size_.fetch_add(1);
+        return true;
+    }
+
+    // false if the key is unknown
+    bool Erase(const TokenKey& key) {
+        Shard& shard = ShardOf(key);
+        std::lock_guard lock{shard.write_mutex};
+        const Map* current = shard.snapshot.load();
+        if (!current->contains(key)) {
+            return false;
+        }
+        auto next = std::make_unique<Map>(*current);
+        next->erase(key);
+        Publish(shard, next.release());
+        size_.fetch_sub(1);
+        return true;
+    }
+
+    // Erases every entry with pred(key, value) true, one shard snapshot rebuilt per shard that changes.
+    // O(table size) - for periodic sweeps, not per request. Returns the number of entries erased.
+    template <typename Pred>
+    size_t EraseIf(Pred&& pred) {
+        size_t erased = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard lock{shard.write_mutex};
+            const Map* current = shard.snapshot.load();
+            auto next = std::make_unique<Map>();
+            next->reserve(current->size());
+            for (const auto& [key, value] : *current) {
+                if (!pred(key, *value)) {
+                    next->emplace(key, value);
+                }
+            }
+            if (const size_t removed = current->size() - next->size(); removed != 0) {
+                Publish(shard, next.release());
+                size_.fetch_sub(removed);
+                erased += removed;
+            }
+        }
+        return erased;
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return size_.load();
+    }
+
+private:
+    struct Shard {
+        std::mutex write_mutex;
+        std::atomic<const Map*> snapshot{nullptr};
+        std::atomic<unsigned> epoch{0};
+        // Readers of even / odd epochs, each on its own cache line
+        struct alignas(64) ReaderCount {
+            std::atomic<unsigned> value{0};
+        };
+        mutable std::array<ReaderCount, 2> readers;
+    };
+
+    class ReadGuard {
+    public:
+        // Registers in the current epoch; retries if a writer flipped it meanwhile, otherwise
+        // a writer two publications later could miss this reader
+        explicit ReadGuard(const Shard& shard) {
+            for (;;) {
+                const unsigned epoch = shard.epoch.load();
+                count_ = &shard.readers[epoch & 1].value;
+                count_->fetch_add(1);
+                if (shard.epoch.load() == epoch) {
+                    return;
+                }
+                count_->fetch_sub(1);
+            }
+        }
+
+        ~ReadGuard() {
+            count_->fetch_sub(1);
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        std::atomic<unsigned>* count_ = nullptr;
+    };
+
+    // Called under the shard mutex. Readers that register after the epoch flip see the new snapshot,
+    // so once the previous epoch drains nobody can hold the old one.
+    static void Publish(Shard& shard, const Map* next) {
+        const Map* previous = shard.snapshot.exchange(next);
+        const unsigned old_epoch = shard.epoch.fetch_add(1);
+        while (shard.readers[old_epoch & 1].value.load() != 0) {
+            std::this_thread::yield();
+        }
+        delete previous;
+    }
+
+    Shard& ShardOf(const TokenKey& key) {
+        return shards_[key.hi & (ShardCount - 1)];
+    }
+
+    const Shard& ShardOf(const TokenKey& key) const {
+        return shards_[key.hi & (ShardCount - 1)];
+    }
+
+    std::array<Shard, ShardCount> shards_;
+    std::atomic<size_t> size_{0};
+};
+
+} // namespace app
@@ -1,18 +1,23 @@
 #include "bot_ai.h"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include "../common/utils.h"  // for CalculateDistance2D
 
 namespace model {
 
-std::optional<app_geom::Direction2D> BotAI::UpdateDirection(
+BotDecision BotAI::UpdateDirection(
     const Dog& dog,
     const Map& map,
     const RoadGraph& road_graph,
     const BotWorldState& world_state,
-    std::mt19937& rng,
-    std::chrono::milliseconds time_delta)
+    const LootClaims& loot_claims,
+    BotRng& rng,
+    std::chrono::milliseconds time_delta,
+    bool defer_planning)
 {
+    BotDecision decision;
+
     // ------------------------------------------------------------------
     // 1. Update internal timer (used for roaming timeout)
     // ------------------------------------------------------------------
@@ -21,82 +26,44 @@ std::optional<app_geom::Direction2D> BotAI::UpdateDirection(
     // ------------------------------------------------------------------
     // 2. Detect important events via bag size changes
     // ------------------------------------------------------------------
-    // If bag becomes full → go to nearest office
-    if (dog.GetBag().size() >= map.GetDefaultCapacity()) {
-        state_ = State::MOVING_TO_OFFICE;
-        ResetTargetAndTime();   // discard old target, reset timer
+    const size_t bag_size = dog.GetBag().size();
+    // If bag is full → go to nearest office (once, keep the office target afterwards)
+    if (bag_size >= map.GetDefaultCapacity()) {
+        if (state_ != State::MOVING_TO_OFFICE) {
+            state_ = State::MOVING_TO_OFFICE;
+            ResetTargetAndTime();   // discard old target, reset timer
+        }
     }
-    // If bag becomes empty → we must have reached an office (or started empty) → roam
-    else if (dog.GetBag().empty()) {
+    // If bag becomes empty → we must have reached an office → roam
+    else if (bag_size == 0 && last_bag_size_ > 0) {
         state_ = State::ROAMING;
         ResetTargetAndTime();
     }
-    last_bag_size_ = dog.GetBag().size();   // store for future use (if needed)
+    last_bag_size_ = bag_size;
 
     // ------------------------------------------------------------------
     // 3. Possibly switch from roaming to loot seeking (randomly)
     // ------------------------------------------------------------------
     UpdateStateFromWorld(dog, world_state, rng);
+    decision.released_loot = UpdateLootClaim(world_state);
 
     // ------------------------------------------------------------------
-    // 4. If we have no target, decide what to do based on current state
+    // 4. If we have no target, decide what to do based on current state.
+    //    Roam for a while before picking a new random point on the road network.
     // ------------------------------------------------------------------
-    if (!target_) {
-        switch (state_) {
-            case State::ROAMING:
-                // Roam for a while, then pick a new random point on the road network
-                if (time_in_state_ >= MAX_ROAM_TIME) {
-                    ChooseNewRoamingTarget(dog, map, rng);
-                    time_in_state_ = std::chrono::milliseconds::zero();
-                }
-                break;
-
-            case State::MOVING_TO_LOOT:
-                if (!world_state.loot_positions.empty()) {
-                    // Go to the closest loot pile
-                    auto closest = std::ranges::min_element(world_state.loot_positions,
-                        [&](const auto& a, const auto& b) {
-                            return utils::CalculateDistance2D(dog.GetPosition(), a) <
-                                   utils::CalculateDistance2D(dog.GetPosition(), b);
-                        });
-                    target_ = *closest;
-                } else {
-                    // No loot visible → fall back to roaming
-                    RoamingToPoint(map.GetRandomPoint());
-                }
-                break;
-
-            case State::MOVING_TO_OFFICE:
-                if (!world_state.office_positions.empty()) {
-                    // Go to the closest office
-                    auto closest = std::ranges::min_element(world_state.office_positions,
-                        [&](const auto& a, const auto& b) {
-                            return utils::CalculateDistance2D(dog.GetPosition(), a) <
-                                   utils::CalculateDistance2D(dog.GetPosition(), b);
-                        });
-                    target_ = *closest;
-                } else {
-                    // No offices (shouldn't happen) → roam
-                    RoamingToPoint(map.GetRandomPoint());
-                }
-                break;
-        }
-
-        // If we now have a target, compute a path to it
-        if (target_) {
-            PlanPathToTarget(dog, road_graph);
+    const bool keep_roaming = state_ == State::ROAMING && time_in_state_ < MAX_ROAM_TIME;
+    if (!target_ && !awaiting_plan_ && !keep_roaming) {
+        if (defer_planning) {
+            // BotManager plans it within the per-tick budget; reuse the last direction meanwhile
+            awaiting_plan_ = true;
+            decision.wants_plan = true;
+        } else {
+            size_t expansions = 0;
+            decision.claimed_loot = ChooseTarget(dog, map, road_graph, world_state, loot_claims, rng, expansions,
+                                                 std::numeric_limits<size_t>::max());
         }
     }
 
-    // ------------------------------------------------------------------
-    // 5. If path planning failed, give up and go back to roaming
-    // ------------------------------------------------------------------
-    if (target_ && path_.empty()) {
-        target_.reset();
-        state_ = State::ROAMING;
-        time_in_state_ = std::chrono::milliseconds::zero();
-    }
-
     // ------------------------------------------------------------------
     // 6. Follow the path (if any) and determine the desired direction
     // ------------------------------------------------------------------
@@ -146,10 +113,10 @@ std::optional<app_geom::Direction2D> BotAI::UpdateDirection(
         if (last_direction_ && reuse_counter_ < kMaxDirectionReuse) {
             if (IsDirectionValid(dog, map, *last_direction_)) {
                 ++reuse_counter_;
-                return *last_direction_;
+                decision.direction = last_direction_;
             }
         }
-        return std::nullopt;
+        return decision;
     }
 
     // ------------------------------------------------------------------
@@ -157,10 +124,76 @@ std::optional<app_geom::Direction2D> BotAI::UpdateDirection(
     // ------------------------------------------------------------------
     last_direction_ = desired_dir;
     reuse_counter_ = 0;
-    return desired_dir;
+    decision.direction = desired_dir;
+    return decision;
+}
+
+std::optional<std::uint32_t> BotAI::PlanPending(const Dog& dog, const Map& map, const RoadGraph& road_graph,
+                                               const BotWorldState& world_state, const LootClaims& loot_claims,
+                                               BotRng& rng, size_t& expansions, size_t expansion_limit) {
+    if (!awaiting_plan_) return std::nullopt;
+    awaiting_plan_ = false;
+    // The state may have changed while waiting (e.g. bag filled up) - plan for the current one
+    if (target_ || (state_ == State::ROAMING && time_in_state_ < MAX_ROAM_TIME)) return std::nullopt;
+    return ChooseTarget(dog, map, road_graph, world_state, loot_claims, rng, expansions, expansion_limit);
 }
 
-void BotAI::ChooseNewRoamingTarget(const Dog& dog, const Map& map, std::mt19937& rng) {
+std::optional<std::uint32_t> BotAI::ChooseTarget(const Dog& dog, const Map& map, const RoadGraph& road_graph,
+                                                const BotWorldState& world_state, const LootClaims& loot_claims,
+                                                BotRng& rng, size_t& expansions, size_t expansion_limit) {
+    std::optional<std::uint32_t> claimed_loot;
+    bool path_planned = false;
+    switch (state_) {
+        case State::ROAMING:
+            ChooseNewRoamingTarget(dog, map, rng);
+            time_in_state_ = std::chrono::milliseconds::zero();
+            break;
+
+        case State::MOVING_TO_LOOT: {
+            // Go to the closest (by road) loot pile not claimed by another bot
+            const auto bot_id = dog.GetId();
+            world_state.loot.KNearest(dog.GetPosition(), kRoadCandidates,
+                [&](const spatial::Item& loot) {
+                    return loot_claims.IsFreeFor(loot.id, bot_id);
+                }, candidates_);
+            if (auto loot_id = PlanToNearestByRoad(dog, road_graph, expansions, expansion_limit)) {
+                target_loot_id_ = loot_id;
+                claimed_loot = loot_id;
+                path_planned = true;
+            } else {
+                // No free loot reachable → fall back to roaming
+                RoamingToPoint(map.GetRandomPoint(rng));
+            }
+            break;
+        }
+
+        case State::MOVING_TO_OFFICE:
+            // Go to the closest (by road) office
+            world_state.offices.KNearest(dog.GetPosition(), kRoadCandidates, candidates_);
+            if (PlanToNearestByRoad(dog, road_graph, expansions, expansion_limit)) {
+                path_planned = true;
+            } else {
+                // No offices (shouldn't happen) → roam
+                RoamingToPoint(map.GetRandomPoint(rng));
+            }
+            break;
+    }
+
+    // If we now have a target, compute a path to it
+    if (target_ && !path_planned) {
+        PlanPathToTarget(dog, road_graph, expansions);
+    }
+
+    // If path planning failed, give up and go back to roaming
+    if (target_ && path_.empty()) {
+        target_.reset();
+        state_ = State::ROAMING;
+        time_in_state_ = std::chrono::milliseconds::zero();
+    }
+    return claimed_loot;
+}
+
+void BotAI::ChooseNewRoamingTarget(const Dog& dog, const Map& map, BotRng& rng) {
     const auto& roads = map.GetRoads();
     if (roads.empty()) return;
 
@@ -188,22 +221,22 @@ void BotAI::ChooseNewRoamingTarget(const Dog& dog, const Map& map, std::mt19937&
     target_ = target;
 }
 
-void BotAI::PlanPathToTarget(const Dog& dog, const RoadGraph& road_graph) {
+void BotAI::PlanPathToTarget(const Dog& dog, const RoadGraph& road_graph, size_t& expansions) {
     if (!target_) {
         path_.clear();
         return;
     }
-    path_ = road_graph.FindPath(dog.GetPosition(), *target_);
+    path_ = road_graph.FindPath(dog.GetPosition(), *target_, &expansions);
     path_index_ = 0;
 }
 
-void BotAI::UpdateStateFromWorld(const Dog& dog, const BotWorldState& world_state, std::mt19937& rng) {
+void BotAI::UpdateStateFromWorld(const Dog& dog, const BotWorldState& world_state, BotRng& rng) {
     // If bag not full and we are roaming, occasionally switch to loot seeking
     if (state_ == State::ROAMING &&
         dog.GetBag().size() < dog.GetMap()->GetDefaultCapacity() &&
-        !world_state.loot_positions.empty())
+        !world_state.loot.Empty())
     {
-        static std::uniform_real_distribution<double> prob(0.0, 1.0);
+        std::uniform_real_distribution<double> prob(0.0, 1.0);
         if (prob(rng) < common_values::DEFAULT_LOOT_CONFIG_PROBABILITY) {
             state_ = State::MOVING_TO_LOOT;
             ResetTargetAndTime();
@@ -211,6 +244,58 @@ void BotAI::UpdateStateFromWorld(const Dog& dog, const BotWorldState& world_stat
     }
 }
 
+std::optional<std::uint32_t> BotAI::UpdateLootClaim(const BotWorldState& world_state) {
+    if (!target_loot_id_) return std::nullopt;
+
+    // Keep the claim only while we are still heading to a pile that is still on the map
+    const bool loot_present = world_state.loot.Find(*target_loot_id_) != nullptr;
+    if (state_ == State::MOVING_TO_LOOT && target_ && loot_present) return std::nullopt;
+
+    auto released = target_loot_id_;
+    target_loot_id_.reset();
+    if (state_ == State::MOVING_TO_LOOT && !loot_present) {
+        // Someone else picked it up → choose another pile
+        target_.reset();
+        path_.clear();
+        path_index_ = 0;
+    }
+    return released;
+}
+
+void BotAI::AbandonLootTarget() {
+    target_loot_id_.reset();
+    target_.reset();
+    path_.clear();
+    path_index_ = 0;
+}
+
+std::optional<std::uint32_t> BotAI::PlanToNearestByRoad(const Dog& dog, const RoadGraph& road_graph,
+                                                       size_t& expansions, size_t expansion_limit) {
+    std::optional<std::uint32_t> best_id;
+    double best_length = std::numeric_limits<double>::max();
+
+    // Candidates come sorted by straight-line distance, which never exceeds road distance,
+    // so once a candidate is farther than the best road path found the rest can be skipped
+    for (const auto& candidate : candidates_) {
+        if (candidate.distance >= best_length) break;
+        // Out of budget: settle for the best path so far rather than search the next candidate
+        if (best_id && expansions >= expansion_limit) break;
+
+        auto path = road_graph.FindPath(dog.GetPosition(), candidate.pos, &expansions);
+        if (path.empty()) continue;
+
+        double length = RoadGraph::PathLength(path);
+        if (length < best_length) {
+            best_length = length;
+            best_id = candidate.id;
+            target_ = candidate.pos;
+            path_ = std::move(path);
+            path_index_ = 0;
+        }
+    }
+    return best_id;
+}
+
 app_geom::Direction2D BotAI::DirectionToWaypoint(const app_geom::Position2D& from,
                                                   const app_geom::Position2D& to) {
     double dx = to.x - from.x;
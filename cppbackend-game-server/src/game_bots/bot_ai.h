@@ -4,30 +4,94 @@
 #include <chrono>
 #include <vector>
 #include <random>
+#include <cstdint>
+#include <unordered_map>
 
 #include "../common/game_utils/geometry.h"
+#include "../common/game_utils/philox.h"
+#include "../common/game_utils/spatial_grid.h"
 #include "../game_model/game_map.h"
 #include "../game_model/road_engine/road_graph.h"
 #include "../game_model/dog.h"
 
 namespace model {
 
+    // Per-bot random stream (stream id = bot id)
+    using BotRng = game_rng::Philox4x32;
+
+    // Snapshot of the world shared by all bots of a session, rebuilt once per tick
     struct BotWorldState {
-        std::vector<app_geom::Position2D> loot_positions;
-        std::vector<app_geom::Position2D> office_positions;
+        spatial::SpatialGrid loot;      // not collected loot, id = loot object id
+        spatial::SpatialGrid offices;   // id = office index on the map
+    };
+
+    // Loot piles already chosen as targets (loot id -> bot id),
+    // so that bots spread over different piles instead of chasing the same one
+    class LootClaims {
+    public:
+        [[nodiscard]] bool IsFreeFor(std::uint32_t loot_id, std::uint32_t bot_id) const {
+            auto it = owners_.find(loot_id);
+            return it == owners_.end() || it->second == bot_id;
+        }
+
+        void Claim(std::uint32_t loot_id, std::uint32_t bot_id) {
+            owners_[loot_id] = bot_id;
+        }
+
+        void Release(std::uint32_t loot_id, std::uint32_t bot_id) {
+            if (auto it = owners_.find(loot_id); it != owners_.end() && it->second == bot_id) {
+                owners_.erase(it);
+            }
+        }
+
+        // Drops claims on loot that is no longer on the map
+        void Prune(const spatial::SpatialGrid& loot) {
+            std::erase_if(owners_, [&loot](const auto& claim) {
+                return loot.Find(claim.first) == nullptr;
+            });
+        }
+
+        [[nodiscard]] size_t Size() const noexcept { return owners_.size(); }
+
+    private:
+        std::unordered_map<std::uint32_t, std::uint32_t> owners_;
+    };
+
+    // Outcome of one bot's decision step. Decisions are computed independently (possibly in parallel)
+    // and applied by BotManager in bot id order.
+    struct BotDecision {
+        std::optional<app_geom::Direction2D> direction;     // std::nullopt - the bot should stop
+        std::optional<std::uint32_t> released_loot;         // claim given up this tick
+        std::optional<std::uint32_t> claimed_loot;          // loot pile chosen this tick
+        bool wants_plan = false;                            // needs a new target/path (deferred planning)
     };
 
     class BotAI {
     public:
         // Called every tick to decide the next direction.
-        // Returns std::nullopt if the bot should stop, otherwise a direction.
-        std::optional<app_geom::Direction2D> UpdateDirection(
+        // Touches only this AI, its rng and read-only shared state, so different bots may decide concurrently.
+        // loot_claims is the snapshot taken before the tick; claim changes are returned in the decision.
+        // With defer_planning the bot does not search paths itself: it sets wants_plan and keeps
+        // reusing its last direction until BotManager calls PlanPending.
+        BotDecision UpdateDirection(
             const Dog& dog,
             const Map& map,
             const RoadGraph& road_graph,
             const BotWorldState& world_state,
-            std::mt19937& rng,
-            std::chrono::milliseconds time_delta);
+            const LootClaims& loot_claims,
+            BotRng& rng,
+            std::chrono::milliseconds time_delta,
+            bool defer_planning = false);
+
+        // Chooses a target and plans the path requested by a deferred decision.
+        // Adds the search cost to expansions, returns the loot pile to claim (if any).
+        // Once a path is found, no more candidates are searched after expansions reaches expansion_limit.
+        std::optional<std::uint32_t> PlanPending(const Dog& dog, const Map& map, const RoadGraph& road_graph,
+                                                 const BotWorldState& world_state, const LootClaims& loot_claims,
+                                                 BotRng& rng, size_t& expansions, size_t expansion_limit);
+
+        // Claimed loot pile was taken by a bot with a smaller id in the same tick - choose again next tick
+        void AbandonLootTarget();
 
     private:
         enum class State {
@@ -38,6 +102,8 @@ namespace model {
         State state_ = State::ROAMING;
 
         std::optional<app_geom::Position2D> target_;
+        std::optional<std::uint32_t> target_loot_id_;     // claimed loot pile while MOVING_TO_LOOT
+        bool awaiting_plan_ = false;                        // queued in BotManager for path planning
         std::vector<app_geom::Position2D> path_;
         size_t path_index_ = 0;
         size_t last_bag_size_ = 0;
@@ -50,10 +116,24 @@ namespace model {
         static constexpr int kMaxDirectionReuse = 5;        // reuse last direction up to 5 times
         static constexpr double kWaypointReachDist = 0.2;   // distance to consider a waypoint reached
         static constexpr double kEpsilon = 0.1;              // tolerance for waypoint arrival
+        static constexpr size_t kRoadCandidates = 4;         // nearest (straight-line) targets compared by road distance
+
+        std::vector<spatial::Neighbor> candidates_;          // query buffer, kept between ticks
+
+        // Picks a target for the current state and plans the path to it, returns the loot pile to claim
+        std::optional<std::uint32_t> ChooseTarget(const Dog& dog, const Map& map, const RoadGraph& road_graph,
+                                                  const BotWorldState& world_state, const LootClaims& loot_claims,
+                                                  BotRng& rng, size_t& expansions, size_t expansion_limit);
+        void ChooseNewRoamingTarget(const Dog& dog, const Map& map, BotRng& rng);
+        void PlanPathToTarget(const Dog& dog, const RoadGraph& road_graph, size_t& expansions);
+        void UpdateStateFromWorld(const Dog& dog, const BotWorldState& world_state, BotRng& rng);
+        // Returns the loot id whose claim should be released
+        std::optional<std::uint32_t> UpdateLootClaim(const BotWorldState& world_state);
 
-        void ChooseNewRoamingTarget(const Dog& dog, const Map& map, std::mt19937& rng);
-        void PlanPathToTarget(const Dog& dog, const RoadGraph& road_graph);
-        void UpdateStateFromWorld(const Dog& dog, const BotWorldState& world_state, std::mt19937& rng);
+        // Sets target_ and path_ to the candidate with the shortest road path, returns its id.
+        // Stops comparing candidates once one is reachable and expansions reaches expansion_limit.
+        std::optional<std::uint32_t> PlanToNearestByRoad(const Dog& dog, const RoadGraph& road_graph,
+                                                         size_t& expansions, size_t expansion_limit);
 
         void ResetTargetAndTime();
         void RoamingToPoint(const app_geom::Position2D& point);
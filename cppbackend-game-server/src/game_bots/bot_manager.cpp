@@ -3,28 +3,66 @@
 #include <ranges>
 
 #include "../common/constants.h"
+#include "../common/metrics.h"
 
 namespace model {
 
-BotManager::BotManager(const Map* map)
+namespace {
+
+struct PlanMetrics {
+    metrics::Counter& plans;
+    metrics::Counter& expansions;
+    metrics::Counter& deferred_ticks;
+};
+
+PlanMetrics& GetPlanMetrics() {
+    auto& registry = metrics::Registry::Instance();
+    static PlanMetrics plan_metrics{
+        registry.GetCounter("bot_path_plans_total", "Number of deferred bot path plans"),
+        registry.GetCounter("bot_path_expansions_total", "Path search expansions spent on deferred bot plans"),
+        registry.GetCounter("bot_path_waits_total", "Bot ticks spent waiting in the path planning queue"),
+    };
+    return plan_metrics;
+}
+
+std::uint64_t ResolveSeed(std::uint64_t seed) {
+    if (seed != 0) return seed;
+    std::random_device rd;
+    return (std::uint64_t{rd()} << 32) | rd();
+}
+
+} // namespace
+
+BotManager::BotManager(const Map* map, BotOptions options)
     : map_(map)
-    , rng_(std::random_device{}())
+    , seed_(ResolveSeed(options.seed))
+    , workers_(options.workers)
+    , plan_budget_(options.plan_budget)
+    , rng_(seed_, 0)
     , road_graph_(map->GetRoads(), map->GetRoadEngine())   // build graph once
 {}
 
+void BotManager::SetOptions(BotOptions options) {
+    seed_ = ResolveSeed(options.seed);
+    workers_ = options.workers;
+    plan_budget_ = options.plan_budget;
+    rng_ = BotRng(seed_, 0);
+}
+
 void BotManager::CreateBots() {
     if (!bots_.empty()) return;
 
-    size_t bot_count = common_values::MAX_PLAYERS_ON_MAP / 2;
+    size_t bot_count = common_values::BOTS_PER_SESSION;
     for (size_t i = 0; i < bot_count; ++i) {
         uint32_t bot_id = next_bot_id_++;
         std::string bot_name = "Bot_" + std::to_string(bot_id);
 
         Dog bot(bot_id, std::move(bot_name), map_);
-        bot.SetPosition(bot.GetMap()->GetRandomPoint());
+        bot.SetPosition(bot.GetMap()->GetRandomPoint(rng_));
 
-        bots_.emplace(bot_id, std::move(bot));      // save bot
-        bot_ais_.emplace(bot_id, BotAI{});          // create AI for this bot
+        auto& saved = bots_.emplace(bot_id, std::move(bot)).first->second;    // save bot
+        // create AI for this bot with its own random stream
+        slots_.push_back(BotSlot{bot_id, &saved, BotAI{}, BotRng(seed_, bot_id), BotDecision{}});
     }
     UpdateDirections();  // give bots an initial direction & initialize last_direction_
 }
@@ -70,20 +108,91 @@ void BotManager::UpdateDirections() {
 }
 
 void BotManager::UpdateDirections(const BotWorldState& world_state,
-                                      std::chrono::milliseconds time_delta) {
-    for (auto& [id, bot] : bots_) {
-        auto ai_it = bot_ais_.find(id);
-        if (ai_it == bot_ais_.end()) continue;
+                                      std::chrono::milliseconds time_delta,
+                                      BotPlanBudget* shared_budget) {
+    // Bots left in the queue by the previous tick have waited one more tick for their path
+    GetPlanMetrics().deferred_ticks.Inc(plan_queue_.size());
+    loot_claims_.Prune(world_state.loot);
+
+    // 1. Decide: bots only read shared state (claims are a snapshot of the previous tick)
+    if (workers_ != nullptr) {
+        workers_->ParallelFor(slots_.size(), MIN_BOTS_PER_CHUNK, [&](size_t begin, size_t end) {
+            DecideChunk(begin, end, world_state, time_delta);
+        });
+    } else {
+        DecideChunk(0, slots_.size(), world_state, time_delta);
+    }
+
+    // 2. Apply in bot id order
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        ApplyDecision(slots_[i]);
+        if (slots_[i].decision.wants_plan && !slots_[i].queued) {
+            slots_[i].queued = true;
+            plan_queue_.push_back(i);
+        }
+    }
 
-        auto opt_dir = ai_it->second.UpdateDirection(
-            bot, *map_, road_graph_, world_state, rng_, time_delta);
+    // 3. Spend what is left of the tick's planning budget on the oldest requests
+    if (plan_budget_ == 0) return;
+    if (shared_budget == nullptr) {
+        own_plan_budget_.Refill(plan_budget_);
+        shared_budget = &own_plan_budget_;
+    }
+    while (PlanNext(world_state, *shared_budget)) {
+    }
+}
 
-        if (opt_dir) {
-            bot.SetDirection(*opt_dir);
+bool BotManager::PlanNext(const BotWorldState& world_state, BotPlanBudget& budget) {
+    if (plan_queue_.empty() || !budget.CanSearch()) return false;
+
+    auto& slot = slots_[plan_queue_.front()];
+    plan_queue_.pop_front();
+    slot.queued = false;
+
+    size_t expansions = 0;
+    auto claimed = slot.ai.PlanPending(*slot.dog, *map_, road_graph_, world_state, loot_claims_,
+                                       slot.rng, expansions, budget.Remaining());
+    // Claims are live here (planning is serial), so the chosen pile is free
+    if (claimed) {
+        loot_claims_.Claim(*claimed, slot.id);
+    }
+    budget.Spend(expansions + 1);   // +1: a search that fails at once still costs a lookup
+
+    auto& plan_metrics = GetPlanMetrics();
+    plan_metrics.plans.Inc();
+    plan_metrics.expansions.Inc(expansions);
+    return true;
+}
+
+void BotManager::DecideChunk(size_t begin, size_t end, const BotWorldState& world_state,
+                             std::chrono::milliseconds time_delta) {
+    for (size_t i = begin; i < end; ++i) {
+        auto& slot = slots_[i];
+        slot.decision = slot.ai.UpdateDirection(
+            *slot.dog, *map_, road_graph_, world_state, loot_claims_, slot.rng, time_delta, plan_budget_ > 0);
+    }
+}
+
+void BotManager::ApplyDecision(BotSlot& slot) {
+    const auto& decision = slot.decision;
+
+    if (decision.released_loot) {
+        loot_claims_.Release(*decision.released_loot, slot.id);
+    }
+    // Two bots may pick the same free pile in one tick - the smaller id keeps it
+    if (decision.claimed_loot) {
+        if (loot_claims_.IsFreeFor(*decision.claimed_loot, slot.id)) {
+            loot_claims_.Claim(*decision.claimed_loot, slot.id);
         } else {
-            bot.SetSpeed(app_geom::Speed2D::Zero());
+            slot.ai.AbandonLootTarget();
         }
     }
+
+    if (decision.direction) {
+        slot.dog->SetDirection(*decision.direction);
+    } else {
+        slot.dog->SetSpeed(app_geom::Speed2D::Zero());
+    }
 }
 
 std::vector<Dog*> BotManager::GetAllBotPointers() {
@@ -1,24 +1,62 @@
 #pragma once
 
+#include <algorithm>
 #include <map>
 #include <random>
 #include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
 
 #include "../game_model/dog.h"
 #include "../game_model/game_map.h"
 #include "../common/game_utils/geometry.h"
 #include "../common/constants.h"
 #include "bot_ai.h"
+#include "bot_workers.h"
 #include "../game_model/road_engine/road_graph.h"
 
 namespace model {
 
+    // Path search expansions left for deferred bot plans in the current tick, shared by all sessions of a game.
+    // A plan starts only while the balance is positive; what it spends beyond the balance is a debt
+    // paid from the next tick, so on average planning costs no more than the per-tick budget.
+    class BotPlanBudget {
+    public:
+        // Start of a tick: unused expansions are not saved up, a debt is carried over
+        void Refill(size_t per_tick) noexcept {
+            balance_ = std::min<std::int64_t>(balance_, 0) + static_cast<std::int64_t>(per_tick);
+        }
+
+        [[nodiscard]] bool CanSearch() const noexcept { return balance_ > 0; }
+
+        [[nodiscard]] size_t Remaining() const noexcept {
+            return balance_ > 0 ? static_cast<size_t>(balance_) : 0;
+        }
+
+        void Spend(size_t expansions) noexcept {
+            balance_ -= static_cast<std::int64_t>(expansions);
+        }
+
+    private:
+        std::int64_t balance_ = 0;
+    };
+
+    struct BotOptions {
+        std::uint64_t seed = 0;             // base seed of bot random streams (0 - random seed)
+        BotWorkers* workers = nullptr;      // threads for parallel decisions (nullptr - decide on the calling thread)
+        size_t plan_budget = 0;             // path search expansions per tick (0 - every bot plans right away)
+    };
+
     class BotManager {
     public:
         // Construct with the map bots belong to
-        explicit BotManager(const Map* map);
+        explicit BotManager(const Map* map, BotOptions options = {});
 
-        // Create the initial set of bots (half of MAX_PLAYERS_ON_MAP)
+        // Seed and workers for bots created afterwards (call before CreateBots)
+        void SetOptions(BotOptions options);
+
+        // Create the initial set of bots (common_values::BOTS_PER_SESSION)
         void CreateBots();
 
         // Move all bots by the given time delta
@@ -27,9 +65,15 @@ namespace model {
         // Update bot directions based on random decisions - simple bot-AI
         void UpdateDirections();
 
-        // Update directions with world state and time delta - better bot-AI
+        // Update directions with world state and time delta - better bot-AI.
+        // Every bot decides independently (in parallel chunks when workers are set) from the same
+        // snapshot, then decisions are applied in bot id order - the result depends only on the seed.
+        // With a planning budget, bots needing a new path are queued and planned first-come first-served
+        // until shared_budget (the game's budget for this tick) is spent. Without shared_budget the manager
+        // refills a budget of its own with plan_budget every tick.
         void UpdateDirections(const BotWorldState& world_state,
-                              std::chrono::milliseconds time_delta);
+                              std::chrono::milliseconds time_delta,
+                              BotPlanBudget* shared_budget = nullptr);
 
         [[nodiscard]] const std::map<uint32_t, Dog>& GetBots() const noexcept { return bots_; }
 
@@ -38,16 +82,39 @@ namespace model {
         // Provide a vector of pointers to all bots (useful for collision processing).
         std::vector<Dog*> GetAllBotPointers();
 
+    private:
+        // Bot AI with its own random stream and the decision of the current tick
+        struct BotSlot {
+            uint32_t id;
+            Dog* dog;               // points into bots_ (std::map nodes never move)
+            BotAI ai;
+            BotRng rng;
+            BotDecision decision;
+            bool queued = false;    // waits in plan_queue_
+        };
 
+        // A decision may run A* path search, so even small chunks are worth a thread
+        static constexpr size_t MIN_BOTS_PER_CHUNK = 2;
 
-    private:
         const Map* map_;                    // map on which bots move
         std::map<uint32_t, Dog> bots_;      // All bot dogs
         uint32_t next_bot_id_ = common_values::DOG_BOT_START_ID;        // Start above real player IDs
-        std::mt19937 rng_;                  // Random generator for AI decisions
-        std::map<uint32_t, BotAI> bot_ais_;
+        std::uint64_t seed_;
+        BotWorkers* workers_;
+        size_t plan_budget_;
+        BotPlanBudget own_plan_budget_;     // used when UpdateDirections gets no shared budget
+        BotRng rng_;                        // Random generator for bot creation and simple AI (stream 0)
+        std::vector<BotSlot> slots_;        // in bot id order
+        LootClaims loot_claims_;            // loot piles targeted by bots, kept across ticks
+        std::deque<size_t> plan_queue_;     // slots waiting for path planning (plan_budget_ > 0)
         RoadGraph road_graph_;
 
+        void DecideChunk(size_t begin, size_t end, const BotWorldState& world_state,
+                         std::chrono::milliseconds time_delta);
+        void ApplyDecision(BotSlot& slot);
+        // Plans the oldest queued bot if the budget allows a search, returns false if nothing was planned
+        bool PlanNext(const BotWorldState& world_state, BotPlanBudget& budget);
+
         // Predefined directions for convenience
         static inline std::vector<app_geom::Direction2D> all_dirs_ = {
             app_geom::Direction2D::UP,
@@ -59,4 +126,4 @@ namespace model {
         static inline std::uniform_real_distribution<double> change_prob_dist_{0.0, common_values::DEFAULT_DOG_SPEED};
     };
 
-} // namespace model
\ No newline at end of file
+} // namespace model
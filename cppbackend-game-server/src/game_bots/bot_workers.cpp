@@ -0,0 +1,63 @@
+#include "bot_workers.h"
+
+#include <algorithm>
+#include <exception>
+#include <latch>
+#include <mutex>
+
+#include <boost/asio/post.hpp>
+
+namespace model {
+
+BotWorkers::BotWorkers(size_t threads)
+    : threads_(threads)
+    , pool_(std::max<size_t>(threads, 1))
+{}
+
+BotWorkers::~BotWorkers() {
+    pool_.join();
+}
+
+void BotWorkers::ParallelFor(size_t count, size_t min_chunk, const std::function<void(size_t, size_t)>& task) {
+    if (count == 0) return;
+
+    const size_t max_chunks = (count + std::max<size_t>(min_chunk, 1) - 1) / std::max<size_t>(min_chunk, 1);
+    const size_t chunks = std::min(threads_ + 1, max_chunks);
+    if (chunks <= 1) {
+        task(0, count);
+        return;
+    }
+
+    std::latch done{static_cast<std::ptrdiff_t>(chunks - 1)};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    auto run_chunk = [&](size_t chunk) {
+        const size_t begin = count * chunk / chunks;
+        const size_t end = count * (chunk + 1) / chunks;
+        try {
+            task(begin, end);
+        } catch (...) {
+            std::lock_guard lock{error_mutex};
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        boost::asio::post(pool_, [&, chunk] {
+            run_chunk(chunk);
+            done.count_down();
+        });
+    }
+    // The calling thread takes the first chunk
+    run_chunk(0);
+    done.wait();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace model
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include <boost/asio/thread_pool.hpp>
+
+namespace model {
+
+    // Worker threads shared by the BotManagers of all sessions.
+    // The calling thread takes part in the work, so `threads` is the number of extra threads.
+    class BotWorkers {
+    public:
+        explicit BotWorkers(size_t threads);
+        ~BotWorkers();
+
+        BotWorkers(const BotWorkers&) = delete;
+        BotWorkers& operator=(const BotWorkers&) = delete;
+
+        // Splits [0, count) into chunks of at least min_chunk items, runs task(begin, end) for every chunk
+        // and returns when all chunks are done. The first exception thrown by a chunk is rethrown here.
+        void ParallelFor(size_t count, size_t min_chunk, const std::function<void(size_t, size_t)>& task);
+
+        [[nodiscard]] size_t ThreadCount() const noexcept { return threads_; }
+
+    private:
+        size_t threads_;
+        boost::asio::thread_pool pool_;
+    };
+
+} // namespace model
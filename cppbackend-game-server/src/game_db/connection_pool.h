@@ -4,6 +4,8 @@
 #include <mutex>
 #include <pqxx/pqxx>
 
+#include "../common/metrics.h"
+
 namespace db {
 
     // Timeout for waiting to acquire a connection from the pool
@@ -85,6 +87,7 @@ namespace db {
                 }
                 pool_.emplace_back(connection_factory());       // Store it in the pool
             }
+            pool_metrics_.size.Set(static_cast<std::int64_t>(pool_.size()));
         }
 
         /**
@@ -97,6 +100,7 @@ namespace db {
          * @throws std::runtime_error if timeout occurs or the connection is invalid
          */
         ConnectionWrapper GetConnection() {
+            auto wait_start = std::chrono::steady_clock::now();
             std::unique_lock lock{mutex_};
 
             // First wait: block until at least one connection is free.
@@ -111,6 +115,7 @@ namespace db {
                     return used_connections_ < pool_.size();
                 }))
             {
+                pool_metrics_.timeouts.Inc();
                 throw std::runtime_error("ConnectionPool::GetConnection: Timeout waiting for a free connection");
             }
 
@@ -126,6 +131,8 @@ namespace db {
             }
 
             ++used_connections_;                // Mark as used
+            pool_metrics_.in_use.Set(static_cast<std::int64_t>(used_connections_));
+            pool_metrics_.wait.Observe(std::chrono::steady_clock::now() - wait_start);
             return {std::move(conn_ptr), *this}; // Return wrapper that owns the connection
         }
 
@@ -163,11 +170,25 @@ namespace db {
                 // we decrement used_connections_ and place the returned connection
                 // into the slot that is now free.
                 pool_[--used_connections_] = std::move(conn);
+                pool_metrics_.in_use.Set(static_cast<std::int64_t>(used_connections_));
             }
             // Notify one waiting thread that a connection has become available.
             cond_var_.notify_one();
         }
 
+        // Pool usage metrics (shared by all pools of the process)
+        struct PoolMetrics {
+            metrics::Gauge& size = metrics::Registry::Instance().GetGauge(
+                "db_pool_connections", "Connections managed by the DB pool");
+            metrics::Gauge& in_use = metrics::Registry::Instance().GetGauge(
+                "db_pool_connections_in_use", "DB pool connections currently borrowed");
+            metrics::Histogram& wait = metrics::Registry::Instance().GetHistogram(
+                "db_pool_wait_seconds", "Time to acquire a connection from the DB pool");
+            metrics::Counter& timeouts = metrics::Registry::Instance().GetCounter(
+                "db_pool_timeouts_total", "Connection requests that timed out");
+        };
+
+        PoolMetrics pool_metrics_;
         std::mutex mutex_;                    // Protects pool_ and used_connections_
         std::condition_variable cond_var_;    // Used for blocking and signalling
         std::vector<ConnectionPtr> pool_;      // The actual connection storage
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "../common/game_utils/geometry.h"
+
+namespace model {
+
+// Latest movement intent of one player's dog. Written from request threads, taken by the session tick.
+class ActionSlot {
+public:
+    explicit ActionSlot(std::uint32_t dog_id) noexcept
+        : dog_id_(dog_id)
+    {}
+
+    ActionSlot(const ActionSlot&) = delete;
+    ActionSlot& operator=(const ActionSlot&) = delete;
+
+    [[nodiscard]] std::uint32_t GetDogId() const noexcept {
+        return dog_id_;
+    }
+
+private:
+    friend class ActionInbox;
+
+    static constexpr std::uint8_t NO_INTENT = 0xFF;
+
+    std::uint32_t dog_id_;
+    std::atomic<std::uint8_t> intent_{NO_INTENT};
+    std::atomic<bool> queued_{false};
+};
+
+// Per-session inbox of movement intents: many writers (HTTP threads), one reader (the session tick).
+// Post overwrites the slot's intent - only the last action before a tick is applied - and links the slot
+// into a lock-free stack only on its first action since the last Drain, so a burst of actions costs one
+// small allocation. Stack nodes own the slot, so a player retired meanwhile is still safe to drain.
+class ActionInbox {
+public:
+    ActionInbox() = default;
+
+    ActionInbox(const ActionInbox&) = delete;
+    ActionInbox& operator=(const ActionInbox&) = delete;
+
+    // Only while the owning session is being set up (no concurrent Post)
+    ActionInbox(ActionInbox&& other) noexcept
+        : head_(other.head_.exchange(nullptr))
+    {}
+
+    ~ActionInbox() {
+        DeleteNodes(head_.exchange(nullptr));
+    }
+
+    // Lock-free, safe from any thread. false - the intent replaced one not applied yet (coalesced)
+    bool Post(const std::shared_ptr<ActionSlot>& slot, app_geom::Direction2D dir) {
+        // acq_rel on both sides of intent_ / queued_: either this Post sees queued_ cleared by Drain and links
+        // the slot again, or Drain's exchange of intent_ sees this intent - never neither (store buffering)
+        const auto previous = slot->intent_.exchange(static_cast<std::uint8_t>(dir), std::memory_order_acq_rel);
+        if (!slot->queued_.exchange(true, std::memory_order_acq_rel)) {
+            auto* node = new Node{slot, head_.load(std::memory_order_relaxed)};
+            while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+        return previous == ActionSlot::NO_INTENT;
+    }
+
+    // Calls apply(dog_id, direction) for every slot with a pending intent. Only from the session tick.
+    template <typename Apply>
+    void Drain(Apply&& apply) {
+        Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+        while (node) {
+            ActionSlot& slot = *node->slot;
+            // Cleared before the intent is taken: a Post racing with this queues the slot again.
+            // An exchange, not a store: reading the Post's queued_ orders its intent before the exchange below
+            slot.queued_.exchange(false, std::memory_order_acq_rel);
+            if (const auto intent = slot.intent_.exchange(ActionSlot::NO_INTENT, std::memory_order_acq_rel);
+                intent != ActionSlot::NO_INTENT) {
+                apply(slot.dog_id_, static_cast<app_geom::Direction2D>(intent));
+            }
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+private:
+    struct Node {
+        std::shared_ptr<ActionSlot> slot;
+        Node* next;
+    };
+
+    std::atomic<Node*> head_{nullptr};
+
+    static void DeleteNodes(Node* node) {
+        while (node) {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+};
+
+} // namespace model
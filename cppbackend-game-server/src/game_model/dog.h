@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>  // std::uint32_t
+#include <optional>
 
 #include "loot_storage.h"
 #include "../common/utils.h"
@@ -91,16 +92,13 @@ namespace model {
             return road_to_move_;
         }
 
-        [[nodiscard]] std::chrono::milliseconds GetIdleTime() const noexcept {
-            return idle_time_;
+        // Retirement time on the GameSession clock while the dog stands still, nullopt while it moves
+        [[nodiscard]] std::optional<std::chrono::milliseconds> GetRetirementDeadline() const noexcept {
+            return retirement_deadline_;
         }
 
-        void UpdateIdleTime(std::chrono::milliseconds time_delta_ms) {
-            idle_time_ += time_delta_ms;
-        }
-
-        void ResetIdleTime() {
-            idle_time_ = std::chrono::milliseconds(0);
+        void SetRetirementDeadline(std::optional<std::chrono::milliseconds> deadline) noexcept {
+            retirement_deadline_ = deadline;
         }
 
     private:
@@ -113,7 +111,7 @@ namespace model {
         app_geom::Direction2D dir_{app_geom::Direction2D::UP};
         Bag bag_{};
         loot::Score score_{0};
-        std::chrono::milliseconds idle_time_{0};
+        std::optional<std::chrono::milliseconds> retirement_deadline_;
     };
 
 } // namespace model
\ No newline at end of file
@@ -70,11 +70,41 @@ namespace extra_data {
             return dog_retirement_time_;
         }
 
+        // Players per GameSession; the next join on a full session opens a new one
+        void SetMaxPlayersPerSession(size_t max_players) {
+            max_players_per_session_ = max_players;
+        }
+
+        size_t GetMaxPlayersPerSession() const {
+            return max_players_per_session_;
+        }
+
+        // Radius around a player's dog for /game/state (dogs and loot); 0 - the whole session
+        void SetInterestRadius(double radius) {
+            interest_radius_ = radius;
+        }
+
+        double GetInterestRadius() const {
+            return interest_radius_;
+        }
+
+        // How long a GameSession without players keeps ticking before it hibernates
+        void SetSessionIdleTime(std::chrono::seconds time) {
+            session_idle_time_ = time;
+        }
+
+        std::chrono::seconds GetSessionIdleTime() const {
+            return session_idle_time_;
+        }
+
     private:
         MapsSpeed maps_speed_;
         MapsBagCapacity maps_bag_capacity_;
         LootGeneratorConfig loot_generator_config_;
         std::chrono::seconds dog_retirement_time_{common_values::DEFAULT_DOG_RETIREMENT_TIME_SEC};
+        size_t max_players_per_session_ = common_values::DEFAULT_MAX_PLAYERS_PER_SESSION;
+        double interest_radius_ = common_values::DEFAULT_INTEREST_RADIUS;
+        std::chrono::seconds session_idle_time_{common_values::DEFAULT_SESSION_IDLE_TIME_SEC};
 
         std::unordered_map<model::Map::Id, std::vector<LootData>, util::TaggedHasher<model::Map::Id>> loots_for_map_;
     };
@@ -115,13 +115,18 @@ public:
                            default_bag_capacity_ : throw std::runtime_error("Default capacity is Zero."); }
 
     [[nodiscard]] app_geom::Position2D GetRandomPoint() const {
-        if (roads_.empty()) {
-            throw std::runtime_error("No roads on map to generate random point");
-        }
-
         // Random device and generator (static to avoid re-seeding on every call)
         static std::random_device rd;
         static std::mt19937 gen(rd());
+        return GetRandomPoint(gen);
+    }
+
+    // Random point drawn from the caller's generator (reproducible for a seeded generator)
+    template <typename Generator>
+    [[nodiscard]] app_geom::Position2D GetRandomPoint(Generator& gen) const {
+        if (roads_.empty()) {
+            throw std::runtime_error("No roads on map to generate random point");
+        }
 
         // Choose a random road
         std::uniform_int_distribution<size_t> road_dist(0, roads_.size() - 1);
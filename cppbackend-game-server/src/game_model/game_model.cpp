@@ -3,9 +3,16 @@
 #include <ranges>
 #include <stdexcept>
 
+#include "../common/metrics.h"
+
 namespace model {
 using namespace std::literals;
 
+namespace {
+// Placement heaps smaller than this are never compacted
+constexpr size_t MIN_SESSION_LOADS_TO_COMPACT = 8;
+} // namespace
+
 void Map::AddOffice(Office office) {
     if (warehouse_id_to_index_.contains(office.GetId())) {
         throw std::invalid_argument("Duplicate warehouse");
@@ -69,9 +76,89 @@ const GameSession* Game::FindGameSession(const GameSession::Id &session_id) cons
 }
 
 void Game::UpdateAllGameSessions(std::chrono::milliseconds time_delta_ms) {
-    for (auto &session: session_id_to_value_ | std::views::values) {
-        session.UpdateGameState(time_delta_ms);
+    static auto& sessions_hibernated = metrics::Registry::Instance().GetCounter(
+        "game_sessions_hibernated_total", "Game sessions put to sleep after staying without players");
+    static auto& sessions_awake = metrics::Registry::Instance().GetGauge(
+        "game_sessions_awake", "Game sessions ticked by the game loop (active or idle)");
+
+    // One bot planning budget for the whole tick: sessions spend it in turn, without a per-session share.
+    // The first session to plan rotates, so the budget running out always hits different sessions.
+    BotPlanBudget* plan_budget = nullptr;
+    if (bot_options_.plan_budget > 0) {
+        bot_plan_budget_.Refill(bot_options_.plan_budget);
+        plan_budget = &bot_plan_budget_;
+    }
+    const size_t session_count = awake_sessions_.size();
+    const size_t first = session_count > 0 ? first_planning_session_++ % session_count : 0;
+
+    // Hibernated sessions are not in the list - tick cost follows populated sessions only
+    bool any_hibernated = false;
+    for (size_t i = 0; i < session_count; ++i) {
+        GameSession* session = awake_sessions_[(first + i) % session_count];
+        const size_t players_before = session->GetDogs().size();
+        session->UpdateGameState(time_delta_ms, plan_budget);
+
+        // Only retirement removes players - the session gets emptier, tell the placement heap
+        if (const size_t players = session->GetDogs().size(); players < players_before) {
+            const auto& map_id = session->GetMap()->GetId();
+            session_loads_[map_id].emplace(players, *session->GetId());
+            CompactSessionLoads(map_id);
+        }
+        if (session->UpdateLifecycle(time_delta_ms)) {
+            sessions_hibernated.Inc();
+            any_hibernated = true;
+        }
+    }
+    if (any_hibernated) {
+        std::erase_if(awake_sessions_, [](const GameSession* session) {
+            return session->GetLifecycle() == GameSession::Lifecycle::HIBERNATED;
+        });
+    }
+    sessions_awake.Set(static_cast<std::int64_t>(awake_sessions_.size()));
+}
+
+void Game::WakeForPlacement(GameSession& session) {
+    if (session.GetLifecycle() == GameSession::Lifecycle::HIBERNATED) {
+        awake_sessions_.push_back(&session);
+    }
+    session.Wake();
+}
+
+GameSession* Game::FindSessionForPlacement(const Map::Id& map_id) {
+    auto loads_it = session_loads_.find(map_id);
+    if (loads_it == session_loads_.end()) {
+        return nullptr;
+    }
+    auto& loads = loads_it->second;
+    const size_t max_players = game_extra_data_->GetMaxPlayersPerSession();
+    while (!loads.empty()) {
+        const auto [players, id] = loads.top();
+        GameSession* session = FindGameSession(GameSession::Id{id});
+        if (const size_t current = session->GetDogs().size(); current != players) {
+            loads.pop();                            // players joined since the entry was pushed
+            loads.emplace(current, id);
+            continue;
+        }
+        // The top is up to date, so every other session has at least as many players
+        return players < max_players ? session : nullptr;
     }
+    return nullptr;
+}
+
+void Game::CompactSessionLoads(const Map::Id& map_id) {
+    auto& loads = session_loads_[map_id];
+    // Sessions of all maps bound the live entries of this one, so the check is O(1) and a rebuild
+    // happens only after at least as many pushes as there are sessions
+    if (loads.size() <= 2 * session_id_to_value_.size() + MIN_SESSION_LOADS_TO_COMPACT) {
+        return;
+    }
+    std::vector<SessionLoad> current;
+    for (const auto& session : session_id_to_value_ | std::views::values) {
+        if (session.GetMap()->GetId() == map_id) {
+            current.emplace_back(session.GetDogs().size(), *session.GetId());
+        }
+    }
+    loads = SessionLoadHeap{std::greater<>{}, std::move(current)};
 }
 
 void Game::AddRestoredSession(model::GameSession &&session) {
@@ -87,10 +174,12 @@ void Game::AddRestoredSession(model::GameSession &&session) {
     // Insert the session into the main container
     session_id_to_value_.emplace(id, std::move(session));
 
-    // Update the map from map ID to sessions (for quick lookup)
+    // Make the session available for placement of new players
     auto added_session_ptr = &session_id_to_value_.at(id);
     auto map_ptr = added_session_ptr->GetMap();  // get map pointer from inserted session
-    map_id_to_session_[map_ptr->GetId()].push_back(added_session_ptr);
+    session_loads_[map_ptr->GetId()].emplace(added_session_ptr->GetDogs().size(), *id);
+    CompactSessionLoads(map_ptr->GetId());
+    awake_sessions_.push_back(added_session_ptr);
 
     // Update the session ID counter to avoid collisions with future new sessions
     if (*id >= next_session_id_) {
@@ -99,10 +188,9 @@ void Game::AddRestoredSession(model::GameSession &&session) {
 }
 
 std::pair<GameSession::Id, bool /*created*/> Game::RequestGameSession(const Map::Id &map_id, boost::asio::io_context &ioc) {
-    if (const auto& session_it = map_id_to_session_.find(map_id);
-        session_it != map_id_to_session_.end()
-        && session_it->second.back()->GetDogs().size() < MAX_PLAYERS_ON_MAP) {
-        return {session_it->second.back()->GetId(), false};
+    if (GameSession* session = FindSessionForPlacement(map_id)) {
+        WakeForPlacement(*session);
+        return {session->GetId(), false};
     }
 
     GameSession::Id session_tagg_id = GameSession::Id{next_session_id_++};
@@ -113,13 +201,19 @@ std::pair<GameSession::Id, bool /*created*/> Game::RequestGameSession(const Map:
                                         ioc, loot_generator_, game_extra_data_, enable_retirement_};
         session_id_to_value_.emplace(new_session.GetId(), std::move(new_session));
 
-        // fill GameSession map index
+        // available for placement, then drop stale entries if they piled up
         auto new_session_ptr = &session_id_to_value_.at(session_tagg_id);
-        map_id_to_session_[map_id].emplace_back(new_session_ptr);
+        session_loads_[map_id].emplace(0, *session_tagg_id);
+        CompactSessionLoads(map_id);
+        awake_sessions_.push_back(new_session_ptr);
+
+        if (loot_seed_ != 0) {
+            new_session_ptr->SeedLoot(loot_seed_);
+        }
 
         // create bots if enabled
         if (create_bots_) {
-            new_session_ptr->CreateBots();
+            new_session_ptr->CreateBots(bot_options_);
         }
 
         return {new_session_ptr->GetId(), true};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <queue>
+
 #include "game_extra_data.h"
 #include "game_session.h"
 #include "game_map.h"
@@ -13,7 +15,10 @@ public:
     using MapIdToIndex = std::unordered_map<Map::Id, size_t, MapIdHasher>;
     using GameSessionIdHasher = util::TaggedHasher<GameSession::Id>;
     using GameSessionIdToValue = std::unordered_map<GameSession::Id, GameSession, GameSessionIdHasher>;
-    using MapIdToGameSession = std::unordered_map<Map::Id, std::vector<const GameSession*>, MapIdHasher>;
+    // (real players, session id) - ordered by occupancy, then by id
+    using SessionLoad = std::pair<std::size_t, std::uint32_t>;
+    using SessionLoadHeap = std::priority_queue<SessionLoad, std::vector<SessionLoad>, std::greater<>>;
+    using MapIdToSessionLoads = std::unordered_map<Map::Id, SessionLoadHeap, MapIdHasher>;
 
     Game(std::shared_ptr<extra_data::GameExtraData> game_extra_data)
         : game_extra_data_(std::move(game_extra_data))
@@ -42,19 +47,33 @@ public:
         return game_extra_data_;
     }
 
-    // Finds GameSession for selected Map, creates new GameSession if needed
+    // Finds GameSession for selected Map - the emptiest one that is not full, woken up if hibernated -
+    // creates new GameSession if all are full
     [[nodiscard]] std::pair<GameSession::Id, bool /*new_created*/> RequestGameSession(const Map::Id &map_id, boost::asio::io_context& ioc);
 
     GameSession* FindGameSession(const GameSession::Id& session_id);
 
     const GameSession* FindGameSession(const GameSession::Id& session_id) const;
 
+    // Ticks active and idle sessions and moves their lifecycle on; hibernated sessions are skipped
+    // (see GameSession::Lifecycle) until RequestGameSession places a player into them
     void UpdateAllGameSessions(std::chrono::milliseconds time_delta_ms);
 
     void SetCreateBots(bool enable) {
         create_bots_ = enable;
     }
 
+    // Seed and worker threads for bots of new sessions.
+    // plan_budget is per game tick, shared by the bots of all sessions.
+    void SetBotOptions(BotOptions options) {
+        bot_options_ = options;
+    }
+
+    // Base seed of loot placement in new sessions (0 - random)
+    void SetLootSeed(std::uint64_t seed) {
+        loot_seed_ = seed;
+    }
+
     std::shared_ptr<loot_gen::LootGenerator> GetLootGenerator() {
         return loot_generator_;
     }
@@ -65,6 +84,12 @@ public:
 
     void AddRestoredSession(model::GameSession&& session);
 
+    // Entries of the map's placement heap, stale ones included (bounded by compaction)
+    [[nodiscard]] size_t GetSessionLoadEntries(const Map::Id& map_id) const {
+        auto it = session_loads_.find(map_id);
+        return it == session_loads_.end() ? 0 : it->second.size();
+    }
+
     // Enable or disable dog retirement due to idle timeout.
     // When disabled, dogs will never be retired, and players persist indefinitely.
     void SetEnableRetirement(bool enable) {
@@ -88,16 +113,31 @@ private:
     std::uint32_t next_session_id_ = 1;
     GameSessionIdToValue session_id_to_value_;
 
-    // GameSession to Map index
-    MapIdToGameSession map_id_to_session_;
+    // Per-map min-heap of sessions by occupancy for placement of new players.
+    // Updated lazily: joins make entries stale-low (re-keyed when they reach the top),
+    // retirements push a fresh entry after the tick. Every push may compact the heap (CompactSessionLoads).
+    MapIdToSessionLoads session_loads_;
+    // Sessions ticked by UpdateAllGameSessions (not hibernated), pointers into session_id_to_value_
+    std::vector<GameSession*> awake_sessions_;
 
     // LootGenerator for Loot processing
     std::shared_ptr<loot_gen::LootGenerator> loot_generator_ = nullptr;
 
     // if bots needed
     bool create_bots_ = false;
+    BotOptions bot_options_;
+    BotPlanBudget bot_plan_budget_;         // refilled with bot_options_.plan_budget every tick
+    size_t first_planning_session_ = 0;     // sessions take turns to plan first, so none starves
+    std::uint64_t loot_seed_ = 0;
     // if remote database (enabled by default) used - retirement also used
     bool enable_retirement_ = true;   // enabled by default
+
+    // Emptiest not full session of the map, nullptr if there is none
+    GameSession* FindSessionForPlacement(const Map::Id& map_id);
+    // Puts a hibernated session back on the tick list
+    void WakeForPlacement(GameSession& session);
+    // Drops stale and duplicate entries once the heap grows well beyond the number of sessions
+    void CompactSessionLoads(const Map::Id& map_id);
 };
 
 }  // namespace model
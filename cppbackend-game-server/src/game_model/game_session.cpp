@@ -1,7 +1,36 @@
 #include "game_session.h"
 
+#include <algorithm>
+
+#include "../common/metrics.h"
+
 namespace model {
 
+    namespace {
+        // Per-phase duration of GameSession::UpdateGameState (all sessions share the histograms)
+        struct UpdatePhaseMetrics {
+            metrics::Histogram& retirement;
+            metrics::Histogram& move;
+            metrics::Histogram& bots;
+            metrics::Histogram& loot_generation;
+            metrics::Histogram& collisions;
+        };
+
+        UpdatePhaseMetrics& PhaseMetrics() {
+            static constexpr std::string_view NAME = "game_session_update_phase_seconds";
+            static constexpr std::string_view HELP = "Duration of GameSession::UpdateGameState phases";
+            auto& registry = metrics::Registry::Instance();
+            static UpdatePhaseMetrics phase_metrics{
+                registry.GetHistogram(NAME, HELP, R"(phase="retirement")"),
+                registry.GetHistogram(NAME, HELP, R"(phase="move")"),
+                registry.GetHistogram(NAME, HELP, R"(phase="bots")"),
+                registry.GetHistogram(NAME, HELP, R"(phase="loot_generation")"),
+                registry.GetHistogram(NAME, HELP, R"(phase="collisions")"),
+            };
+            return phase_metrics;
+        }
+    } // namespace
+
     Dog* GameSession::RequestDog(std::uint32_t dog_id, std::string_view dog_name, bool restored) {
         if (auto dog_it = dogs_.find(dog_id); dog_it != dogs_.end()) {
             if (restored) {
@@ -19,8 +48,38 @@ namespace model {
             }
         }
         auto new_dog = Dog{dog_id, std::string(dog_name), map_};
-        dogs_.emplace(dog_id, std::move(new_dog));
-        return &dogs_.at(dog_id);
+        Dog& dog = dogs_.emplace(dog_id, std::move(new_dog)).first->second;
+        world_index_dirty_ = true;
+        // A new dog stands still until its player moves it
+        StartRetirementCountdown(dog, retirement_clock_);
+        return &dog;
+    }
+
+    void GameSession::AddRestoredDog(model::Dog&& dog) {
+        Dog& restored = dogs_.emplace(dog.GetId(), std::move(dog)).first->second;
+        world_index_dirty_ = true;
+        if (restored.GetSpeed() == app_geom::Speed2D::Zero()) {
+            StartRetirementCountdown(restored, retirement_clock_);
+        }
+    }
+
+    void GameSession::PostDogDirection(const std::shared_ptr<ActionSlot>& slot, app_geom::Direction2D dir) {
+        static auto& coalesced = metrics::Registry::Instance().GetCounter(
+            "player_actions_coalesced_total", "Player actions replaced by a later one before the tick applied them");
+        if (!action_inbox_.Post(slot, dir)) {
+            coalesced.Inc();
+        }
+    }
+
+    void GameSession::SetDogDirection(Dog& dog, app_geom::Direction2D dir) {
+        const bool was_moving = dog.GetSpeed() != app_geom::Speed2D::Zero();
+        dog.SetDirection(dir);
+        const bool is_moving = dog.GetSpeed() != app_geom::Speed2D::Zero();
+        if (is_moving) {
+            dog.SetRetirementDeadline(std::nullopt);   // the wheel entry goes stale
+        } else if (was_moving) {
+            StartRetirementCountdown(dog, retirement_clock_);
+        }
     }
 
     Dog * GameSession::FindDog(std::uint32_t dog_id) noexcept {
@@ -37,50 +96,132 @@ namespace model {
         return nullptr;
     }
 
-    void GameSession::UpdateDogsIdleTime(std::chrono::milliseconds time_delta_ms) {
-        std::vector<std::uint32_t> dogs_to_delete;
-        for (auto& [id, dog] : dogs_) {
-            if (dog.GetSpeed() == app_geom::Speed2D::Zero()) {
-                dog.UpdateIdleTime(time_delta_ms);
-                if (dog.GetIdleTime() >= game_extra_data_.get()->GetDogRetirementTime()) {
-                    dogs_to_delete.emplace_back(id);
-                }
-            } else {
-                dog.ResetIdleTime();
+    void GameSession::StartRetirementCountdown(Dog& dog, std::chrono::milliseconds since) {
+        if (!enable_retirement_) {
+            return;
+        }
+        const auto deadline = since + std::chrono::milliseconds(game_extra_data_->GetDogRetirementTime());
+        dog.SetRetirementDeadline(deadline);
+        retirement_wheel_.Schedule(static_cast<std::uint64_t>(deadline.count()), dog.GetId());
+    }
+
+    void GameSession::RetireIdleDogs(std::chrono::milliseconds time_delta_ms) {
+        retirement_clock_ += time_delta_ms;
+        expired_dogs_.clear();
+        retirement_wheel_.Advance(static_cast<std::uint64_t>(retirement_clock_.count()), expired_dogs_);
+        if (expired_dogs_.empty()) {
+            return;
+        }
+
+        // Retire in id order, as a scan over dogs_ would; skip stale entries of dogs that moved or left
+        std::ranges::sort(expired_dogs_);
+        const auto [first, last] = std::ranges::unique(expired_dogs_);
+        expired_dogs_.erase(first, last);
+        std::erase_if(expired_dogs_, [this](std::uint32_t id) {
+            const Dog* dog = FindDog(id);
+            if (!dog) {
+                return true;
             }
+            const auto deadline = dog->GetRetirementDeadline();
+            return !deadline || *deadline > retirement_clock_ || dog->GetSpeed() != app_geom::Speed2D::Zero();
+        });
+        if (expired_dogs_.empty()) {
+            return;
+        }
+
+        std::vector<RetiredDog> retired;
+        retired.reserve(expired_dogs_.size());
+        for (const auto id : expired_dogs_) {
+            Dog& dog = dogs_.at(id);
+            ReleaseRetiredBag(&dog);
+            retired.push_back({id, dog.GetScore()});
+        }
+        // One signal for the whole batch, dogs are still in the session while it is handled
+        on_dog_deleted_(std::span<const RetiredDog>(retired));
+
+        for (const auto id : expired_dogs_) {
+            dogs_.erase(id);
+        }
+        world_index_dirty_ = true;
+    }
+
+    bool GameSession::UpdateLifecycle(std::chrono::milliseconds time_delta_ms) {
+        if (!dogs_.empty()) {
+            Wake();
+            return false;
+        }
+        if (lifecycle_ == Lifecycle::ACTIVE) {
+            lifecycle_ = Lifecycle::IDLE;
         }
-        // if any Dog to retire exists
-        for (auto id : dogs_to_delete) {
-            RetireDog(id);
+        empty_time_ += time_delta_ms;
+        if (lifecycle_ == Lifecycle::IDLE && empty_time_ >= game_extra_data_->GetSessionIdleTime()) {
+            Hibernate();
+            return true;
         }
+        return false;
+    }
+
+    void GameSession::Hibernate() {
+        lifecycle_ = Lifecycle::HIBERNATED;
+        bot_world_state_ = {};
+        dog_grid_ = {};
+        collision_grid_ = {};
+        world_index_dirty_ = true;
     }
 
-    BotWorldState GameSession::BuildBotWorldState() const {
-        std::vector<app_geom::Position2D> loot_positions;
+    const BotWorldState& GameSession::BuildBotWorldState() const {
+        if (!world_index_dirty_) {
+            return bot_world_state_;
+        }
+        world_index_dirty_ = false;
+
+        // Loot changes every tick - rebuild its index once, all bots and interest queries share it
+        auto& loot_grid = bot_world_state_.loot;
+        loot_grid.Clear();
         for (const auto& loot : loot_storage_.GetLootObjects() | std::views::values) {
             if (!loot.collected) {
-                loot_positions.push_back(loot.pos);
+                loot_grid.Add(loot.object_id, loot.pos);
             }
         }
-        std::vector<app_geom::Position2D> office_positions;
-        for (const auto& office : map_->GetOffices()) {
-            office_positions.push_back(utils::Point2DToPosition2D(office.GetPosition()));
-        }
-        return {std::move(loot_positions), std::move(office_positions)};
-    }
+        loot_grid.Build();
 
-    void GameSession::RetireDog(std::uint32_t dog_id) {
-        auto dog_it = dogs_.find(dog_id);
-        if (dog_it == dogs_.end()) {
-            std::string error_msg = "Dog not found while riterement process";
-            boost_logger::LogError(EXIT_FAILURE, error_msg, "GameSession::RetireDog");
-            throw std::runtime_error(error_msg);
+        // Offices never move - index them once
+        auto& office_grid = bot_world_state_.offices;
+        if (office_grid.Empty()) {
+            const auto& offices = map_->GetOffices();
+            for (size_t i = 0; i < offices.size(); ++i) {
+                office_grid.Add(static_cast<std::uint32_t>(i), utils::Point2DToPosition2D(offices[i].GetPosition()));
+            }
+            office_grid.Build();
         }
-        ReleaseRetiredBag(&dog_it->second);
 
-        on_dog_deleted_(dog_id, dog_it->second.GetScore());
+        dog_grid_.Clear();
+        for (const auto& [id, dog] : dogs_) {
+            dog_grid_.Add(id, dog.GetPosition());
+        }
+        for (const auto& [id, bot] : bot_manager_.GetBots()) {
+            dog_grid_.Add(id, bot.GetPosition());
+        }
+        dog_grid_.Build();
+        return bot_world_state_;
+    }
 
-        dogs_.erase(dog_id);
+    GameSession::InterestSet GameSession::GetInterestSet(app_geom::Position2D center, double radius) const {
+        const auto& world = BuildBotWorldState();
+        InterestSet result;
+        dog_grid_.ForEachInRadius(center, radius, [&](const spatial::Item& item) {
+            if (const Dog* dog = FindDog(item.id)) {
+                result.dogs.push_back(dog);
+            } else if (auto bot_it = GetBots().find(item.id); bot_it != GetBots().end()) {
+                result.dogs.push_back(&bot_it->second);
+            }
+        });
+        world.loot.ForEachInRadius(center, radius, [&](const spatial::Item& item) {
+            result.loot.push_back(loot_storage_.FindLootByID(static_cast<int>(item.id)));
+        });
+        std::ranges::sort(result.dogs, {}, &Dog::GetId);
+        std::ranges::sort(result.loot, {}, &loot::LootObject::object_id);
+        return result;
     }
 
     void GameSession::ReleaseRetiredBag(Dog* dog) {
@@ -91,52 +232,81 @@ namespace model {
         }
     }
 
-    void GameSession::UpdateGameState(std::chrono::milliseconds time_delta_ms) {
-        // 0. Check if any Dog retired - only if retirement enabled
+    void GameSession::UpdateGameState(std::chrono::milliseconds time_delta_ms, BotPlanBudget* bot_plan_budget) {
+        auto& phase_metrics = PhaseMetrics();
+
+        // 0a. Last posted action of each player (a dog retired meanwhile is gone)
+        action_inbox_.Drain([this](std::uint32_t dog_id, app_geom::Direction2D dir) {
+            if (Dog* dog = FindDog(dog_id)) {
+                SetDogDirection(*dog, dir);
+            }
+        });
+
+        // 0b. Check if any Dog retired - only if retirement enabled
         if (enable_retirement_) {
-            UpdateDogsIdleTime(time_delta_ms);
+            metrics::ScopedTimer timer(phase_metrics.retirement);
+            RetireIdleDogs(time_delta_ms);
         }
 
+        // Everything below moves dogs or changes loot
+        world_index_dirty_ = true;
+
         // 1a. Record start positions and dog pointers
         std::vector<app_geom::Position2D> start_positions;
         std::vector<Dog*> dog_ptrs;
-        for (auto &dog: dogs_ | std::views::values) {
-            start_positions.push_back(dog.GetPosition());
-            dog_ptrs.push_back(&dog);
-        }
-        // 1b. same for bots (if any exist)
-        if (bot_manager_.GetBotCount() > 0) {
-            for (auto bot : bot_manager_.GetAllBotPointers()) {
-                start_positions.push_back(bot->GetPosition());
-                dog_ptrs.push_back(bot);
+        {
+            metrics::ScopedTimer timer(phase_metrics.move);
+            for (auto &dog: dogs_ | std::views::values) {
+                start_positions.push_back(dog.GetPosition());
+                dog_ptrs.push_back(&dog);
+            }
+            // 1b. same for bots (if any exist)
+            if (bot_manager_.GetBotCount() > 0) {
+                for (auto bot : bot_manager_.GetAllBotPointers()) {
+                    start_positions.push_back(bot->GetPosition());
+                    dog_ptrs.push_back(bot);
+                }
             }
-        }
 
-        // 2a. Move all dogs & bots
-        for (const auto dog : dog_ptrs) {
-            dog->Move(time_delta_ms);
+            // 2a. Move all dogs & bots. A player's dog stopped at a road end starts its retirement countdown
+            const size_t player_dogs = dogs_.size();
+            for (size_t i = 0; i < dog_ptrs.size(); ++i) {
+                Dog* dog = dog_ptrs[i];
+                const bool was_moving = dog->GetSpeed() != app_geom::Speed2D::Zero();
+                dog->Move(time_delta_ms);
+                if (i < player_dogs && was_moving && dog->GetSpeed() == app_geom::Speed2D::Zero()) {
+                    StartRetirementCountdown(*dog, retirement_clock_);
+                }
+            }
         }
         // 2b. Update bots direction (if any exist) with world state
         if (bot_manager_.GetBotCount() > 0) {
-            bot_manager_.UpdateDirections(BuildBotWorldState(), time_delta_ms);
+            metrics::ScopedTimer timer(phase_metrics.bots);
+            bot_manager_.UpdateDirections(BuildBotWorldState(), time_delta_ms, bot_plan_budget);
         }
 
         // 3. Generate new loot
-        auto new_loot_count = loot_generator_->Generate
-            (
-                time_delta_ms, loot_storage_.GetLootObjects().size(),
-                dogs_.size() + bot_manager_.GetBotCount()
-            );
-        if (new_loot_count > 0) {
-            loot_storage_.GenerateLoots(
-                new_loot_count,
-                map_->GetRoads(),
-                game_extra_data_->GetLootTypes(map_->GetId())
-            );
+        {
+            metrics::ScopedTimer timer(phase_metrics.loot_generation);
+            auto new_loot_count = loot_generator_->Generate
+                (
+                    time_delta_ms, loot_storage_.GetLootObjects().size(),
+                    dogs_.size() + bot_manager_.GetBotCount()
+                );
+            if (new_loot_count > 0) {
+                loot_storage_.GenerateLoots(
+                    new_loot_count,
+                    map_->GetRoads(),
+                    game_extra_data_->GetLootTypes(map_->GetId())
+                );
+                world_index_dirty_ = true;
+            }
         }
 
         // 4. Process collisions (loot and offices)
+        metrics::ScopedTimer timer(phase_metrics.collisions);
         ProcessCollisions(time_delta_ms, start_positions, dog_ptrs);
+        world_index_dirty_ = true;
     }
 
     const std::map<int, const loot::LootObject *> GameSession::GetLootNotCollected() const {
@@ -185,8 +355,8 @@ namespace model {
             });
         }
 
-        // Find events (already sorted by time)
-        auto events = collision_detector::FindGatherEvents(provider);
+        // Find events (already sorted by time); only items near each dog's path are tested
+        auto events = collision_detector::FindGatherEvents(provider, collision_grid_);
 
         for (const auto& event : events) {
             size_t gatherer_idx = event.gatherer_id;
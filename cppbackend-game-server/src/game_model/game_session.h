@@ -2,24 +2,41 @@
 
 #include <map>
 #include <ranges>
+#include <span>
 #include <string>
 #include <boost/signals2.hpp>
 
+#include "action_inbox.h"
 #include "dog.h"
 #include "game_map.h"
 #include "../common/game_utils/collision_detector.h"
 #include "../common/game_utils/loot_generator.h"
+#include "../common/game_utils/spatial_grid.h"
+#include "../common/game_utils/timing_wheel.h"
 #include "../common/tagged.h"
 #include "../game_bots/bot_manager.h"
 
 namespace model {
 
-    constexpr static inline size_t MAX_PLAYERS_ON_MAP = common_values::MAX_PLAYERS_ON_MAP;
-
 class GameSession {
 public:
     using Id = util::Tagged<std::uint32_t, GameSession>;
-    using DogDeletedSignal =  boost::signals2::signal<void(uint32_t dog_id, uint32_t dog_score)>;
+    struct RetiredDog {
+        std::uint32_t id;
+        loot::Score score;
+    };
+    // All dogs retired in one tick, ordered by id; emitted before they are removed from the session
+    using DogDeletedSignal = boost::signals2::signal<void(std::span<const RetiredDog> dogs)>;
+
+    // ACTIVE - has players; IDLE - no players, still ticked for sessionIdleTime;
+    // HIBERNATED - not ticked (bots and loot frozen) until the next player joins
+    enum class Lifecycle { ACTIVE, IDLE, HIBERNATED };
+
+    // Dogs (players and bots) and not collected loot around a point, each sorted by id
+    struct InterestSet {
+        std::vector<const Dog*> dogs;
+        std::vector<const loot::LootObject*> loot;
+    };
 
     GameSession(Id id, std::string name, const Map* map,
                 boost::asio::io_context &ioc,
@@ -53,9 +70,15 @@ public:
     // Creates new Dog if needed
     [[nodiscard]] Dog* RequestDog(std::uint32_t dog_id, std::string_view dog_name, bool restored = false);
 
-    void AddRestoredDog(model::Dog&& dog) {
-        dogs_.emplace(dog.GetId(), std::move(dog));
-    }
+    void AddRestoredDog(model::Dog&& dog);
+
+    // Player's direction change - starts or cancels the dog's retirement countdown.
+    // Speed of player dogs is changed only here and by Dog::Move inside UpdateGameState
+    void SetDogDirection(Dog& dog, app_geom::Direction2D dir);
+
+    // Player's direction change from any thread: the last one posted before a tick is applied
+    // (through SetDogDirection) at the start of that tick
+    void PostDogDirection(const std::shared_ptr<ActionSlot>& slot, app_geom::Direction2D dir);
 
     [[nodiscard]] const Map* GetMap() const noexcept {
         return map_;
@@ -69,7 +92,22 @@ public:
         return dogs_;
     }
 
-    void UpdateGameState(std::chrono::milliseconds time_delta_ms);
+    // bot_plan_budget - the game's budget for deferred bot plans in this tick (nullptr - the session's own)
+    void UpdateGameState(std::chrono::milliseconds time_delta_ms, BotPlanBudget* bot_plan_budget = nullptr);
+
+    [[nodiscard]] Lifecycle GetLifecycle() const noexcept {
+        return lifecycle_;
+    }
+
+    // Called after UpdateGameState: ACTIVE <-> IDLE by player count, IDLE -> HIBERNATED after sessionIdleTime.
+    // Returns true if the session has just hibernated
+    bool UpdateLifecycle(std::chrono::milliseconds time_delta_ms);
+
+    // HIBERNATED/IDLE -> ACTIVE, a player is about to join
+    void Wake() noexcept {
+        lifecycle_ = Lifecycle::ACTIVE;
+        empty_time_ = {};
+    }
 
     http_server::Strand& GetStrand() noexcept {
         return strand_;
@@ -79,12 +117,17 @@ public:
         return loot_storage_;
     }
 
+    // Non-const access may change loot (e.g. restore) - the world index is rebuilt on next use
     [[nodiscard]] loot::LootStorage& GetLootStorage() {
+        world_index_dirty_ = true;
         return loot_storage_;
     }
 
     [[nodiscard]] const std::map<int, const loot::LootObject*> GetLootNotCollected() const;
 
+    // Area of interest: dogs and loot within radius of center, found on the world index grid
+    [[nodiscard]] InterestSet GetInterestSet(app_geom::Position2D center, double radius) const;
+
     [[nodiscard]] loot::LootObject* FindLootByID(int loot_object_id) {
         return loot_storage_.FindLootByID(loot_object_id);
     }
@@ -93,7 +136,17 @@ public:
         return loot_storage_.FindLootByID(loot_object_id);
     }
 
-    void CreateBots() {
+    // Seeds loot placement, a distinct stream per session for the same base seed
+    void SeedLoot(std::uint64_t seed) {
+        loot_storage_.Seed(seed ^ std::uint64_t{*id_} * 0x9E3779B97F4A7C15ull);
+    }
+
+    void CreateBots(BotOptions options = {}) {
+        // Distinct random streams per session for the same base seed
+        if (options.seed != 0) {
+            options.seed ^= std::uint64_t{*id_} * 0x9E3779B97F4A7C15ull;
+        }
+        bot_manager_.SetOptions(options);
         bot_manager_.CreateBots();
     }
 
@@ -129,20 +182,44 @@ private:
     loot::LootStorage loot_storage_;
 
     BotManager bot_manager_;
+
+    // World index: loot and offices (BotWorldState) plus dogs and bots on uniform grids.
+    // Shared by bot decisions and area-of-interest queries, rebuilt lazily once the world changed;
+    // storage is reused. Mutable - rebuilt from const queries too (all callers run on the API strand).
+    mutable BotWorldState bot_world_state_;
+    mutable spatial::SpatialGrid dog_grid_;
+    mutable bool world_index_dirty_ = true;
+    // Candidate search of ProcessCollisions, storage reused between ticks
+    spatial::SpatialGrid collision_grid_;
     DogDeletedSignal on_dog_deleted_;
 
     bool enable_retirement_ = true;
+    // Game time of this session (sum of tick deltas) and retirement deadlines of standing dogs on it
+    std::chrono::milliseconds retirement_clock_{0};
+    timing::TimingWheel<std::uint32_t> retirement_wheel_;
+    std::vector<std::uint32_t> expired_dogs_;   // reused between ticks
+    // Player actions posted since the last tick
+    ActionInbox action_inbox_;
+
+    Lifecycle lifecycle_ = Lifecycle::ACTIVE;
+    // time without players since the session went IDLE
+    std::chrono::milliseconds empty_time_{0};
+
+    // Frees the world index and collision grid storage - rebuilt on the first use after waking up
+    void Hibernate();
 
     void ProcessCollisions(std::chrono::milliseconds /*time_delta_ms*/,
                           const std::vector<app_geom::Position2D>& start_positions,
                           const std::vector<Dog*>& dog_ptrs);
 
-    // Dogs retirement process
-    void UpdateDogsIdleTime(std::chrono::milliseconds time_delta_ms);
+    // Dogs retirement process: advances the clock and retires dogs whose deadline passed
+    void RetireIdleDogs(std::chrono::milliseconds time_delta_ms);
+
+    // The dog stands still from now on: retire it after dogRetirementTime unless it moves
+    void StartRetirementCountdown(Dog& dog, std::chrono::milliseconds since);
 
-    BotWorldState BuildBotWorldState() const;
+    const BotWorldState& BuildBotWorldState() const;
 
-    void RetireDog(std::uint32_t dog_id);
 
     void ReleaseRetiredBag(Dog* dog);
 };
@@ -10,7 +10,7 @@ namespace loot {
                                  std::function<double()> random_gen) {
         if (loot_count <= 0 || roads.empty() || loot_types.empty()) return;
 
-        auto& rng = GetRandomEngine();
+        auto& rng = engine_;
         std::uniform_real_distribution<double> unit_dist(0.0, 1.0);
         auto rand_double = random_gen ? random_gen : [&]() { return unit_dist(rng); };
 
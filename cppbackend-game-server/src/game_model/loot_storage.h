@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
 
 #include "game_extra_data.h"
@@ -27,6 +28,12 @@ namespace loot {
 
         [[nodiscard]] const std::map<int, LootObject>& GetLootObjects() const { return loots_; }
 
+        // Makes loot placement reproducible (random seed by default)
+        void Seed(std::uint64_t seed) {
+            std::seed_seq seq{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+            engine_.seed(seq);
+        }
+
         void RemoveLoot(int loot_object_id) {
             loots_.erase(loot_object_id);
         }
@@ -67,11 +74,7 @@ namespace loot {
     private:
         int next_loot_object_id_ = 1;       // unique ID generator
         std::map<int, LootObject> loots_;
-
-        static std::mt19937& GetRandomEngine() {
-            thread_local std::mt19937 engine(std::random_device{}());
-            return engine;
-        }
+        std::mt19937 engine_{std::random_device{}()};     // per session, so a seed fixes the loot sequence
     };
 
 } // namespace loot
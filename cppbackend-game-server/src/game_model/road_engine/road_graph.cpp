@@ -204,7 +204,8 @@ double RoadGraph::DistanceAlongRoad(const app_geom::Position2D& point,
 
 std::vector<app_geom::Position2D> RoadGraph::FindPath(
     const app_geom::Position2D& start_pos,
-    const app_geom::Position2D& goal_pos) const
+    const app_geom::Position2D& goal_pos,
+    size_t* expansions) const
 {
     // --- Validate that start and goal are on the road network ---
     auto start_roads = FindRoadIndicesAtPoint(start_pos);
@@ -283,6 +284,8 @@ std::vector<app_geom::Position2D> RoadGraph::FindPath(
             break;
         if (current_f > f[u] + 1e-9)
             continue;
+        if (expansions)
+            ++*expansions;
 
         // Explore neighbors
         if (u < nodes_.size()) { // permanent node
@@ -348,4 +351,12 @@ std::vector<app_geom::Position2D> RoadGraph::FindPath(
     return path;
 }
 
+double RoadGraph::PathLength(const std::vector<app_geom::Position2D>& path) {
+    double length = 0.0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        length += std::hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+    }
+    return length;
+}
+
 } // namespace model
\ No newline at end of file
@@ -41,10 +41,18 @@ public:
      * Find the shortest path along roads from start_pos to goal_pos.
      * Both positions must lie on at least one road (checked internally).
      * Returns a list of positions from start to goal inclusive, or empty if no path.
+     * If expansions is set, the number of nodes expanded by the search is added to it
+     * (a deterministic measure of the search cost, used for planning budgets).
      */
     std::vector<app_geom::Position2D> FindPath(
         const app_geom::Position2D& start_pos,
-        const app_geom::Position2D& goal_pos) const;
+        const app_geom::Position2D& goal_pos,
+        size_t* expansions = nullptr) const;
+
+    /**
+     * Total length of a path returned by FindPath (sum of its segments).
+     */
+    static double PathLength(const std::vector<app_geom::Position2D>& path);
 
 private:
     struct Node {
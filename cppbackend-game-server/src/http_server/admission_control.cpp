@@ -0,0 +1,162 @@
+#include "admission_control.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../common/utils.h"
+
+namespace admission {
+
+using namespace http_handler;
+
+RateLimiter::RateLimiter(double rate, double burst, size_t max_buckets)
+    : rate_(rate)
+    , burst_(std::max(burst, 1.0))
+    , max_buckets_per_stripe_(std::max<size_t>(max_buckets / STRIPES, 1))
+{
+    for (size_t i = 0; i < STRIPES; ++i) {
+        stripes_[i].random.seed(static_cast<std::uint_fast32_t>(std::random_device{}() + i));
+    }
+}
+
+bool RateLimiter::TryAcquire(const app::TokenKey& key, Clock::time_point now, std::chrono::seconds& retry_after) {
+    Stripe& stripe = stripes_[app::TokenKeyHasher{}(key) % STRIPES];
+    std::lock_guard lock{stripe.mutex};
+
+    auto it = stripe.buckets.find(key);
+    const bool inserted = it == stripe.buckets.end();
+    if (inserted) {
+        MakeRoom(stripe, now);
+        it = stripe.buckets.emplace(key, Bucket{burst_, now}).first;
+    }
+    Bucket& bucket = it->second;
+    if (!inserted && now > bucket.updated) {
+        const std::chrono::duration<double> elapsed = now - bucket.updated;
+        bucket.tokens = std::min(burst_, bucket.tokens + elapsed.count() * rate_);
+        bucket.updated = now;
+    }
+
+    bool admitted = bucket.tokens >= 1.0;
+    if (admitted) {
+        bucket.tokens -= 1.0;
+    } else {
+        retry_after = std::chrono::seconds(static_cast<std::int64_t>(std::ceil((1.0 - bucket.tokens) / rate_)));
+    }
+    return admitted;
+}
+
+size_t RateLimiter::Size() const {
+    size_t size = 0;
+    for (const auto& stripe : stripes_) {
+        std::lock_guard lock{stripe.mutex};
+        size += stripe.buckets.size();
+    }
+    return size;
+}
+
+void RateLimiter::MakeRoom(Stripe& stripe, Clock::time_point now) {
+    ++stripe.inserts_since_sweep;
+    const size_t size = stripe.buckets.size();
+    if (size >= SWEEP_BUCKETS_PER_STRIPE && stripe.inserts_since_sweep >= size / 2) {
+        DropFullBuckets(stripe, now);
+        stripe.inserts_since_sweep = 0;
+    }
+    if (stripe.buckets.size() >= max_buckets_per_stripe_) {
+        EvictRandomBucket(stripe);
+    }
+}
+
+void RateLimiter::EvictRandomBucket(Stripe& stripe) {
+    // Start at a random hash bucket and take the first entry found; with load factor <= 1 that is O(1) expected
+    auto& buckets = stripe.buckets;
+    const size_t count = buckets.bucket_count();
+    for (size_t i = std::uniform_int_distribution<size_t>{0, count - 1}(stripe.random), scanned = 0;
+         scanned < count; i = (i + 1) % count, ++scanned) {
+        if (buckets.bucket_size(i) != 0) {
+            const auto key = buckets.begin(i)->first;
+            buckets.erase(key);
+            return;
+        }
+    }
+}
+
+void RateLimiter::DropFullBuckets(Stripe& stripe, Clock::time_point now) {
+    std::erase_if(stripe.buckets, [&](const auto& item) {
+        const std::chrono::duration<double> elapsed = now - item.second.updated;
+        return item.second.tokens + elapsed.count() * rate_ >= burst_;
+    });
+}
+
+app::TokenKey IpKey(const boost::asio::ip::address& address) {
+    const auto bytes = address.is_v4()
+        ? boost::asio::ip::make_address_v6(boost::asio::ip::v4_mapped, address.to_v4()).to_bytes()
+        : address.to_v6().to_bytes();
+    app::TokenKey key;
+    for (size_t i = 0; i < 8; ++i) {
+        key.hi = (key.hi << 8) | bytes[i];
+        key.lo = (key.lo << 8) | bytes[i + 8];
+    }
+    return key;
+}
+
+AdmissionControl::AdmissionControl(const Options& options)
+    : max_in_flight_(options.max_in_flight) {
+    auto make_limiter = [&](std::optional<RateLimiter>& limiter, std::uint32_t rate) {
+        if (rate != 0) {
+            limiter.emplace(rate, options.burst != 0 ? options.burst : rate);
+        }
+    };
+    make_limiter(token_limiter_, options.token_rate);
+    make_limiter(ip_limiter_, options.ip_rate);
+}
+
+bool AdmissionControl::Enabled() const noexcept {
+    return token_limiter_ || ip_limiter_ || max_in_flight_ != 0;
+}
+
+std::optional<StringResponse> AdmissionControl::Admit(const boost::asio::ip::address& client, const StringRequest& req,
+                                                       Clock::time_point now) {
+    std::chrono::seconds retry_after{};
+    if (ip_limiter_ && !ip_limiter_->TryAcquire(IpKey(client), now, retry_after)) {
+        ip_limited_.Inc();
+        return TooManyRequests(req, retry_after);
+    }
+    if (token_limiter_) {
+        // Requests without a valid token are rejected by the API anyway and only count against the IP
+        if (auto token = utils::http::ExtractToken(req)) {
+            if (auto key = app::ParseTokenKey(**token); key && !token_limiter_->TryAcquire(*key, now, retry_after)) {
+                token_limited_.Inc();
+                return TooManyRequests(req, retry_after);
+            }
+        }
+    }
+
+    if (const auto in_flight = in_flight_.fetch_add(1); max_in_flight_ != 0 && in_flight >= max_in_flight_) {
+        in_flight_.fetch_sub(1);
+        shed_.Inc();
+        auto res = response::Builder::MakeError(req, http::status::service_unavailable,
+                                                error_codes::SERVER_OVERLOADED, error_messages::SERVER_OVERLOADED);
+        res.set(http::field::retry_after, "1");
+        return res;
+    }
+    in_flight_gauge_.Add();
+    return std::nullopt;
+}
+
+void AdmissionControl::Release() noexcept {
+    in_flight_.fetch_sub(1);
+    in_flight_gauge_.Sub();
+}
+
+std::uint32_t AdmissionControl::InFlight() const noexcept {
+    return in_flight_.load();
+}
+
+StringResponse AdmissionControl::TooManyRequests(const StringRequest& req, std::chrono::seconds retry_after) {
+    auto res = response::Builder::MakeError(req, http::status::too_many_requests,
+                                            error_codes::TOO_MANY_REQUESTS, error_messages::TOO_MANY_REQUESTS);
+    res.set(http::field::retry_after, std::to_string(std::max<std::int64_t>(1, retry_after.count())));
+    return res;
+}
+
+} // namespace admission
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <unordered_map>
+
+#include <boost/asio/ip/tcp.hpp>
+
+#include "http_response.h"
+#include "request_arena.h"
+#include "../common/metrics.h"
+#include "../game_app/token.h"
+
+namespace admission {
+
+using http_handler::StringRequest;
+using http_handler::StringResponse;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Token buckets keyed by 128-bit keys (player tokens, client IP addresses)
+ *
+ * Each key gets `burst` requests at once and `rate` more per second. Buckets live in
+ * mutex-protected stripes, so concurrent sessions rarely contend.
+ * Buckets are created before a token is validated, so a flood of made-up keys must not grow the
+ * table without bound or turn the limiter into a hotspot:
+ * - a stripe over SWEEP_BUCKETS_PER_STRIPE drops the buckets that have refilled completely (they
+ *   behave like new ones), but only after inserting half its size since the last sweep - O(1) amortized;
+ * - a stripe at its hard cap evicts a random bucket per new key (that client gets a fresh bucket).
+ */
+class RateLimiter {
+public:
+    static constexpr size_t STRIPES = 16;
+    static constexpr size_t SWEEP_BUCKETS_PER_STRIPE = 4096;
+    static constexpr size_t DEFAULT_MAX_BUCKETS = 16 * 16384;
+
+    // max_buckets - hard cap of the whole limiter, split evenly over the stripes
+    RateLimiter(double rate, double burst, size_t max_buckets = DEFAULT_MAX_BUCKETS);
+
+    // true - the request is admitted; otherwise retry_after is set to the wait for the next token
+    bool TryAcquire(const app::TokenKey& key, Clock::time_point now, std::chrono::seconds& retry_after);
+
+    [[nodiscard]] size_t Size() const;
+
+private:
+    struct Bucket {
+        double tokens;
+        Clock::time_point updated;
+    };
+
+    struct alignas(64) Stripe {
+        mutable std::mutex mutex;
+        std::unordered_map<app::TokenKey, Bucket, app::TokenKeyHasher> buckets;
+        size_t inserts_since_sweep = 0;
+        std::minstd_rand random;    ///< Picks the evicted bucket (not derived from the keys a client sends)
+    };
+
+    double rate_;
+    double burst_;
+    size_t max_buckets_per_stripe_;
+    std::array<Stripe, STRIPES> stripes_;
+
+    // Called under the stripe mutex before a new key is inserted
+    void MakeRoom(Stripe& stripe, Clock::time_point now);
+    void DropFullBuckets(Stripe& stripe, Clock::time_point now);
+    static void EvictRandomBucket(Stripe& stripe);
+};
+
+// IPv4 addresses as v4-mapped IPv6, so one key type covers both families
+app::TokenKey IpKey(const boost::asio::ip::address& address);
+
+struct Options {
+    std::uint32_t token_rate = 0;       ///< Requests per second per player token (0 - unlimited)
+    std::uint32_t ip_rate = 0;          ///< Requests per second per client IP (0 - unlimited)
+    std::uint32_t burst = 0;            ///< Bucket size (0 - one second worth of requests)
+    std::uint32_t max_in_flight = 0;    ///< API requests admitted but not answered yet (0 - unlimited)
+};
+
+/**
+ * @brief Admission checks of API requests before they queue for the API strand
+ *
+ * Admit() rejects a request with 429 when its client IP or its player token is over the rate,
+ * and with 503 when max_in_flight API requests are already admitted and not answered (load shedding:
+ * under overload new requests fail fast instead of waiting in an ever longer strand queue).
+ * Every admitted request must be matched by a Release() once its response is sent.
+ */
+class AdmissionControl {
+public:
+    explicit AdmissionControl(const Options& options);
+
+    [[nodiscard]] bool Enabled() const noexcept;
+
+    // nullopt - admitted; otherwise the response to send instead of handling the request
+    std::optional<StringResponse> Admit(const boost::asio::ip::address& client, const StringRequest& req,
+                                        Clock::time_point now = Clock::now());
+    void Release() noexcept;
+
+    [[nodiscard]] std::uint32_t InFlight() const noexcept;
+
+private:
+    std::optional<RateLimiter> token_limiter_;
+    std::optional<RateLimiter> ip_limiter_;
+    std::uint32_t max_in_flight_;
+    std::atomic<std::uint32_t> in_flight_{0};
+
+    metrics::Counter& token_limited_ = metrics::Registry::Instance().GetCounter(
+        "api_rate_limited_total", "API requests rejected with 429", R"(key="token")");
+    metrics::Counter& ip_limited_ = metrics::Registry::Instance().GetCounter(
+        "api_rate_limited_total", "API requests rejected with 429", R"(key="ip")");
+    metrics::Counter& shed_ = metrics::Registry::Instance().GetCounter(
+        "api_shed_total", "API requests rejected with 503 because max-in-flight was reached");
+    metrics::Gauge& in_flight_gauge_ = metrics::Registry::Instance().GetGauge(
+        "api_in_flight", "API requests admitted and not answered yet");
+
+    static StringResponse TooManyRequests(const StringRequest& req, std::chrono::seconds retry_after);
+};
+
+/**
+ * @brief Decorator checking AdmissionControl before the wrapped handler (same call signature
+ * as the handlers of LoggingRequestHandler); static file requests are not limited
+ */
+template <typename Handler>
+class AdmissionRequestHandler {
+public:
+    AdmissionRequestHandler(Handler handler, std::shared_ptr<AdmissionControl> control)
+        : handler_(std::move(handler))
+        , control_(std::move(control))
+    {}
+
+    template <typename Body, typename Allocator, typename Send>
+    void operator()(boost::asio::ip::tcp::endpoint endpoint,
+                    boost::beast::http::request<Body, boost::beast::http::basic_fields<Allocator>>&& req,
+                    http_server::RequestArena& arena, Send&& send) {
+        if (!control_->Enabled() || !req.target().starts_with(http_handler::api_paths::API_PREFIX)) {
+            return handler_(std::move(endpoint), std::move(req), arena, std::forward<Send>(send));
+        }
+        if (auto rejection = control_->Admit(endpoint.address(), req)) {
+            return send(std::move(*rejection));
+        }
+        handler_(std::move(endpoint), std::move(req), arena,
+                 [send = std::forward<Send>(send), control = control_](auto&& response) mutable {
+                     control->Release();
+                     send(std::forward<decltype(response)>(response));
+                 });
+    }
+
+private:
+    Handler handler_;
+    std::shared_ptr<AdmissionControl> control_;
+};
+
+} // namespace admission
@@ -1,85 +1,60 @@
 #include "api_handler.h"
 #include "../common/utils.h"
+#include "request_json.h"
 #include "serialize_api.h"
 
 namespace http_handler {
 
-void ApiHandler::SetupRoutes() {
-    // ALL MAPS
-    router_->AddRoute(api_paths::MAPS_BASE,
-        {
-                        .allowed_methods = {http::verb::get, http::verb::head},
-                        .handler = [this](const RequestContext& ctx, std::string_view) {
-                            return HandleGetMaps(ctx);}
-                });
-
-    // MAP BY ID
-    std::string path = std::string(api_paths::MAPS_BASE)
-                        + std::string(api_paths::SLASH)
-                        + std::string(api_paths::ID);
-    router_->AddRoute(path,
-        {
-                    .allowed_methods = {http::verb::get, http::verb::head},
-                    .handler = [this](const RequestContext& ctx, std::string_view) {
-                        return HandleGetMapById(ctx);}
-                });
-
-    // GAME JOIN
-    router_->AddRoute(api_paths::GAME_JOIN,
-        {
-                    .allowed_methods = {http::verb::post},
-                    .content_type = std::string(ContentType::APPLICATION_JSON),
-                    .handler = [this](const RequestContext& ctx, std::string_view) {
-                        return HandleGameJoin(ctx);}
-                });
-
-    // PLAYERS LIST
-    router_->AddRoute(api_paths::GAME_PLAYERS,
-        {
-                    .allowed_methods = {http::verb::get, http::verb::head},
-                    .requires_auth = true,
-                    .handler = [this](const RequestContext& ctx, std::string_view) {
-                        return HandleGamePlayers(ctx);}
-                });
-
-    // GAME STATE
-    router_->AddRoute(api_paths::GAME_STATE,
-        {
-                    .allowed_methods = {http::verb::get, http::verb::head},
-                    .requires_auth = true,
-                    .handler = [this](const RequestContext& ctx, std::string_view) {
-                        return HandleGameState(ctx);}
-                });
-
-    // PLAYER ACTION
-    router_->AddRoute(api_paths::PLAYER_ACTION,
-        {
-                    .allowed_methods = {http::verb::post},
-                    .requires_auth = true,
-                    .content_type = std::string(ContentType::APPLICATION_JSON),
-                    .handler = [this](const RequestContext& ctx, std::string_view) {
-                        return HandleGamePlayerAction(ctx);}
-                });
-
-    // GAME TICK
-    router_->AddRoute(api_paths::GAME_TICK,
-        {
-                    .allowed_methods = {http::verb::post},
-                    .content_type = std::string(ContentType::APPLICATION_JSON),
-                    .handler = [this](const RequestContext& ctx, std::string_view) {
-                        return HandleGameTick(ctx);
-                    },
-                    .auto_tick_enabled = (app_.GetCmdArgs().tick_period != common_values::NO_AUTO_TICK)
-                });
-
-    // GAME RECORDS
-    router_->AddRoute(api_paths::GAME_RECORDS,
-        {
-                    .allowed_methods = {http::verb::get, http::verb::head},
-                    .content_type = std::string(ContentType::APPLICATION_JSON),
-                    .handler = [this](const RequestContext& ctx, std::string_view) {
-                        return HandleGameRecords(ctx);}
-                });
+std::span<const RouteSpec<ApiHandler>> ApiHandler::RouteTable() {
+    using Spec = RouteSpec<ApiHandler>;
+    static constexpr auto ROUTES = routing::SortRoutes(std::array{
+        // ALL MAPS
+        Spec{api_paths::MAPS_BASE,
+             {.allowed_methods = Methods({http::verb::get, http::verb::head})},
+             &ApiHandler::HandleGetMaps},
+        // MAP BY ID
+        Spec{api_paths::MAP_BY_ID,
+             {.allowed_methods = Methods({http::verb::get, http::verb::head})},
+             &ApiHandler::HandleGetMapById},
+        // GAME JOIN
+        Spec{api_paths::GAME_JOIN,
+             {.allowed_methods = Methods({http::verb::post}),
+              .content_type = ContentType::APPLICATION_JSON},
+             &ApiHandler::HandleGameJoin},
+        // PLAYERS LIST
+        Spec{api_paths::GAME_PLAYERS,
+             {.allowed_methods = Methods({http::verb::get, http::verb::head}),
+              .requires_auth = true},
+             &ApiHandler::HandleGamePlayers},
+        // GAME STATE
+        Spec{api_paths::GAME_STATE,
+             {.allowed_methods = Methods({http::verb::get, http::verb::head}),
+              .requires_auth = true},
+             &ApiHandler::HandleGameState},
+        // PLAYER ACTION
+        Spec{api_paths::PLAYER_ACTION,
+             {.allowed_methods = Methods({http::verb::post}),
+              .requires_auth = true,
+              .content_type = ContentType::APPLICATION_JSON},
+             &ApiHandler::HandleGamePlayerAction},
+        // GAME TICK (blocked when the game ticks on timer)
+        Spec{api_paths::GAME_TICK,
+             {.allowed_methods = Methods({http::verb::post}),
+              .content_type = ContentType::APPLICATION_JSON,
+              .manual_tick = true},
+             &ApiHandler::HandleGameTick},
+        // GAME RECORDS
+        Spec{api_paths::GAME_RECORDS,
+             {.allowed_methods = Methods({http::verb::get, http::verb::head}),
+              .content_type = ContentType::APPLICATION_JSON},
+             &ApiHandler::HandleGameRecords},
+        // METRICS (Prometheus text format)
+        Spec{api_paths::METRICS,
+             {.allowed_methods = Methods({http::verb::get, http::verb::head})},
+             &ApiHandler::HandleMetrics},
+    });
+    static_assert(routing::ValidateRoutes(ROUTES), "ApiHandler: invalid route table");
+    return ROUTES;
 }
 
 bool ApiHandler::IsApiRequest(const StringRequest &req)
@@ -90,14 +65,20 @@ bool ApiHandler::IsApiRequest(const StringRequest &req)
     return false;
 }
 
-StringResponse ApiHandler::HandleApiRequest(StringRequest&& req) const {
-    RequestContext ctx{req, std::nullopt};
+bool ApiHandler::IsOffStrandRequest(const StringRequest& req) const {
+    return req.target() == api_paths::PLAYER_ACTION && !app_.IsRecordingReplay();
+}
+
+StringResponse ApiHandler::HandleApiRequest(StringRequest&& req, http_server::RequestArena* arena) const {
+    // Everything allocated from the arena (JSON DOMs) dies with ctx,
+    // before the response is handed over to the session
+    RequestContext ctx = MakeRequestContext(req, arena);
 
     // Extract token if present (for all requests)
     ctx.token = utils::http::ExtractToken(req);
 
     // Try to route via modular router
-    if (auto response = router_->Route(req, ctx)) {
+    if (auto response = router_.Route(*this, ctx)) {
         return std::move(*response);
     }
 
@@ -108,29 +89,23 @@ StringResponse ApiHandler::HandleApiRequest(StringRequest&& req) const {
 }
 
 StringResponse ApiHandler::HandleGetMaps(const RequestContext &ctx) const {
-    json::array maps_array;
-    for (const auto& map : game_.GetMaps()) {
-        maps_array.push_back(serialize_api::SerializeMapBrief(map));
-    }
-    return response::Builder::MakeJson(ctx.req, maps_array);
+    return MapCatalogue::MakeResponse(ctx.req, *map_catalogue_.GetMapsList());
 }
 
 StringResponse ApiHandler::HandleGetMapById(const RequestContext& ctx) const {
-    auto it = ctx.path_params.find(json_fields::ID);
-    if (it == ctx.path_params.end()) {
+    auto map_id = ctx.path_params.Find(json_fields::ID);
+    if (!map_id) {
         return response::Builder::MakeError(ctx.req, http::status::bad_request,
                                             error_codes::BAD_REQUEST,
                                             error_messages::BAD_REQUEST);
     }
-    const std::string& map_id = it->second;
-
-    const model::Map* map = game_.FindMap(model::Map::Id{map_id});
-    if (!map) {
+    auto body = map_catalogue_.FindMap(*map_id);
+    if (!body) {
         return response::Builder::MakeError(ctx.req, http::status::not_found,
                                             error_codes::MAP_NOT_FOUND,
                                             error_messages::MAP_NOT_FOUND);
     }
-    return response::Builder::MakeJson(ctx.req, serialize_api::SerializeMapFull(*map, game_.GetGameExtraData().get()));
+    return MapCatalogue::MakeResponse(ctx.req, *body);
 }
 
 StringResponse ApiHandler::HandleGameJoin(const RequestContext& ctx) const {
@@ -138,7 +113,7 @@ StringResponse ApiHandler::HandleGameJoin(const RequestContext& ctx) const {
     std::string user_name;
     std::string map_id;
 
-    if (!ParseGameJoinRequest(ctx.req, user_name, map_id)) {
+    if (!ParseGameJoinRequest(ctx, user_name, map_id)) {
         return response::Builder::MakeError(ctx.req, http::status::bad_request,
                                             error_codes::INVALID_ARGUMENT, error_messages::JOIN_GAME_PARSE);
     }
@@ -166,7 +141,7 @@ StringResponse ApiHandler::HandleGameJoin(const RequestContext& ctx) const {
         }
 
         // Create response JSON
-        json::object response_json;
+        json::object response_json(ctx.JsonStorage());
         response_json[json_fields::AUTH_TOKEN] = **token;  // Convert Token to string
         response_json[json_fields::PLAYER_ID] = player.GetId();  // Get actual player ID
 
@@ -192,7 +167,8 @@ StringResponse ApiHandler::HandleGamePlayers(const RequestContext& ctx) const
                                             error_messages::UNKNOWN_TOKEN);
     }
 
-    return response::Builder::MakeJson(ctx.req, serialize_api::SerializeGamePlayers(*player->GetGameSession()));
+    return response::Builder::MakeJson(ctx.req, serialize_api::SerializeGamePlayers(*player->GetGameSession(),
+                                                                                    ctx.JsonStorage()));
 }
 
 StringResponse ApiHandler::HandleGameState(const RequestContext& ctx) const
@@ -215,7 +191,8 @@ StringResponse ApiHandler::HandleGameState(const RequestContext& ctx) const
         return response::InternalServerError(ctx.req);
     }
 
-    return response::Builder::MakeJson(ctx.req, serialize_api::SerializeGameState(*session));
+    return response::Builder::MakeJson(ctx.req, serialize_api::SerializeGameState(
+        *session, *player->GetDog(), game_.GetGameExtraData()->GetInterestRadius(), ctx.JsonStorage()));
 }
 
 StringResponse ApiHandler::HandleGamePlayerAction(const RequestContext& ctx) const
@@ -226,8 +203,8 @@ StringResponse ApiHandler::HandleGamePlayerAction(const RequestContext& ctx) con
         throw std::runtime_error("Token required for current Handler.");
     }
     auto token = ctx.token.value();
-    // Проверяем токен
-    auto player = app_.GetPlayers().FindPlayerByToken(token);
+    // Проверяем токен (shared: the handler may run off the API strand, concurrently with retirement)
+    auto player = app_.GetPlayers().FindSharedPlayerByToken(token);
     if (!player) {
         return response::Builder::MakeError(ctx.req, http::status::unauthorized,
                                             error_codes::UNKNOWN_TOKEN,
@@ -236,7 +213,7 @@ StringResponse ApiHandler::HandleGamePlayerAction(const RequestContext& ctx) con
 
     // Парсим запрос
     std::string move_value;
-    if (!ParsePlayerActionRequest(ctx.req, move_value)) {
+    if (!ParsePlayerActionRequest(ctx, move_value)) {
         return response::Builder::MakeError(ctx.req, http::status::bad_request,
                                             error_codes::INVALID_ARGUMENT,
                                             error_messages::ACTION_PARSE_ERROR);
@@ -250,8 +227,8 @@ StringResponse ApiHandler::HandleGamePlayerAction(const RequestContext& ctx) con
                                             error_messages::INVALID_ACTION_VALUE);
     }
 
-    // Обновляем направление игрока
-    player->SetDirection(*direction_opt);
+    // Направление применяется в начале следующего тика (последнее из присланных)
+    app_.PostPlayerDirection(*player, *direction_opt);
     // boost_logger::LogInfo("ApiHandler::HandleGamePlayerAction: Player id=" +
     //                         std::to_string(player->GetId()) + " SetDirection[" +
     //                         move_value == app::move_values::STOP ? "STOP" : move_value + "]");
@@ -264,7 +241,7 @@ StringResponse ApiHandler::HandleGameTick(const RequestContext &ctx) const
 {
     // Парсим запрос
     int time_delta_ms;
-    if (!ParseGameTickRequest(ctx.req, time_delta_ms)) {
+    if (!ParseGameTickRequest(ctx, time_delta_ms)) {
         return response::Builder::MakeError(ctx.req, http::status::bad_request,
                                             error_codes::INVALID_ARGUMENT,
                                             error_messages::TICK_PARSE_ERROR);
@@ -294,9 +271,9 @@ StringResponse ApiHandler::HandleGameRecords(const RequestContext &ctx) const {
 
     auto scores = app_.GetPlayerScores(limit, offset);
 
-    boost::json::array arr;
+    boost::json::array arr(ctx.JsonStorage());
     for (const auto& score : scores) {
-        boost::json::object obj;
+        boost::json::object obj(ctx.JsonStorage());
         obj["name"] = score.name;
         obj["score"] = score.score;
         obj["playTime"] = score.play_time_sec;          // stored as double (seconds)
@@ -306,11 +283,18 @@ StringResponse ApiHandler::HandleGameRecords(const RequestContext &ctx) const {
     return response::Builder::MakeJson(ctx.req, arr);
 }
 
+StringResponse ApiHandler::HandleMetrics(const RequestContext& ctx) const {
+    return response::Builder::From(ctx.req)
+        .WithContentType(ContentType::PROMETHEUS_TEXT)
+        .WithBody(metrics::Registry::Instance().Render())
+        .Build();
+}
+
 /**
  * Parses the HTTP request body as JSON, validates that it is a JSON object,
  * optionally runs a user‑supplied validator, and stores the result.
  *
- * @param req          The incoming HTTP request containing the body to parse.
+ * @param ctx          Request context: the request body to parse and the arena storage for the JSON DOM.
  * @param validator    A callable (std::function) that takes a const reference to
  *                     the parsed JSON object and returns true if the object is valid,
  *                     false otherwise. If this is empty (nullptr), validation is skipped.
@@ -325,7 +309,7 @@ StringResponse ApiHandler::HandleGameRecords(const RequestContext &ctx) const {
  * @note Exceptions during parsing or validation are caught, logged, and cause a false return.
  * @note The function is const and does not modify any member variables.
  */
-bool ApiHandler::ParseJsonRequest(const StringRequest& req,
+bool ApiHandler::ParseJsonRequest(const RequestContext& ctx,
                                   const std::function<bool(const json::object&)> &validator,
                                   json::object& parsed_json) const {
     try {
@@ -335,7 +319,8 @@ bool ApiHandler::ParseJsonRequest(const StringRequest& req,
         // - The JSON syntax is invalid,
         // - The input contains unexpected characters.
         // It returns a json::value that can hold any JSON type.
-        json::value json_body = json::parse(req.body());
+        // The DOM is allocated from the request arena (bump allocations, released after the response).
+        json::value json_body = json::parse(ctx.req.body(), ctx.JsonStorage());
 
         // Verify that the top‑level JSON value is an object (i.e., {...}).
         // If it's an array, string, number, boolean, or null, we reject it.
@@ -349,8 +334,8 @@ bool ApiHandler::ParseJsonRequest(const StringRequest& req,
 
         // Extract the JSON object from the value.
         // Since we already confirmed is_object(), as_object() is safe and returns a reference.
-        // The assignment copies the object into parsed_json (may be expensive for large objects).
-        parsed_json = json_body.as_object();
+        // parsed_json is expected to share the arena storage, so the move is a pointer swap.
+        parsed_json = std::move(json_body.as_object());
 
         // If a validator was provided (i.e., the std::function is not empty),
         // invoke it with the parsed object. The validator should perform semantic checks
@@ -382,10 +367,17 @@ bool ApiHandler::ParseJsonRequest(const StringRequest& req,
     // only throw std::exception derivatives, so this is acceptable.
 }
 
-bool ApiHandler::ParseGameJoinRequest(const StringRequest& req,
+bool ApiHandler::ParseGameJoinRequest(const RequestContext& ctx,
                                       std::string& user_name,
                                       std::string& map_id) const {
-    json::object parsed_json;
+    // Обычное тело запроса разбирается без JSON DOM, всё остальное - универсальным парсером
+    if (auto body = request_json::ParseJoinBody(ctx.req.body())) {
+        user_name = body->user_name;
+        map_id = body->map_id;
+        return true;
+    }
+
+    json::object parsed_json(ctx.JsonStorage());
 
     // Создаем валидатор для проверки обязательных полей
     auto validator = [&](const json::object& obj) -> bool {
@@ -395,7 +387,7 @@ bool ApiHandler::ParseGameJoinRequest(const StringRequest& req,
         return user_name_it != obj.end() && map_id_it != obj.end();
     };
 
-    if (!ParseJsonRequest(req, validator, parsed_json)) {
+    if (!ParseJsonRequest(ctx, validator, parsed_json)) {
         return false;
     }
 
@@ -406,9 +398,15 @@ bool ApiHandler::ParseGameJoinRequest(const StringRequest& req,
     return true;
 }
 
-bool ApiHandler::ParsePlayerActionRequest(const StringRequest& req,
+bool ApiHandler::ParsePlayerActionRequest(const RequestContext& ctx,
                                           std::string& move_value) const {
-    json::object parsed_json;
+    // Обычное тело запроса разбирается без JSON DOM, всё остальное - универсальным парсером
+    if (auto move = request_json::ParseActionBody(ctx.req.body())) {
+        move_value = *move;
+        return true;
+    }
+
+    json::object parsed_json(ctx.JsonStorage());
 
     // Валидатор проверяет наличие поля move
     auto validator = [&](const json::object& obj) -> bool {
@@ -416,7 +414,7 @@ bool ApiHandler::ParsePlayerActionRequest(const StringRequest& req,
         return move_it != obj.end();
     };
 
-    if (!ParseJsonRequest(req, validator, parsed_json)) {
+    if (!ParseJsonRequest(ctx, validator, parsed_json)) {
         return false;
     }
 
@@ -425,9 +423,9 @@ bool ApiHandler::ParsePlayerActionRequest(const StringRequest& req,
     return true;
 }
 
-bool ApiHandler::ParseGameTickRequest(const StringRequest &req, int &time_delta) const
+bool ApiHandler::ParseGameTickRequest(const RequestContext& ctx, int &time_delta) const
 {
-    json::object parsed_json;
+    json::object parsed_json(ctx.JsonStorage());
 
     // Валидатор проверяет наличие поля time_delta
     auto validator = [&](const json::object& obj) -> bool {
@@ -435,7 +433,7 @@ bool ApiHandler::ParseGameTickRequest(const StringRequest &req, int &time_delta)
         return move_it != obj.end();
     };
 
-    if (!ParseJsonRequest(req, validator, parsed_json)) {
+    if (!ParseJsonRequest(ctx, validator, parsed_json)) {
         return false;
     }
 
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <span>
+
 #include "api_router.h"
 #include "http_response.h"
+#include "map_catalogue.h"
 #include "../game_model/game_model.h"
 #include "../game_app/application.h"
 
@@ -12,20 +15,26 @@ class ApiHandler {
 public:
     explicit ApiHandler(app::Application& app)
         : app_(app)
-        , router_(std::make_unique<ApiRouter>(ApiRouter{}))
-    {
-        SetupRoutes();
-    }
+        , router_(RouteTable(), app.GetCmdArgs().tick_period != common_values::NO_AUTO_TICK)
+        , map_catalogue_(game_)
+    {}
 
     static bool IsApiRequest(const StringRequest& req);
-    StringResponse HandleApiRequest(StringRequest&& req) const;
+    // Player actions only post an intent for the next tick and may skip the API strand
+    // (unless a replay is recorded, see Application::PostPlayerDirection)
+    bool IsOffStrandRequest(const StringRequest& req) const;
+    // arena - per-session arena for request-scoped allocations (nullptr - global heap)
+    StringResponse HandleApiRequest(StringRequest&& req, http_server::RequestArena* arena = nullptr) const;
 
 private:
     app::Application& app_;
     model::Game& game_ = app_.GetGame();
-    std::unique_ptr<ApiRouter> router_;
+    ApiRouter<ApiHandler> router_;
+    // Maps do not change after loading - their responses are serialized once
+    const MapCatalogue map_catalogue_;
 
-    void SetupRoutes();
+    // Compile-time table of all API endpoints (sorted for ApiRouter)
+    static std::span<const RouteSpec<ApiHandler>> RouteTable();
 
     [[nodiscard]] StringResponse HandleGetMaps(const RequestContext& ctx) const;
     [[nodiscard]] StringResponse HandleGetMapById(const RequestContext& ctx) const;
@@ -35,21 +44,22 @@ private:
     [[nodiscard]] StringResponse HandleGamePlayerAction(const RequestContext& ctx) const;
     [[nodiscard]] StringResponse HandleGameTick(const RequestContext& ctx) const;
     [[nodiscard]] StringResponse HandleGameRecords(const RequestContext& ctx) const;
+    [[nodiscard]] StringResponse HandleMetrics(const RequestContext& ctx) const;
 
-    // Универсальный метод парсинга JSON
-    bool ParseJsonRequest(const StringRequest& req,
+    // Универсальный метод парсинга JSON (JSON DOM размещается в арене запроса)
+    bool ParseJsonRequest(const RequestContext& ctx,
                           const std::function<bool(const json::object&)> &validator,
                           json::object& parsed_json) const;
 
     // Специализированные методы
-    bool ParseGameJoinRequest(const StringRequest& req,
+    bool ParseGameJoinRequest(const RequestContext& ctx,
                               std::string& user_name,
                               std::string& map_id) const;
 
-    bool ParsePlayerActionRequest(const StringRequest& req,
+    bool ParsePlayerActionRequest(const RequestContext& ctx,
                                   std::string& move_value) const;
 
-    bool ParseGameTickRequest(const StringRequest& req,
+    bool ParseGameTickRequest(const RequestContext& ctx,
                               int& time_delta) const;
 
     bool ParseGameRecordsRequest(const StringRequest& req,
@@ -1,14 +1,70 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
 #include <optional>
-#include <functional>
-#include <unordered_map>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "http_response.h"
+#include "../common/metrics.h"
+#include "request_arena.h"
 #include "../game_app/token.h"
 
 namespace http_handler {
 
+    /// Maximum number of :placeholders in one route pattern
+    constexpr inline static size_t MAX_PATH_PARAMS = 4;
+
+    /**
+     * @brief Path parameters extracted from a dynamic route
+     *
+     * Fixed-capacity array of (name, value) views: names point into the route
+     * pattern (static storage), values point into the request target.
+     * No allocations; valid while the request is alive.
+     */
+    class PathParams {
+    public:
+        /// Adds a parameter; returns false when capacity is exceeded
+        constexpr bool Push(std::string_view name, std::string_view value) noexcept {
+            if (size_ == params_.size()) {
+                return false;
+            }
+            params_[size_++] = {name, value};
+            return true;
+        }
+
+        constexpr void Clear() noexcept {
+            size_ = 0;
+        }
+
+        /// Value of the parameter by its name (without ':'), nullopt if absent
+        [[nodiscard]] constexpr std::optional<std::string_view> Find(std::string_view name) const noexcept {
+            for (size_t i = 0; i < size_; ++i) {
+                if (params_[i].first == name) {
+                    return params_[i].second;
+                }
+            }
+            return std::nullopt;
+        }
+
+        [[nodiscard]] constexpr size_t Size() const noexcept {
+            return size_;
+        }
+
+        [[nodiscard]] constexpr bool Empty() const noexcept {
+            return size_ == 0;
+        }
+
+    private:
+        std::array<std::pair<std::string_view, std::string_view>, MAX_PATH_PARAMS> params_{};
+        size_t size_ = 0;
+    };
+
     /**
      * @brief Context passed to all request handlers
      *
@@ -18,126 +74,260 @@ namespace http_handler {
     struct RequestContext {
         const StringRequest& req;               ///< Original HTTP request (read-only)
         std::optional<app::Token> token;        ///< Bearer token if provided in Authorization header
-        std::unordered_map<std::string, std::string> path_params;       ///< Extracted from URL placeholders (e.g., {"id": "map1"})
+        PathParams path_params;                 ///< Extracted from URL placeholders (e.g., {"id": "map1"})
+        http_server::RequestArena* arena = nullptr;     ///< Per-session arena (nullptr - use global heap)
+
+        /// Storage for request-scoped JSON values (parsed body, response DOM)
+        [[nodiscard]] json::storage_ptr JsonStorage() const noexcept {
+            return arena ? arena->JsonStorage() : json::storage_ptr{};
+        }
+    };
+
+    /// Build context for a request (arena may be nullptr)
+    inline RequestContext MakeRequestContext(const StringRequest& req, http_server::RequestArena* arena) {
+        return RequestContext{req, std::nullopt, PathParams{}, arena};
+    }
+
+    /// Set of HTTP methods as a bitmask (bit N - http::verb with value N)
+    using MethodSet = std::uint64_t;
+
+    constexpr MethodSet MethodBit(http::verb method) noexcept {
+        return MethodSet{1} << static_cast<unsigned>(method);
+    }
+
+    constexpr MethodSet Methods(std::initializer_list<http::verb> methods) noexcept {
+        MethodSet result = 0;
+        for (auto method : methods) {
+            result |= MethodBit(method);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Request checks for one endpoint (everything except the handler)
+     *
+     * Default values: any method, no auth, no Content-Type check, not a manual-tick endpoint
+     */
+    struct RouteRules {
+        MethodSet allowed_methods = 0;                  ///< HTTP methods allowed (0 = any method)
+        bool requires_auth = false;                     ///< If true, valid token must be present
+        std::string_view content_type = ContentType::EMPTY;     ///< Required Content-Type header
+        bool manual_tick = false;                       ///< Endpoint is blocked while auto-tick is active (/api/v1/game/tick)
     };
 
     /**
-     * @brief Tree-based HTTP router with support for path parameters
+     * @brief One row of the compile-time route table
+     *
+     * Handler is a const member function of Target, called directly (no std::function).
+     */
+    template <typename Target>
+    struct RouteSpec {
+        using Handler = StringResponse (Target::*)(const RequestContext&) const;
+
+        std::string_view pattern;       ///< Route pattern (e.g., "/api/v1/maps/:id")
+        RouteRules rules;
+        Handler handler = nullptr;
+    };
+
+    namespace routing {
+
+        /// Pattern contains :placeholders
+        constexpr bool IsDynamic(std::string_view pattern) noexcept {
+            return pattern.find(api_paths::COLON) != std::string_view::npos;
+        }
+
+        /// Cuts the next '/'-separated segment from path (path loses the segment and the separator)
+        constexpr std::string_view NextSegment(std::string_view& path) noexcept {
+            auto pos = path.find(api_paths::SLASH);
+            std::string_view segment = path.substr(0, pos);
+            path.remove_prefix(pos == std::string_view::npos ? path.size() : pos + 1);
+            return segment;
+        }
+
+        /// Request path without query string and without trailing slash ("/api/v1/maps/?a=1" -> "/api/v1/maps")
+        constexpr std::string_view NormalizePath(std::string_view target) noexcept {
+            std::string_view path = target.substr(0, target.find('?'));
+            if (path.size() > 1 && path.ends_with(api_paths::SLASH)) {
+                path.remove_suffix(1);
+            }
+            return path;
+        }
+
+        /**
+         * @brief Match a path against a pattern segment by segment
+         * @param pattern Route pattern, :placeholders match any non-empty segment
+         * @param path Normalized request path
+         * @param params Output parameters (views into pattern and path); filled only on success
+         */
+        constexpr bool MatchPattern(std::string_view pattern, std::string_view path, PathParams& params) noexcept {
+            PathParams found;
+            while (!pattern.empty() && !path.empty()) {
+                std::string_view pattern_seg = NextSegment(pattern);
+                std::string_view path_seg = NextSegment(path);
+                if (pattern_seg.starts_with(api_paths::COLON)) {
+                    if (path_seg.empty() || !found.Push(pattern_seg.substr(1), path_seg)) {
+                        return false;
+                    }
+                } else if (pattern_seg != path_seg) {
+                    return false;
+                }
+            }
+            if (!pattern.empty() || !path.empty()) {
+                return false;
+            }
+            params = found;
+            return true;
+        }
+
+        /// Static routes first (sorted by pattern for binary search), then dynamic routes in declaration order
+        template <typename Target, size_t N>
+        constexpr std::array<RouteSpec<Target>, N> SortRoutes(std::array<RouteSpec<Target>, N> routes) {
+            auto less = [](const RouteSpec<Target>& lhs, const RouteSpec<Target>& rhs) {
+                bool lhs_dynamic = IsDynamic(lhs.pattern);
+                bool rhs_dynamic = IsDynamic(rhs.pattern);
+                if (lhs_dynamic != rhs_dynamic) {
+                    return !lhs_dynamic;
+                }
+                return !lhs_dynamic && lhs.pattern < rhs.pattern;
+            };
+            // Stable insertion sort: std::stable_sort is not constexpr, and tables are small
+            for (size_t i = 1; i < N; ++i) {
+                for (size_t j = i; j > 0 && less(routes[j], routes[j - 1]); --j) {
+                    std::swap(routes[j], routes[j - 1]);
+                }
+            }
+            return routes;
+        }
+
+        /// Table sanity check for static_assert: handlers set, patterns absolute and unique
+        template <typename Target, size_t N>
+        constexpr bool ValidateRoutes(const std::array<RouteSpec<Target>, N>& routes) {
+            for (size_t i = 0; i < N; ++i) {
+                if (!routes[i].handler || !routes[i].pattern.starts_with(api_paths::SLASH)) {
+                    return false;
+                }
+                for (size_t j = i + 1; j < N; ++j) {
+                    if (routes[i].pattern == routes[j].pattern) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Checks method, authentication, Content-Type and auto-tick blocking
+         * @return Error response if a check fails, nullopt if the handler may be called
+         */
+        std::optional<StringResponse> CheckRules(const RouteRules& rules, const RequestContext& ctx,
+                                                 bool auto_tick_enabled);
+
+        /// Per-endpoint request counter and latency histogram (checks + handler)
+        struct RouteMetrics {
+            metrics::Counter& requests;
+            metrics::Histogram& latency;
+        };
+
+        /// Registers (or finds) metrics of the endpoint, labelled by its pattern
+        RouteMetrics MakeRouteMetrics(std::string_view pattern);
+
+        /// Requests that matched no route
+        metrics::Counter& UnmatchedRequests();
+
+    } // namespace routing
+
+    /**
+     * @brief Router over a fixed, compile-time route table
      *
      * Features:
-     * - O(L) lookup time (L = number of path segments), independent of total routes
-     * - Supports static routes (exact match) and dynamic routes with :placeholders
-     * - Automatic path parameter extraction into RequestContext
+     * - Table is built as constexpr (see routing::SortRoutes), the router only keeps a view of it
+     * - Static routes: binary search over the sorted patterns, O(log N) string comparisons
+     * - Dynamic routes with :placeholders: segment-wise match, parameters are string_views into the target
+     * - Static routes take precedence over dynamic ones ("/api/v1/maps" vs "/api/v1/maps/:id")
+     * - No allocations and no std::function: handlers are member function pointers of Target
      * - Method validation, authentication checks, content-type verification
      *
-     * Route patterns:
-     * - Static:   "/api/v1/maps"           → exact match
-     * - Dynamic:  "/api/v1/maps/:id"       → matches "/api/v1/maps/map1", extracts {"id": "map1"}
-     *
      * The colon (:) is used only in route definitions; real requests contain plain slashes.
      */
+    template <typename Target>
     class ApiRouter {
     public:
-        /// Handler function type: takes RequestContext and request data (body or query string)
-        using HandlerFunc = std::function<StringResponse(
-            const RequestContext&,
-            const std::string_view /* body or query */
-            )>;
+        using Spec = RouteSpec<Target>;
 
         /**
-         * @brief Configuration for a single endpoint
-         *
-         * Default values: requires_auth = false, content_type = EMPTY, auto_tick_enabled = false
+         * @param routes Table prepared by routing::SortRoutes (must outlive the router)
+         * @param auto_tick_enabled Block manual-tick endpoints (game ticks on timer)
          */
-        struct EndpointConfig {
-            std::vector<http::verb> allowed_methods;        ///< HTTP methods allowed (empty = any method)
-            bool requires_auth = false;                     ///< If true, valid token must be present
-            std::string content_type = std::string(ContentType::EMPTY);     ///< Required Content-Type header
-            HandlerFunc handler;                            ///< Function to handle the request
-            bool auto_tick_enabled = false;                 ///< Special flag for /api/v1/game/tick when auto-tick is active
-        };
+        explicit ApiRouter(std::span<const Spec> routes, bool auto_tick_enabled = false)
+            : routes_(routes)
+            , static_count_(static_cast<size_t>(std::ranges::find_if(routes, [](const Spec& spec) {
+                    return routing::IsDynamic(spec.pattern);
+                }) - routes.begin()))
+            , auto_tick_enabled_(auto_tick_enabled)
+        {
+            route_metrics_.reserve(routes_.size());
+            for (const Spec& spec : routes_) {
+                route_metrics_.push_back(routing::MakeRouteMetrics(spec.pattern));
+            }
+        }
 
         /**
-         * @brief Register a route with its configuration
-         * @param path Route pattern (e.g., "/api/v1/maps/:id")
-         * @param config Endpoint configuration including handler and constraints
+         * @brief Find the route for a request path
+         * @param path Normalized request path (routing::NormalizePath)
+         * @param params Output path parameters
+         * @return Matched table row or nullptr
          */
-        void AddRoute(std::string_view path, EndpointConfig config);
+        const Spec* Match(std::string_view path, PathParams& params) const noexcept {
+            auto static_routes = routes_.first(static_count_);
+            auto it = std::ranges::lower_bound(static_routes, path, {}, &Spec::pattern);
+            if (it != static_routes.end() && it->pattern == path) {
+                params.Clear();
+                return &*it;
+            }
+            for (const Spec& spec : routes_.subspan(static_count_)) {
+                if (routing::MatchPattern(spec.pattern, path, params)) {
+                    return &spec;
+                }
+            }
+            return nullptr;
+        }
 
         /**
          * @brief Route an incoming request to the appropriate handler
-         * @param req The HTTP request
+         * @param target Object whose member function handles the request
          * @param ctx Request context (token will be used; path_params will be filled)
-         * @return Optional response if route found and all checks pass, nullopt otherwise
+         * @return Optional response if route found, nullopt otherwise
          *
          * Performs in order:
          * 1. Path matching (static or dynamic)
-         * 2. HTTP method validation
-         * 3. Authentication check if required
-         * 4. Content-Type header validation if specified
-         * 5. Auto-tick endpoint blocking if enabled
-         * 6. Handler invocation with extracted path parameters
+         * 2. HTTP method, authentication, Content-Type validation, auto-tick endpoint blocking
+         * 3. Handler invocation with extracted path parameters
          */
-        std::optional<StringResponse> Route(const StringRequest& req,
-                                            RequestContext& ctx) const;
+        std::optional<StringResponse> Route(const Target& target, RequestContext& ctx) const {
+            const Spec* spec = Match(routing::NormalizePath(ctx.req.target()), ctx.path_params);
+            if (!spec) {
+                routing::UnmatchedRequests().Inc();
+                return std::nullopt;
+            }
+            const routing::RouteMetrics& route_metrics = route_metrics_[static_cast<size_t>(spec - routes_.data())];
+            route_metrics.requests.Inc();
+            metrics::ScopedTimer timer(route_metrics.latency);
 
-    private:
-        /**
-         * @brief Node in the routing tree
-         *
-         * Each node can have:
-         * - Multiple static children (exact path segments)
-         * - At most one parameter child (placeholder like :id)
-         * - An EndpointConfig if this node represents a complete route
-         */
-        struct TreeNode {
-            std::unordered_map<std::string, std::unique_ptr<TreeNode>> children;  ///< Static segment children
-            std::unique_ptr<TreeNode> param_child;                                 ///< Parameter placeholder child (e.g., :id)
-            std::string param_name;                                                ///< Name of the parameter (without colon)
-            EndpointConfig config;                                                  ///< Only set at leaf nodes (complete routes)
-        };
-
-        std::unique_ptr<TreeNode> root_ = std::make_unique<TreeNode>();     ///< Root of the routing tree
-
-        /**
-         * @brief Split a path into segments
-         * @param path Full URL path (e.g., "/api/v1/maps/map1")
-         * @return Vector of segments ["api", "v1", "maps", "map1"]
-         *
-         * Leading slash is removed, empty segments are skipped.
-         */
-        static std::vector<std::string> SplitPath(std::string_view path);
+            if (auto error = routing::CheckRules(spec->rules, ctx, auto_tick_enabled_)) {
+                return error;
+            }
+            return (target.*(spec->handler))(ctx);
+        }
 
-        /**
-         * @brief Recursively insert a route into the tree
-         * @param segments Path segments from SplitPath
-         * @param config Endpoint configuration to store at leaf
-         * @param idx Current segment index
-         * @param node Current tree node
-         * @return true if insertion successful
-         */
-        bool InsertRoute(const std::vector<std::string>& segments,
-                         const EndpointConfig& config,
-                         size_t idx, TreeNode* node);
+        [[nodiscard]] bool IsAutoTickEnabled() const noexcept {
+            return auto_tick_enabled_;
+        }
 
-        /**
-         * @brief Recursively match a request path against the tree
-         * @param segments Request path segments
-         * @param params Output map for extracted path parameters
-         * @param config Output pointer to matched endpoint configuration
-         * @param idx Current segment index
-         * @param node Current tree node
-         * @return true if a matching route was found
-         *
-         * Matching strategy:
-         * 1. Try exact static segment match first
-         * 2. If that fails, try parameter placeholder (if exists)
-         * 3. Backtrack if deeper matching fails
-         */
-        bool MatchRoute(const std::vector<std::string>& segments,
-                        std::unordered_map<std::string, std::string>& params,
-                        const EndpointConfig*& config,
-                        size_t idx, TreeNode* node) const;
+    private:
+        std::span<const Spec> routes_;
+        size_t static_count_;
+        bool auto_tick_enabled_;
+        std::vector<routing::RouteMetrics> route_metrics_;      ///< Parallel to routes_
     };
 
 } // namespace http_handler
@@ -0,0 +1,105 @@
+#include "cached_body.h"
+
+#include <cstdint>
+#include <tuple>
+
+namespace http_handler {
+
+namespace {
+
+// Strong ETag: quoted 64-bit FNV-1a hash of the body
+std::string MakeETag(std::string_view body) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const unsigned char c : body) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    constexpr std::string_view DIGITS = "0123456789abcdef";
+    std::string etag(18, '"');
+    for (int i = 16; i > 0; --i, hash >>= 4) {
+        etag[i] = DIGITS[hash & 0xf];
+    }
+    return etag;
+}
+
+std::string_view HeaderValue(const StringRequest& req, http::field field) {
+    auto header = req.find(field);
+    return header == req.end() ? std::string_view{} : std::string_view(header->value());
+}
+
+// If-None-Match: "*" or a comma separated list of (possibly weak) ETags, compared weakly (RFC 9110, 13.1.2)
+bool MatchesIfNoneMatch(std::string_view if_none_match, std::string_view etag) {
+    while (!if_none_match.empty()) {
+        const auto comma = if_none_match.find(',');
+        auto item = if_none_match.substr(0, comma);
+        if_none_match = comma == std::string_view::npos ? std::string_view{} : if_none_match.substr(comma + 1);
+
+        const auto first = item.find_first_not_of(" \t");
+        if (first == std::string_view::npos) {
+            continue;
+        }
+        item = item.substr(first, item.find_last_not_of(" \t") - first + 1);
+        if (item == "*") {
+            return true;
+        }
+        if (item.starts_with("W/")) {
+            item.remove_prefix(2);
+        }
+        if (item == etag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::shared_ptr<const CachedBody> CachedBody::Make(std::string body, int level) {
+    auto cached = std::make_shared<CachedBody>();
+    cached->etag = MakeETag(body);
+    auto variants = compression::GzipAndDeflate(body, level);
+    if (variants.gzip.size() < body.size()) {
+        cached->gzip_etag = MakeETag(variants.gzip);
+        cached->gzip = std::move(variants.gzip);
+    }
+    if (variants.deflate.size() < body.size()) {
+        cached->deflate_etag = MakeETag(variants.deflate);
+        cached->deflate = std::move(variants.deflate);
+    }
+    cached->identity = std::move(body);
+    return cached;
+}
+
+StringResponse CachedBody::MakeResponse(const StringRequest& req, std::string_view content_type) const {
+    const auto accept_encoding = HeaderValue(req, http::field::accept_encoding);
+    auto coding = compression::Coding::IDENTITY;
+    if (!gzip.empty() && compression::AcceptsEncoding(accept_encoding, compression::GZIP)) {
+        coding = compression::Coding::GZIP;
+    } else if (!deflate.empty() && compression::AcceptsEncoding(accept_encoding, compression::DEFLATE)) {
+        coding = compression::Coding::DEFLATE;
+    }
+    const auto& [variant, variant_etag] = coding == compression::Coding::GZIP    ? std::tie(gzip, gzip_etag)
+                                        : coding == compression::Coding::DEFLATE ? std::tie(deflate, deflate_etag)
+                                                                                 : std::tie(identity, etag);
+
+    auto builder = response::Builder::From(req);
+    builder.WithContentType(content_type)
+        .WithHeader(http::field::etag, variant_etag)
+        .WithHeader(http::field::vary, "Accept-Encoding"sv);
+
+    if (auto if_none_match = HeaderValue(req, http::field::if_none_match);
+        !if_none_match.empty() && MatchesIfNoneMatch(if_none_match, variant_etag)) {
+        return builder.WithStatus(http::status::not_modified).Build();
+    }
+    if (coding != compression::Coding::IDENTITY) {
+        builder.WithHeader(http::field::content_encoding, compression::CodingName(coding));
+        compression::RecordCompressed(coding, identity.size(), variant.size());
+    }
+
+    // Headers first, then a single copy of the shared body into the response
+    auto res = builder.Build();
+    res.body() = variant;
+    res.content_length(res.body().size());
+    return res;
+}
+
+} // namespace http_handler
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "compression.h"
+#include "http_response.h"
+
+namespace http_handler {
+
+// Response body built once and shared read-only between requests, with its compressed variants
+struct CachedBody {
+    std::string identity;
+    std::string gzip;           // empty if compression does not make the body smaller
+    std::string deflate;        // empty if compression does not make the body smaller
+    std::string etag;           // strong ETag of the identity body (quoted)
+    std::string gzip_etag;      // strong ETag of the gzip body (quoted)
+    std::string deflate_etag;   // strong ETag of the deflate body (quoted)
+
+    // Body -> body with its gzip / deflate variants (one compression pass) and ETags
+    static std::shared_ptr<const CachedBody> Make(std::string body, int level = compression::BEST_LEVEL);
+
+    // 304 if If-None-Match lists the ETag of the chosen variant, otherwise 200 with the body
+    // (gzip or deflate variant if Accept-Encoding allows it); every variant carries Vary: Accept-Encoding
+    [[nodiscard]] StringResponse MakeResponse(const StringRequest& req, std::string_view content_type) const;
+};
+
+using CachedBodyPtr = std::shared_ptr<const CachedBody>;
+
+} // namespace http_handler
@@ -0,0 +1,208 @@
+#include "compression.h"
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <zlib.h>
+
+#include "../common/metrics.h"
+
+namespace http_handler::compression {
+
+namespace {
+
+// Negative windowBits: raw deflate stream, the gzip / zlib framing is added by WrapGzip / WrapZlib
+constexpr int RAW_WINDOW_BITS = -15;
+constexpr int MEMORY_LEVEL = 8;
+
+Settings settings;
+
+std::string RawDeflate(std::string_view data, int level) {
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, RAW_WINDOW_BITS, MEMORY_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("Failed to initialise deflate stream");
+    }
+
+    std::string result(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(result.data());
+    stream.avail_out = static_cast<uInt>(result.size());
+
+    // deflateBound guarantees a single Z_FINISH call completes the stream
+    const int status = deflate(&stream, Z_FINISH);
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+    if (status != Z_STREAM_END) {
+        throw std::runtime_error("Failed to deflate response body");
+    }
+    return result;
+}
+
+void AppendLittleEndian(std::string& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i, value >>= 8) {
+        out.push_back(static_cast<char>(value & 0xff));
+    }
+}
+
+void AppendBigEndian(std::string& out, std::uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xff));
+    }
+}
+
+// RFC 1952: 10-byte header (no name, no mtime), deflate data, CRC-32 and size of the input
+std::string WrapGzip(std::string_view data, std::string_view raw, int level) {
+    const char extra_flags = level == BEST_LEVEL ? 2 : level == FAST_LEVEL ? 4 : 0;
+    constexpr char OS_UNIX = 3;
+    std::string result{'\x1f', '\x8b', Z_DEFLATED, 0, 0, 0, 0, 0, extra_flags, OS_UNIX};
+    result.reserve(result.size() + raw.size() + 8);
+    result.append(raw);
+    AppendLittleEndian(result, static_cast<std::uint32_t>(
+        crc32(0, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size()))));
+    AppendLittleEndian(result, static_cast<std::uint32_t>(data.size()));
+    return result;
+}
+
+// RFC 1950: 2-byte header (32K window, level hint, check bits), deflate data, Adler-32 of the input
+std::string WrapZlib(std::string_view data, std::string_view raw, int level) {
+    constexpr unsigned CMF = 0x78;
+    const unsigned level_hint = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    unsigned flags = level_hint << 6;
+    flags += 31 - (CMF * 256 + flags) % 31;
+    std::string result{static_cast<char>(CMF), static_cast<char>(flags)};
+    result.reserve(result.size() + raw.size() + 4);
+    result.append(raw);
+    AppendBigEndian(result, static_cast<std::uint32_t>(
+        adler32(1, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size()))));
+    return result;
+}
+
+struct CodingMetrics {
+    metrics::Counter& responses;
+    metrics::Counter& saved_bytes;
+};
+
+CodingMetrics MakeCodingMetrics(std::string_view coding) {
+    auto& registry = metrics::Registry::Instance();
+    const auto labels = "coding=\"" + std::string(coding) + "\"";
+    return {registry.GetCounter("http_compressed_responses_total", "Responses sent with a compressed body", labels),
+            registry.GetCounter("http_compression_saved_bytes_total",
+                                "Response body bytes saved by compression (identity size - encoded size)", labels)};
+}
+
+std::string_view Trim(std::string_view str) {
+    const auto first = str.find_first_not_of(" \t");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    const auto last = str.find_last_not_of(" \t");
+    return str.substr(first, last - first + 1);
+}
+
+// "q=0", "q=0.0", "q=0.000" disable a coding; anything else (or no q) allows it
+bool IsZeroQuality(std::string_view params) {
+    const auto pos = params.find("q=");
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+    const auto value = Trim(params.substr(pos + 2));
+    return !value.empty() && value.find_first_not_of("0.") == std::string_view::npos;
+}
+
+} // namespace
+
+std::string_view CodingName(Coding coding) noexcept {
+    switch (coding) {
+        case Coding::GZIP:
+            return GZIP;
+        case Coding::DEFLATE:
+            return DEFLATE;
+        case Coding::IDENTITY:
+            break;
+    }
+    return {};
+}
+
+std::string Gzip(std::string_view data, int level) {
+    return WrapGzip(data, RawDeflate(data, level), level);
+}
+
+std::string Deflate(std::string_view data, int level) {
+    return WrapZlib(data, RawDeflate(data, level), level);
+}
+
+Variants GzipAndDeflate(std::string_view data, int level) {
+    const auto raw = RawDeflate(data, level);
+    return {WrapGzip(data, raw, level), WrapZlib(data, raw, level)};
+}
+
+std::string Compress(std::string_view data, Coding coding, int level) {
+    switch (coding) {
+        case Coding::GZIP:
+            return Gzip(data, level);
+        case Coding::DEFLATE:
+            return Deflate(data, level);
+        case Coding::IDENTITY:
+            break;
+    }
+    return std::string(data);
+}
+
+bool AcceptsEncoding(std::string_view accept_encoding, std::string_view coding) {
+    bool wildcard = false;
+    while (!accept_encoding.empty()) {
+        const auto comma = accept_encoding.find(',');
+        const auto item = accept_encoding.substr(0, comma);
+        accept_encoding = comma == std::string_view::npos ? std::string_view{} : accept_encoding.substr(comma + 1);
+
+        const auto semicolon = item.find(';');
+        const auto name = Trim(item.substr(0, semicolon));
+        const bool allowed = semicolon == std::string_view::npos || !IsZeroQuality(item.substr(semicolon + 1));
+        // An explicit entry wins over "*"
+        if (boost::algorithm::iequals(name, coding)) {
+            return allowed;
+        }
+        if (name == "*") {
+            wildcard = allowed;
+        }
+    }
+    return wildcard;
+}
+
+Coding Negotiate(std::string_view accept_encoding) {
+    if (accept_encoding.empty()) {
+        return Coding::IDENTITY;
+    }
+    if (AcceptsEncoding(accept_encoding, GZIP)) {
+        return Coding::GZIP;
+    }
+    if (AcceptsEncoding(accept_encoding, DEFLATE)) {
+        return Coding::DEFLATE;
+    }
+    return Coding::IDENTITY;
+}
+
+void Configure(const Settings& new_settings) noexcept {
+    settings = new_settings;
+}
+
+const Settings& GetSettings() noexcept {
+    return settings;
+}
+
+void RecordCompressed(Coding coding, std::size_t identity_size, std::size_t encoded_size) noexcept {
+    static const std::array<CodingMetrics, 2> coding_metrics{MakeCodingMetrics(GZIP), MakeCodingMetrics(DEFLATE)};
+    if (coding == Coding::IDENTITY) {
+        return;
+    }
+    const auto& m = coding_metrics[coding == Coding::GZIP ? 0 : 1];
+    m.responses.Inc();
+    if (encoded_size < identity_size) {
+        m.saved_bytes.Inc(identity_size - encoded_size);
+    }
+}
+
+} // namespace http_handler::compression
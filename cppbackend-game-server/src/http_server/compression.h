@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace http_handler::compression {
+
+// Content codings understood by the server (HTTP names)
+constexpr inline std::string_view GZIP = "gzip";
+constexpr inline std::string_view DEFLATE = "deflate";
+
+// zlib levels: 1 (fast) .. 9 (smallest)
+constexpr inline int FAST_LEVEL = 1;
+constexpr inline int BEST_LEVEL = 9;
+
+enum class Coding {
+    IDENTITY,
+    GZIP,
+    DEFLATE,
+};
+
+// HTTP name of the coding (empty for IDENTITY)
+std::string_view CodingName(Coding coding) noexcept;
+
+// Whole-buffer gzip (RFC 1952) compression with zlib. Throws std::runtime_error if zlib fails.
+std::string Gzip(std::string_view data, int level = BEST_LEVEL);
+
+// Whole-buffer HTTP "deflate" - the zlib format (RFC 1950). Throws std::runtime_error if zlib fails.
+std::string Deflate(std::string_view data, int level = BEST_LEVEL);
+
+// Both variants from a single deflate pass - they differ only in their header and checksum
+struct Variants {
+    std::string gzip;
+    std::string deflate;
+};
+Variants GzipAndDeflate(std::string_view data, int level = BEST_LEVEL);
+
+std::string Compress(std::string_view data, Coding coding, int level);
+
+// Whether an Accept-Encoding header value allows the coding: listed by name or as "*", with q > 0
+bool AcceptsEncoding(std::string_view accept_encoding, std::string_view coding);
+
+// Coding for the response to a request with this Accept-Encoding: gzip, otherwise deflate, otherwise identity
+Coding Negotiate(std::string_view accept_encoding);
+
+// Compression of responses built on the fly (response::Builder). Set once at startup, before serving.
+struct Settings {
+    bool enabled = false;
+    std::size_t min_size = 1024;    ///< Smaller bodies are sent as they are
+    int level = FAST_LEVEL;
+};
+
+void Configure(const Settings& settings) noexcept;
+[[nodiscard]] const Settings& GetSettings() noexcept;
+
+// Metrics of a compressed body sent: responses per coding and bytes saved against the identity body
+void RecordCompressed(Coding coding, std::size_t identity_size, std::size_t encoded_size) noexcept;
+
+} // namespace http_handler::compression
@@ -9,6 +9,11 @@ Builder Builder::From(const StringRequest& req) {
     Builder builder;
     builder.response_.keep_alive(req.keep_alive());
     builder.response_.version(req.version());
+    if (compression::GetSettings().enabled) {
+        if (auto accept_encoding = req.find(http::field::accept_encoding); accept_encoding != req.end()) {
+            builder.accepted_coding_ = compression::Negotiate(accept_encoding->value());
+        }
+    }
     return builder;
 }
 
@@ -81,8 +86,34 @@ Builder& Builder::WithAllow(std::string_view allow) {
     return *this;
 }
 
+Builder& Builder::WithHeader(http::field field, std::string_view value) {
+    response_.set(field, std::string(value));
+    return *this;
+}
+
 StringResponse Builder::Build() const {
-    return response_;
+    const auto& settings = compression::GetSettings();
+    // Error bodies are small and read by the shard front, bodies set after Build() are not seen here
+    if (!settings.enabled || response_.body().size() < settings.min_size
+        || http::to_status_class(response_.result()) != http::status_class::successful
+        || response_.count(http::field::content_encoding) != 0) {
+        return response_;
+    }
+
+    StringResponse res = response_;
+    res.set(http::field::vary, "Accept-Encoding"sv);
+    if (accepted_coding_ == compression::Coding::IDENTITY) {
+        return res;
+    }
+    auto encoded = compression::Compress(res.body(), accepted_coding_, settings.level);
+    if (encoded.size() >= res.body().size()) {
+        return res;
+    }
+    compression::RecordCompressed(accepted_coding_, res.body().size(), encoded.size());
+    res.set(http::field::content_encoding, compression::CodingName(accepted_coding_));
+    res.body() = std::move(encoded);
+    res.content_length(res.body().size());
+    return res;
 }
 
 StringResponse Builder::MakeJson(const StringRequest& req, const json::value& json, http::status status) {
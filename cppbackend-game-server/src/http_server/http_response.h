@@ -2,6 +2,7 @@
 
 #include <boost/json.hpp>
 
+#include "compression.h"
 #include "http_server.h"    // boost includings
 #include "../common/constants.h"
 
@@ -43,11 +44,15 @@ public:
     Builder& WithVersion(unsigned version);
     Builder& WithCacheControl(std::string_view cache_control);
     Builder& WithAllow(std::string_view allow);
+    Builder& WithHeader(http::field field, std::string_view value);
 
     // Build the response
     // If not explicitly set than default values:
     // http::status::ok, http-version = 11, http::field::content_type = "text/html", keep_alive = true,
     // http::field::cache_control = "no-cache"
+    // With compression enabled (compression::Configure) a successful response of a builder made by From(req)
+    // gets Vary: Accept-Encoding and, if the request accepts gzip / deflate, a compressed body -
+    // unless the body is below the size threshold, already encoded or compression does not make it smaller
     StringResponse Build() const;
 
     // Direct build methods (for common patterns)
@@ -58,6 +63,9 @@ public:
                                    http::status status = http::status::ok);
 
 private:
+    // Coding the request accepts (IDENTITY if compression is disabled or the builder is not made from a request)
+    compression::Coding accepted_coding_ = compression::Coding::IDENTITY;
+
     // Internal state
     StringResponse response_ = [] {
         StringResponse r(http::status::ok, common_values::VERSION);
@@ -22,6 +22,8 @@ void SessionBase::Run() {
 void SessionBase::Read() {
     // Очищаем запрос от прежнего значения (метод Read может быть вызван несколько раз)
     request_ = {};
+    // Предыдущий ответ уже отправлен - всё, что было выделено в арене для него, больше не используется
+    arena_.Reset();
     stream_.expires_after(30s);
     // Считываем request_ из stream_, используя buffer_ для хранения считанных данных
     http::async_read(stream_, buffer_, request_,
@@ -9,6 +9,9 @@
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 
+#include "../common/io_shards.h"
+#include "request_arena.h"
+
 // Ядро асинхронного HTTP-сервера будет располагаться в пространстве имён http_server
 namespace http_server {
 
@@ -19,6 +22,35 @@ namespace http_server {
     namespace sys = boost::system;
     using Strand = net::strand<net::io_context::executor_type>;
 
+#if defined(SO_REUSEPORT)
+    // Позволяет нескольким acceptor'ам слушать один и тот же порт (балансировка ядром ОС).
+    // Своя опция по требованиям SettableSocketOption Asio (level/name/data/size) - без net::detail
+    class reuse_port {
+    public:
+        explicit reuse_port(bool enabled) noexcept
+            : value_(enabled ? 1 : 0) {
+        }
+
+        template <typename Protocol>
+        int level(const Protocol&) const noexcept { return SOL_SOCKET; }
+
+        template <typename Protocol>
+        int name(const Protocol&) const noexcept { return SO_REUSEPORT; }
+
+        template <typename Protocol>
+        const void* data(const Protocol&) const noexcept { return &value_; }
+
+        template <typename Protocol>
+        std::size_t size(const Protocol&) const noexcept { return sizeof(value_); }
+
+    private:
+        int value_;
+    };
+    inline constexpr bool REUSE_PORT_SUPPORTED = true;
+#else
+    inline constexpr bool REUSE_PORT_SUPPORTED = false;
+#endif
+
 void ReportError(beast::error_code ec, std::string_view what);
 
 class SessionBase {
@@ -51,11 +83,17 @@ protected:
         return stream_;
     }
 
+    // Арена текущего запроса: сбрасывается перед чтением следующего запроса
+    RequestArena& GetArena() noexcept {
+        return arena_;
+    }
+
 private:
     // tcp_stream содержит внутри себя сокет и добавляет поддержку таймаутов
     beast::tcp_stream stream_;
     beast::flat_buffer buffer_;
     HttpRequest request_;
+    RequestArena arena_;
 
     void Read();
 
@@ -89,8 +127,10 @@ private:
     void HandleRequest(HttpRequest&& request) override {
         auto endpoint = GetStream().socket().remote_endpoint();
 
-        // Pass endpoint and request to handler (logging is now in LoggingRequestHandler)
-        request_handler_(std::move(endpoint), std::move(request),
+        // Pass endpoint, request and per-session arena to handler (logging is now in LoggingRequestHandler).
+        // Handler must destroy everything allocated from the arena before calling send:
+        // the arena is reset as soon as the response is written.
+        request_handler_(std::move(endpoint), std::move(request), GetArena(),
                          [self = this->shared_from_this()](auto&& response) {
                              self->Write(std::move(response));
                          });
@@ -101,7 +141,8 @@ template <typename RequestHandler>
 class Listener : public std::enable_shared_from_this<Listener<RequestHandler>> {
 public:
     template <typename Handler>
-    Listener(net::io_context& ioc, const tcp::endpoint& endpoint, Handler&& request_handler)
+    Listener(net::io_context& ioc, const tcp::endpoint& endpoint, Handler&& request_handler,
+             bool reuse_port = false)
         : ioc_(ioc)
         // Обработчики асинхронных операций acceptor_ будут вызываться в своём strand
         , acceptor_(net::make_strand(ioc))
@@ -114,6 +155,15 @@ public:
         // Однако это может помешать повторно открыть сокет в полузакрытом состоянии.
         // Флаг reuse_address разрешает открыть сокет, когда он "наполовину закрыт"
         acceptor_.set_option(net::socket_base::reuse_address(true));
+#if defined(SO_REUSEPORT)
+        // Каждый шард открывает собственный acceptor на том же порту,
+        // ядро распределяет входящие соединения между ними
+        if (reuse_port) {
+            acceptor_.set_option(http_server::reuse_port(true));
+        }
+#else
+        (void)reuse_port;
+#endif
         // Привязываем acceptor к адресу и порту endpoint
         acceptor_.bind(endpoint);
         // Переводим acceptor в состояние, в котором он способен принимать новые соединения
@@ -183,4 +233,27 @@ void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandl
     std::make_shared<MyListener>(ioc, endpoint, std::forward<RequestHandler>(handler))->Run();
 }
 
+/**
+ * @brief Start one acceptor per io_context shard on the same endpoint (SO_REUSEPORT)
+ *
+ * Every shard gets its own Listener bound with SO_REUSEPORT, so the kernel spreads
+ * incoming connections across shards and a connection's whole lifetime (accept, read,
+ * parse, write) stays on the shard's thread. Without SO_REUSEPORT support
+ * (or with a single shard) falls back to a single listener on the primary shard.
+ */
+template <typename RequestHandler>
+void ServeHttpSharded(io_shards::IoContextShards& shards, const tcp::endpoint& endpoint, RequestHandler&& handler) {
+    using MyListener = Listener<std::decay_t<RequestHandler>>;
+
+    if (!REUSE_PORT_SUPPORTED || !shards.IsSharded()) {
+        ServeHttp(shards.Primary(), endpoint, std::forward<RequestHandler>(handler));
+        return;
+    }
+
+    for (size_t i = 0; i < shards.Size(); ++i) {
+        // Обработчик копируется в каждый Listener (обычно это лёгкая обёртка над shared_ptr)
+        std::make_shared<MyListener>(shards.Get(i), endpoint, handler, true)->Run();
+    }
+}
+
 }  // namespace http_server
@@ -1,34 +1,49 @@
 #pragma once
 
 #include "request_handler.h"    // boost #includes
+#include "../common/async_logger.h"
 #include "../common/boost_logger.h"
 
 namespace server_logging {
 
+// async_log - optional asynchronous backend (nullptr - log synchronously via Boost.Log)
 template <typename Handler>
 class LoggingRequestHandler {
 public:
-    explicit LoggingRequestHandler(Handler handler)
+    explicit LoggingRequestHandler(Handler handler, async_logger::AsyncLogger* async_log = nullptr)
         : handler_(std::move(handler))
+        , async_log_(async_log)
     {
     }
 
     template <typename Body, typename Allocator, typename Send>
-    void operator()(boost::asio::ip::tcp::endpoint endpoint, boost::beast::http::request<Body, boost::beast::http::basic_fields<Allocator>>&& req, Send&& send) {
-        // Log request
-        boost_logger::LogRequestReceived(
-            endpoint.address().to_string(),
-            std::string(req.target()),
-            std::string(req.method_string())
-            );
+    void operator()(boost::asio::ip::tcp::endpoint endpoint, boost::beast::http::request<Body, boost::beast::http::basic_fields<Allocator>>&& req,
+                    http_server::RequestArena& arena, Send&& send) {
+        // Log request (the response shares the sampling decision)
+        async_logger::AsyncLogger* async_log = async_log_;
+        const bool log_enabled = !async_log || async_log->Sample();
+        if (async_log && log_enabled) {
+            async_log->LogRequestReceived(endpoint.address(), req.target(), req.method_string());
+        } else if (log_enabled) {
+            boost_logger::LogRequestReceived(
+                endpoint.address().to_string(),
+                req.target(),
+                req.method_string()
+                );
+        }
 
         auto start_time = std::chrono::steady_clock::now();
 
         try {
             // Call the actual handler
-            handler_(std::move(endpoint), std::move(req),
-                     [send = std::forward<Send>(send), start_time]
+            handler_(std::move(endpoint), std::move(req), arena,
+                     [send = std::forward<Send>(send), start_time, async_log, log_enabled]
                      (auto&& response) mutable {
+                         if (!log_enabled) {
+                             send(std::forward<decltype(response)>(response));
+                             return;
+                         }
+
                          // Calculate response time
                          auto end_time = std::chrono::steady_clock::now();
                          auto response_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -36,17 +51,21 @@ public:
                                                      .count();
 
                          // Extract content type
-                         std::string content_type = "";
-                         if (response.find(boost::beast::http::field::content_type) != response.end()) {
-                             content_type = std::string(response[boost::beast::http::field::content_type]);
+                         std::string_view content_type;
+                         if (auto it = response.find(boost::beast::http::field::content_type); it != response.end()) {
+                             content_type = it->value();
                          }
 
                          // Log response
-                         boost_logger::LogResponseSent(
-                             response_time_ms,
-                             response.result_int(),
-                             content_type
-                             );
+                         if (async_log) {
+                             async_log->LogResponseSent(response_time_ms, response.result_int(), content_type);
+                         } else {
+                             boost_logger::LogResponseSent(
+                                 response_time_ms,
+                                 response.result_int(),
+                                 content_type
+                                 );
+                         }
 
                          // Send response
                          send(std::forward<decltype(response)>(response));
@@ -58,6 +77,7 @@ public:
 
 private:
     Handler handler_;
+    async_logger::AsyncLogger* async_log_;
 };
 
 } // namespace server_logging
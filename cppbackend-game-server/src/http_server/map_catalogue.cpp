@@ -0,0 +1,28 @@
+#include "map_catalogue.h"
+
+#include "serialize_api.h"
+
+namespace http_handler {
+
+MapCatalogue::MapCatalogue(const model::Game& game) {
+    const auto* extra_data = game.GetGameExtraData().get();
+    json::array maps_array;
+    for (const auto& map : game.GetMaps()) {
+        maps_array.push_back(serialize_api::SerializeMapBrief(map));
+        maps_.emplace(*map.GetId(), CachedBody::Make(json::serialize(serialize_api::SerializeMapFull(map, extra_data))));
+    }
+    maps_list_ = CachedBody::Make(json::serialize(maps_array));
+}
+
+CachedBodyPtr MapCatalogue::FindMap(std::string_view id) const {
+    if (auto it = maps_.find(id); it != maps_.end()) {
+        return it->second;
+    }
+    return nullptr;
+}
+
+StringResponse MapCatalogue::MakeResponse(const StringRequest& req, const CachedBody& body) {
+    return body.MakeResponse(req, ContentType::APPLICATION_JSON);
+}
+
+} // namespace http_handler
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "cached_body.h"
+#include "http_response.h"
+#include "../game_model/game_model.h"
+
+namespace http_handler {
+
+// Map catalogue (/api/v1/maps, /api/v1/maps/:id) pre-serialized at startup.
+// Maps and loot types never change after json_loader::LoadGame, so every body is built once
+// and requests only pick a variant and copy it out.
+class MapCatalogue {
+public:
+    explicit MapCatalogue(const model::Game& game);
+
+    [[nodiscard]] const CachedBodyPtr& GetMapsList() const noexcept {
+        return maps_list_;
+    }
+
+    // nullptr if there is no such map
+    [[nodiscard]] CachedBodyPtr FindMap(std::string_view id) const;
+
+    // JSON response of a catalogue body (see CachedBody::MakeResponse)
+    static StringResponse MakeResponse(const StringRequest& req, const CachedBody& body);
+
+private:
+    CachedBodyPtr maps_list_;
+    std::map<std::string, CachedBodyPtr, std::less<>> maps_;
+};
+
+} // namespace http_handler
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <boost/json.hpp>
+
+namespace http_server {
+
+/**
+ * @brief Per-session bump allocator for short-lived request data
+ *
+ * Owned by each HTTP session and reset after every response is written, so the JSON
+ * allocated while one request is handled (parsed request body, JSON DOM of the response)
+ * comes from a monotonic buffer instead of the global heap (JsonStorage()).
+ * Path parameters are views into the request target and need no allocation.
+ *
+ * The resource starts with an inline buffer and falls back to the heap only when
+ * a request needs more; Reset() returns it to the inline buffer.
+ *
+ * Not thread-safe: a session handles one request at a time, and the arena is only
+ * touched by the code that processes that request (session strand -> API strand -> session strand).
+ */
+class RequestArena {
+public:
+    static constexpr std::size_t JSON_BUFFER_SIZE = 16 * 1024;
+
+    RequestArena()
+        : json_resource_(json_buffer_.data(), json_buffer_.size())
+    {}
+
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    // Non-owning storage pointer: JSON values allocated here must not outlive the request
+    [[nodiscard]] boost::json::storage_ptr JsonStorage() noexcept {
+        return boost::json::storage_ptr(&json_resource_);
+    }
+
+    // Releases everything allocated since the previous reset (call only when no request data is alive)
+    void Reset() noexcept {
+        json_resource_.release();
+    }
+
+private:
+    alignas(std::max_align_t) std::array<std::byte, JSON_BUFFER_SIZE> json_buffer_;
+    boost::json::monotonic_resource json_resource_;
+};
+
+} // namespace http_server
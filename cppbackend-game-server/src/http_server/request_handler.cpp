@@ -33,7 +33,8 @@ void RequestHandler::DumpRequest(const StringRequest &req) const {
  * 5. If path points to directory, append index.html
  * 6. Verify the final path is still within www_root (security)
  * 7. Check if file exists and is readable
- * 8. Read entire file and send with correct MIME type
+ * 8. Read entire file and send with correct MIME type; with compression enabled the file comes
+ *    from StaticFileCache (read and compressed once, gzip / deflate negotiated, ETag and 304)
  *
  * Security considerations:
  * - Uses weakly_canonical to resolve symlinks and normalize paths
@@ -83,6 +84,12 @@ StringResponse RequestHandler::HandleFileRequest(const StringRequest &req) const
 
     // Step 8: Read and serve the file
     try {
+        if (compression::GetSettings().enabled) {
+            if (auto body = static_files_.Get(file_path)) {
+                return body->MakeResponse(req, utils::http::GetMimeType(file_path));
+            }
+        }
+
         // Open file in binary mode to preserve exact content
         std::ifstream file(file_path.string(), std::ios::binary);
         if (!file) {
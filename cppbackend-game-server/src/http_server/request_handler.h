@@ -6,6 +6,8 @@
 #include "api_handler.h"
 #include "../game_app/application.h"
 #include "http_response.h"
+#include "static_file_cache.h"
+#include "../common/metrics.h"
 #include "../common/ticker.h"
 
 namespace http_handler {
@@ -43,7 +45,10 @@ public:
     , api_handler_{app_}                    // API endpoint router
     {
         // Initialize ticker - required if auto-tick is enabled
-        ticker_ = std::make_shared<tick::Ticker>(api_strand_, std::chrono::milliseconds(app_.GetCmdArgs().tick_period),
+        const auto& args = app_.GetCmdArgs();
+        ticker_ = std::make_shared<tick::Ticker>(api_strand_,
+                                                tick::TickerOptions{std::chrono::milliseconds(args.tick_period),
+                                                                    args.fixed_step, args.max_catch_up},
                                                 [this](std::chrono::milliseconds delta)
                                                 {
                                                     this->app_.Tick(delta);
@@ -61,6 +66,7 @@ public:
      * @tparam Allocator Allocator type
      * @tparam Send Callback type for sending response
      * @param req The incoming HTTP request
+     * @param arena Per-session arena for request-scoped allocations (reset after the response is written)
      * @param send Function to call with the response
      *
      * This is the core request handling logic:
@@ -71,7 +77,7 @@ public:
      * 5. Catch and handle any exceptions, returning appropriate error responses
      */
     template <typename Body, typename Allocator, typename Send>
-    void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send) {
+    void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, http_server::RequestArena& arena, Send&& send) {
 
         // Start ticker if auto-tick is enabled (safe to call multiple times)
         if (app_.GetCmdArgs().tick_period != common_values::NO_AUTO_TICK) {
@@ -81,18 +87,25 @@ public:
         try {
             // Check if this is an API request (starts with /api)
             if (ApiHandler::IsApiRequest(req)) {
+                // Player actions leave an intent for the next tick - answered right here, without the strand hop
+                if (api_handler_.IsOffStrandRequest(req)) {
+                    return send(api_handler_.HandleApiRequest(std::move(req), &arena));
+                }
                 // API requests must be processed sequentially through the strand
                 // to avoid race conditions on game state
+                strand_queue_depth_.Add();
                 auto handle = [self = this->shared_from_this(),
+                               arena = &arena,
                                send = std::forward<decltype(send)>(send),
                                req = std::forward<decltype(req)>(req)]() mutable
                                 {
+                                    self->strand_queue_depth_.Sub();
                                     try {
                                         // Verify we're running inside the strand (debug assertion)
                                         assert(self->api_strand_.running_in_this_thread());
 
                                         // Process API request and send response
-                                        return send(self->api_handler_.HandleApiRequest(std::move(req)));
+                                        return send(self->api_handler_.HandleApiRequest(std::move(req), arena));
                                     } catch (std::exception& e) {
                                         // Handle specific exceptions from API handler
                                         send(
@@ -134,9 +147,12 @@ private:
     net::io_context& ioc_;          ///< Boost.Asio context for async ops
     model::Game& game_;             ///< Game model (maps, sessions)
     std::filesystem::path static_files_root_;   ///< Root directory for static files
+    mutable StaticFileCache static_files_;      ///< Files compressed once (used with compression enabled)
     http_server::Strand api_strand_;            ///< Strand to serialize API requests
     ApiHandler api_handler_;                    ///< API endpoint router
     std::shared_ptr<tick::Ticker> ticker_;      ///< Periodic timer for game updates
+    metrics::Gauge& strand_queue_depth_ = metrics::Registry::Instance().GetGauge(
+        "api_strand_queue_depth", "API requests waiting for the API strand");   ///< Dispatched, not yet started
 
 
     /**
@@ -0,0 +1,116 @@
+#include "request_json.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "../common/constants.h"
+
+namespace http_handler::request_json {
+
+namespace {
+
+// Cursor over a request body; every method skips the JSON whitespace in front of its token
+class Scanner {
+public:
+    explicit Scanner(std::string_view text) noexcept
+        : text_(text)
+    {}
+
+    bool Consume(char c) noexcept {
+        SkipSpace();
+        if (pos_ == text_.size() || text_[pos_] != c) {
+            return false;
+        }
+        ++pos_;
+        return true;
+    }
+
+    // Plain string only: a byte that needs decoding or UTF-8 validation ends the fast path
+    bool String(std::string_view& out) noexcept {
+        if (!Consume('"')) {
+            return false;
+        }
+        const size_t begin = pos_;
+        for (; pos_ < text_.size(); ++pos_) {
+            const auto c = static_cast<unsigned char>(text_[pos_]);
+            if (c == '"') {
+                out = text_.substr(begin, pos_ - begin);
+                ++pos_;
+                return true;
+            }
+            if (c < 0x20 || c >= 0x80 || c == '\\') {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool AtEnd() noexcept {
+        SkipSpace();
+        return pos_ == text_.size();
+    }
+
+private:
+    std::string_view text_;
+    size_t pos_ = 0;
+
+    void SkipSpace() noexcept {
+        while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' ||
+                                       text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            ++pos_;
+        }
+    }
+};
+
+// values[i] - value of keys[i]; false if the body has other members, a key twice or a non-string value
+template <size_t N>
+bool ParseStringMembers(std::string_view body, const std::array<std::string_view, N>& keys,
+                        std::array<std::string_view, N>& values) noexcept {
+    static_assert(N <= 32);
+    Scanner scanner(body);
+    if (!scanner.Consume('{')) {
+        return false;
+    }
+    std::uint32_t seen = 0;
+    for (size_t i = 0; i < N; ++i) {
+        std::string_view key;
+        std::string_view value;
+        if ((i != 0 && !scanner.Consume(',')) || !scanner.String(key) || !scanner.Consume(':') || !scanner.String(value)) {
+            return false;
+        }
+        const auto it = std::find(keys.begin(), keys.end(), key);
+        if (it == keys.end()) {
+            return false;
+        }
+        const auto bit = std::uint32_t{1} << (it - keys.begin());
+        if (seen & bit) {
+            return false;
+        }
+        seen |= bit;
+        values[it - keys.begin()] = value;
+    }
+    return scanner.Consume('}') && scanner.AtEnd();
+}
+
+} // namespace
+
+std::optional<JoinBody> ParseJoinBody(std::string_view body) noexcept {
+    static constexpr std::array<std::string_view, 2> KEYS{json_fields::USER_NAME, json_fields::MAP_ID};
+    std::array<std::string_view, 2> values;
+    if (!ParseStringMembers(body, KEYS, values)) {
+        return std::nullopt;
+    }
+    return JoinBody{values[0], values[1]};
+}
+
+std::optional<std::string_view> ParseActionBody(std::string_view body) noexcept {
+    static constexpr std::array<std::string_view, 1> KEYS{json_fields::MOVE};
+    std::array<std::string_view, 1> values;
+    if (!ParseStringMembers(body, KEYS, values)) {
+        return std::nullopt;
+    }
+    return values[0];
+}
+
+} // namespace http_handler::request_json
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+namespace http_handler::request_json {
+
+// Fast path for the fixed request bodies of the hot endpoints: a flat object whose members are exactly
+// the expected keys (any order, each once) with plain string values - printable ASCII without escapes.
+// No DOM is built and nothing is allocated; the results are views into the body.
+// nullopt - the body is not of that plain shape (escapes, non-ASCII names, extra members, invalid JSON);
+// the caller falls back to the generic parser, which accepts or rejects it as before.
+
+struct JoinBody {
+    std::string_view user_name;
+    std::string_view map_id;
+};
+
+// {"userName": "...", "mapId": "..."}
+std::optional<JoinBody> ParseJoinBody(std::string_view body) noexcept;
+
+// {"move": "L"} - the move value is not checked here (see utils::StringToDirection2D)
+std::optional<std::string_view> ParseActionBody(std::string_view body) noexcept;
+
+} // namespace http_handler::request_json
@@ -3,8 +3,8 @@
 
 namespace serialize_api {
 
-json::value SerializeRoad(const model::Road &road) {
-    json::object road_obj;
+json::value SerializeRoad(const model::Road &road, json::storage_ptr sp) {
+    json::object road_obj(sp);
     road_obj[json_fields::X0] = road.GetStart().x;
     road_obj[json_fields::Y0] = road.GetStart().y;
 
@@ -17,8 +17,8 @@ json::value SerializeRoad(const model::Road &road) {
     return road_obj;
 }
 
-json::value SerializeBuilding(const model::Building &building) {
-    json::object building_obj;
+json::value SerializeBuilding(const model::Building &building, json::storage_ptr sp) {
+    json::object building_obj(sp);
     const auto& bounds = building.GetBounds();
 
     building_obj[json_fields::X] = bounds.position.x;
@@ -29,12 +29,12 @@ json::value SerializeBuilding(const model::Building &building) {
     return building_obj;
 }
 
-json::value SerializeOffice(const model::Office &office) {
-    json::object office_obj;
+json::value SerializeOffice(const model::Office &office, json::storage_ptr sp) {
+    json::object office_obj(sp);
     const auto& offset = office.GetOffset();
     const auto& position = office.GetPosition();
 
-    office_obj[json_fields::ID] = std::string(*office.GetId());
+    office_obj[json_fields::ID] = *office.GetId();
     office_obj[json_fields::X] = position.x;
     office_obj[json_fields::Y] = position.y;
     office_obj[json_fields::OFFSET_X] = offset.dx;
@@ -43,8 +43,8 @@ json::value SerializeOffice(const model::Office &office) {
     return office_obj;
 }
 
-json::object SerializeLoot(const extra_data::LootData& loot) {
-    json::object obj;
+json::object SerializeLoot(const extra_data::LootData& loot, json::storage_ptr sp) {
+    json::object obj(sp);
     if (loot.name.empty() || loot.file.empty() || loot.type.empty() || loot.scale == 0.0) {
         throw std::invalid_argument("SerializeLoot: Invalid Loot");
     }
@@ -63,47 +63,51 @@ json::object SerializeLoot(const extra_data::LootData& loot) {
     return obj;
 }
 
-json::array SerializeLootTypes(const std::vector<extra_data::LootData>& loots) {
-    json::array arr;
+json::array SerializeLootTypes(const std::vector<extra_data::LootData>& loots, json::storage_ptr sp) {
+    json::array arr(sp);
+    arr.reserve(loots.size());
     for (const auto& loot : loots) {
-        arr.push_back(SerializeLoot(loot));
+        arr.push_back(SerializeLoot(loot, sp));
     }
     return arr;
 }
 
-json::value SerializeMapBrief(const model::Map &map) {
-    json::object map_obj;
-    map_obj[json_fields::ID] = std::string(*map.GetId());
+json::value SerializeMapBrief(const model::Map &map, json::storage_ptr sp) {
+    json::object map_obj(sp);
+    map_obj[json_fields::ID] = *map.GetId();
     map_obj[json_fields::NAME] = map.GetName();
     return map_obj;
 }
 
-json::value SerializeMapFull(const model::Map &map, const extra_data::GameExtraData* extra_data) {
-    json::object map_obj;
-    map_obj[json_fields::ID] = std::string(*map.GetId());
+json::value SerializeMapFull(const model::Map &map, const extra_data::GameExtraData* extra_data, json::storage_ptr sp) {
+    json::object map_obj(sp);
+    map_obj[json_fields::ID] = *map.GetId();
     map_obj[json_fields::NAME] = map.GetName();
 
-    json::array roads_array;
+    json::array roads_array(sp);
+    roads_array.reserve(map.GetRoads().size());
     for (const auto& road : map.GetRoads()) {
-        roads_array.push_back(SerializeRoad(road));
+        roads_array.push_back(SerializeRoad(road, sp));
     }
     map_obj[json_fields::ROADS] = std::move(roads_array);
 
-    json::array buildings_array;
+    json::array buildings_array(sp);
+    buildings_array.reserve(map.GetBuildings().size());
     for (const auto& building : map.GetBuildings()) {
-        buildings_array.push_back(SerializeBuilding(building));
+        buildings_array.push_back(SerializeBuilding(building, sp));
     }
     map_obj[json_fields::BUILDINGS] = std::move(buildings_array);
 
-    json::array offices_array;
+    json::array offices_array(sp);
+    offices_array.reserve(map.GetOffices().size());
     for (const auto& office : map.GetOffices()) {
-        offices_array.push_back(SerializeOffice(office));
+        offices_array.push_back(SerializeOffice(office, sp));
     }
     map_obj[json_fields::OFFICES] = std::move(offices_array);
 
     const auto& loots = extra_data->GetLootTypes(map.GetId());
     if (!loots.empty()) {
-        map_obj[json_fields::LOOT_TYPES] = SerializeLootTypes(loots);
+        map_obj[json_fields::LOOT_TYPES] = SerializeLootTypes(loots, sp);
     }
 
     return map_obj;
@@ -143,20 +147,21 @@ json::object SerializePlayersAll(const std::map<uint32_t, const app::Player*> &p
     return response_json;
 }
 
-json::object SerializeGameStatePlayerState(const model::Dog& dog) {
-    json::object player_state;
+json::object SerializeGameStatePlayerState(const model::Dog& dog, json::storage_ptr sp) {
+    json::object player_state(sp);
 
     // player_state[json_fields::POS] = json::array{dog.GetPosition().x, dog.GetPosition().y};
-    player_state[json_fields::POS] = json::value_from(dog.GetPosition());   // for two digits precision
-    player_state[json_fields::SPEED] = json::array{dog.GetSpeed().x, dog.GetSpeed().y};
+    player_state[json_fields::POS] = json::value_from(dog.GetPosition(), sp);   // for two digits precision
+    player_state[json_fields::SPEED] = json::array({dog.GetSpeed().x, dog.GetSpeed().y}, sp);
     player_state[json_fields::DIR] = utils::Direction2DToString(dog.GetDirection());
 
-    json::array player_bag;
+    json::array player_bag(sp);
+    player_bag.reserve(dog.GetBag().size());
     for (const auto& item : dog.GetBag()) {
-        json::object loot;
+        json::object loot(sp);
         loot[json_fields::ID] = item->object_id;
         loot[json_fields::TYPE] = item->loot_data_ptr->type_id;
-        player_bag.push_back(loot);
+        player_bag.push_back(std::move(loot));
     }
     player_state[json_fields::BAG] = std::move(player_bag);
     player_state[json_fields::SCORE] = dog.GetScore();
@@ -164,37 +169,62 @@ json::object SerializeGameStatePlayerState(const model::Dog& dog) {
     return player_state;
 }
 
-json::object SerializeGameStatePlayers(const model::GameSession& session) {
-    json::object players_json;
+json::object SerializeGameStatePlayers(const model::GameSession& session, json::storage_ptr sp) {
+    json::object players_json(sp);
 
     for (const auto& [dog_id, dog] : session.GetDogs()) {
-        players_json[std::to_string(dog_id)] = std::move(SerializeGameStatePlayerState(dog));
+        players_json[std::to_string(dog_id)] = SerializeGameStatePlayerState(dog, sp);
     }
     for (const auto& [dog_id, dog] : session.GetBots()) {
-        players_json[std::to_string(dog_id)] = std::move(SerializeGameStatePlayerState(dog));
+        players_json[std::to_string(dog_id)] = SerializeGameStatePlayerState(dog, sp);
     }
 
     return players_json;
 }
 
-json::object SerializeGameStateLostObjects(const model::GameSession& session) {
-    json::object lost_objects_json;
+json::object SerializeGameStateLostObjects(const model::GameSession& session, json::storage_ptr sp) {
+    json::object lost_objects_json(sp);
 
     for (const auto& [loot_id, loot] : session.GetLootNotCollected()) {
-        json::object loot_obj;
+        json::object loot_obj(sp);
         loot_obj[json_fields::TYPE] = loot->loot_data_ptr->type_id;
         // loot_obj[json_fields::POS] = json::array{loot.pos.x, loot.pos.y};
-        loot_obj[json_fields::POS] = json::value_from(loot->pos);    // for two digits precision
+        loot_obj[json_fields::POS] = json::value_from(loot->pos, sp);    // for two digits precision
         lost_objects_json[std::to_string(loot_id)] = std::move(loot_obj);
     }
 
     return lost_objects_json;
 }
 
-json::object SerializeGameState(const model::GameSession& session) {
-    json::object result;
-    result[json_fields::PLAYERS] = SerializeGameStatePlayers(session);
-    result[json_fields::LOST_OBJECTS] = SerializeGameStateLostObjects(session);
+json::object SerializeGameState(const model::GameSession& session, json::storage_ptr sp) {
+    json::object result(sp);
+    result[json_fields::PLAYERS] = SerializeGameStatePlayers(session, sp);
+    result[json_fields::LOST_OBJECTS] = SerializeGameStateLostObjects(session, sp);
+    return result;
+}
+
+json::object SerializeGameState(const model::GameSession& session, const model::Dog& viewer, double radius,
+                                json::storage_ptr sp) {
+    if (radius <= 0.0) {
+        return SerializeGameState(session, sp);
+    }
+    const auto interest = session.GetInterestSet(viewer.GetPosition(), radius);
+
+    json::object players_json(sp);
+    for (const model::Dog* dog : interest.dogs) {
+        players_json[std::to_string(dog->GetId())] = SerializeGameStatePlayerState(*dog, sp);
+    }
+    json::object lost_objects_json(sp);
+    for (const loot::LootObject* loot : interest.loot) {
+        json::object loot_obj(sp);
+        loot_obj[json_fields::TYPE] = loot->loot_data_ptr->type_id;
+        loot_obj[json_fields::POS] = json::value_from(loot->pos, sp);    // for two digits precision
+        lost_objects_json[std::to_string(loot->object_id)] = std::move(loot_obj);
+    }
+
+    json::object result(sp);
+    result[json_fields::PLAYERS] = std::move(players_json);
+    result[json_fields::LOST_OBJECTS] = std::move(lost_objects_json);
     return result;
 }
 
@@ -210,18 +240,18 @@ json::object SerializeGamePlayers(const std::map<std::uint32_t, const app::Playe
     return players_json;
 }
 
-json::object SerializeGamePlayers(const model::GameSession& session) {
-    json::object players_json;
+json::object SerializeGamePlayers(const model::GameSession& session, json::storage_ptr sp) {
+    json::object players_json(sp);
 
     // players
     for (const auto& dog : session.GetDogs() | std::views::values) {
-        json::object dog_info;
+        json::object dog_info(sp);
         dog_info[json_fields::NAME] = dog.GetName();
         players_json[std::to_string(dog.GetId())] = std::move(dog_info);
     }
     // bots
     for (const auto& bot : session.GetBots() | std::views::values) {
-        json::object bot_info;
+        json::object bot_info(sp);
         bot_info[json_fields::NAME] = bot.GetName();
         players_json[std::to_string(bot.GetId())] = std::move(bot_info);
     }
@@ -25,11 +25,16 @@ namespace serialize_api {
 
 namespace json = boost::json;
 
-    json::value SerializeMapBrief(const model::Map& map);
-    json::value SerializeMapFull(const model::Map& map, const extra_data::GameExtraData* extra_data);
+    // sp - storage for the resulting DOM (request arena in API handlers, default heap otherwise)
+    json::value SerializeMapBrief(const model::Map& map, json::storage_ptr sp = {});
+    json::value SerializeMapFull(const model::Map& map, const extra_data::GameExtraData* extra_data,
+                                 json::storage_ptr sp = {});
     json::object SerializePlayersAll(const std::map<uint32_t, const app::Player*>& players);
-    json::object SerializeGameState(const model::GameSession& session);
+    json::object SerializeGameState(const model::GameSession& session, json::storage_ptr sp = {});
+    // Area of interest of the viewer: dogs and loot within radius of its dog (radius <= 0 - whole session)
+    json::object SerializeGameState(const model::GameSession& session, const model::Dog& viewer, double radius,
+                                    json::storage_ptr sp = {});
     json::object SerializeGamePlayers(const std::map<std::uint32_t, const app::Player*>& players);
-    json::object SerializeGamePlayers(const model::GameSession& session);
+    json::object SerializeGamePlayers(const model::GameSession& session, json::storage_ptr sp = {});
 
 } // namespace serialize_api
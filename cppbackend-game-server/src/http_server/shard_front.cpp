@@ -0,0 +1,385 @@
+#include "shard_front.h"
+
+#include <array>
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/json.hpp>
+
+#include "../common/utils.h"
+
+namespace sharding {
+
+namespace {
+
+namespace json = boost::json;
+
+using namespace http_handler;
+
+bool IsIdempotent(http::verb method) {
+    return method == http::verb::get || method == http::verb::head || method == http::verb::options
+        || method == http::verb::put || method == http::verb::delete_;
+}
+
+bool IsUnknownToken(const StringResponse& res) {
+    return res.result() == http::status::unauthorized && res.body().find(error_codes::UNKNOWN_TOKEN) != std::string::npos;
+}
+
+std::string_view TargetPath(const StringRequest& req) {
+    std::string_view target = req.target();
+    return target.substr(0, target.find('?'));
+}
+
+// String field of a JSON object body, empty if the body is not such an object
+std::string FindJsonString(std::string_view body, std::string_view field) {
+    try {
+        auto value = json::parse(body);
+        const auto* str = value.is_object() ? value.as_object().if_contains(field) : nullptr;
+        return str && str->is_string() ? std::string(str->as_string()) : std::string{};
+    } catch (const std::exception&) {
+        return {};
+    }
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+// ShardClient
+
+class ShardClient::Operation : public std::enable_shared_from_this<ShardClient::Operation> {
+public:
+    Operation(std::shared_ptr<ShardClient> client, std::string frame, bool idempotent, Callback callback)
+        : client_(std::move(client))
+        , frame_(std::move(frame))
+        , idempotent_(idempotent)
+        , callback_(std::move(callback))
+        , strand_(net::make_strand(client_->ioc_))
+        , deadline_(strand_)
+    {}
+
+    void Start() {
+        net::dispatch(strand_, [self = shared_from_this()] {
+            self->deadline_.expires_after(self->client_->timeout_);
+            self->deadline_.async_wait([self](sys::error_code ec) {
+                self->OnDeadline(ec);
+            });
+            if (auto idle = self->client_->TakeIdle()) {
+                self->socket_.emplace(std::move(*idle));
+                self->reused_ = true;
+                self->Write();
+            } else {
+                self->Connect();
+            }
+        });
+    }
+
+private:
+    using Strand = net::strand<net::io_context::executor_type>;
+
+    std::shared_ptr<ShardClient> client_;
+    std::string frame_;
+    bool idempotent_;
+    Callback callback_;
+    // Socket handlers and the deadline run on one strand, so closing on expiry does not race them
+    Strand strand_;
+    net::steady_timer deadline_;
+    std::optional<local_stream::socket> socket_;
+    bool reused_ = false;
+    bool done_ = false;
+    bool timed_out_ = false;
+    std::array<char, FRAME_HEADER_SIZE> header_{};
+    std::string payload_;
+
+    void Connect() {
+        reused_ = false;
+        socket_.emplace(client_->ioc_);
+        socket_->async_connect(client_->endpoint_, net::bind_executor(strand_, [self = shared_from_this()](sys::error_code ec) {
+            if (ec) {
+                return self->Fail(ec, false);
+            }
+            self->Write();
+        }));
+    }
+
+    void Write() {
+        net::async_write(*socket_, net::buffer(frame_),
+                         net::bind_executor(strand_, [self = shared_from_this()](sys::error_code ec, std::size_t) {
+            if (ec) {
+                // Nothing has reached the worker
+                return self->Fail(ec, true);
+            }
+            self->ReadHeader();
+        }));
+    }
+
+    void ReadHeader() {
+        net::async_read(*socket_, net::buffer(header_),
+                        net::bind_executor(strand_, [self = shared_from_this()](sys::error_code ec, std::size_t) {
+            if (ec) {
+                // EOF before any response byte: most likely the worker had closed this connection before
+                // it got the request, but it may have crashed while handling it - resend only if that is harmless
+                return self->Fail(ec, ec == net::error::eof && self->idempotent_);
+            }
+            self->ReadPayload();
+        }));
+    }
+
+    void ReadPayload() {
+        const auto size = DecodeFrameSize({header_.data(), header_.size()});
+        if (!size) {
+            return Fail(net::error::message_size, false);
+        }
+        payload_.resize(*size);
+        net::async_read(*socket_, net::buffer(payload_),
+                        net::bind_executor(strand_, [self = shared_from_this()](sys::error_code ec, std::size_t) {
+            if (ec) {
+                return self->Fail(ec, false);
+            }
+            auto res = DecodeResponse(self->payload_);
+            if (!res) {
+                return self->Fail(net::error::invalid_argument, false);
+            }
+            self->client_->ReturnIdle(std::move(*self->socket_));
+            self->Finish(std::move(res));
+        }));
+    }
+
+    // The pending socket operation completes with operation_aborted and ends the exchange in Fail
+    void OnDeadline(sys::error_code ec) {
+        if (ec == net::error::operation_aborted || done_) {
+            return;
+        }
+        timed_out_ = true;
+        sys::error_code ignored;
+        socket_->close(ignored);
+    }
+
+    // may_retry - the request could not have been processed by the worker, or processing it twice is harmless
+    void Fail(sys::error_code ec, bool may_retry) {
+        sys::error_code ignored;
+        socket_->close(ignored);
+        if (timed_out_) {
+            boost_logger::LogError(EXIT_FAILURE, "Shard worker did not answer in time", "ShardClient::Exchange");
+            return Finish(std::nullopt);
+        }
+        if (reused_ && may_retry) {
+            return Connect();
+        }
+        boost_logger::LogError(EXIT_FAILURE, ec.message(), "ShardClient::Exchange");
+        Finish(std::nullopt);
+    }
+
+    void Finish(std::optional<StringResponse> res) {
+        done_ = true;
+        deadline_.cancel();
+        callback_(std::move(res));
+    }
+};
+
+ShardClient::ShardClient(net::io_context& ioc, std::string socket_path, std::chrono::steady_clock::duration timeout)
+    : ioc_(ioc)
+    , endpoint_(std::move(socket_path))
+    , timeout_(timeout)
+{}
+
+void ShardClient::Exchange(std::string frame, bool idempotent, Callback callback) {
+    std::make_shared<Operation>(shared_from_this(), std::move(frame), idempotent, std::move(callback))->Start();
+}
+
+std::optional<local_stream::socket> ShardClient::TakeIdle() {
+    std::lock_guard lock{mutex_};
+    if (idle_.empty()) {
+        return std::nullopt;
+    }
+    auto socket = std::move(idle_.back());
+    idle_.pop_back();
+    return socket;
+}
+
+void ShardClient::ReturnIdle(local_stream::socket&& socket) {
+    std::lock_guard lock{mutex_};
+    idle_.push_back(std::move(socket));
+}
+
+// ------------------------------------------------------------------------------------------------
+// ShardFront
+
+ShardFront::ShardFront(net::io_context& ioc, const std::string& socket_dir, std::uint32_t shard_count) {
+    auto& registry = metrics::Registry::Instance();
+    for (std::uint32_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_shared<ShardClient>(ioc, ShardSocketPath(socket_dir, i)));
+        forwarded_.push_back(&registry.GetCounter("shard_requests_forwarded_total", "Requests forwarded to a shard worker",
+                                                  "shard=\"" + std::to_string(i) + "\""));
+    }
+}
+
+void ShardFront::Handle(StringRequest&& req, Responder send) {
+    try {
+        const auto path = TargetPath(req);
+        if (path == api_paths::METRICS) {
+            return send(response::Builder::From(req)
+                            .WithContentType(ContentType::PROMETHEUS_TEXT)
+                            .WithBody(metrics::Registry::Instance().Render())
+                            .Build());
+        }
+        if (path == api_paths::GAME_JOIN) {
+            return HandleJoin(std::move(req), std::move(send));
+        }
+        if (path == api_paths::GAME_TICK) {
+            return HandleTick(std::move(req), std::move(send));
+        }
+        if (path.starts_with(api_paths::GAME_BASE) && path != api_paths::GAME_RECORDS) {
+            // Without a valid token any shard gives the same 401
+            if (auto token = utils::http::ExtractToken(req)) {
+                if (auto key = app::ParseTokenKey(**token)) {
+                    return HandleAuthorized(std::move(req), std::move(send), *key);
+                }
+            }
+        }
+        Relay(NextShard(), std::move(req), std::move(send));
+    } catch (const std::exception& e) {
+        send(response::Builder::MakeError(req, http::status::internal_server_error, error_codes::EXCEPTION_CAUGHT, e.what()));
+    }
+}
+
+void ShardFront::HandleJoin(StringRequest&& req, Responder send) {
+    const auto map_id = FindJsonString(req.body(), json_fields::MAP_ID);
+    // A body without mapId is rejected by any worker
+    const std::uint32_t shard = map_id.empty() ? NextShard() : ShardForMap(map_id, static_cast<std::uint32_t>(shards_.size()));
+    // The token is read from the answer below, so it must come back uncompressed
+    req.erase(http::field::accept_encoding);
+
+    auto client_req = std::make_shared<const StringRequest>(std::move(req));
+    Forward(shard, *client_req, [self = shared_from_this(), client_req, send = std::move(send), shard](auto res) {
+        if (!res) {
+            return send(self->Unavailable(*client_req));
+        }
+        if (res->result() == http::status::ok) {
+            if (auto key = app::ParseTokenKey(FindJsonString(res->body(), json_fields::AUTH_TOKEN))) {
+                self->RememberToken(*key, shard);
+            }
+            self->MaybeSweepTokens();
+        }
+        send(ToClient(*client_req, std::move(*res)));
+    });
+}
+
+void ShardFront::HandleAuthorized(StringRequest&& req, Responder send, const app::TokenKey& key) {
+    auto client_req = std::make_shared<const StringRequest>(std::move(req));
+    auto route = token_shards_.Find(key);
+    if (!route) {
+        token_probes_.Inc();
+        return Probe(std::move(client_req), std::move(send), key, 0, std::nullopt);
+    }
+    route->last_used.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    Forward(route->shard, *client_req, [self = shared_from_this(), client_req, send = std::move(send), key](auto res) {
+        if (!res) {
+            return send(self->Unavailable(*client_req));
+        }
+        // The player has retired
+        if (IsUnknownToken(*res)) {
+            self->token_shards_.Erase(key);
+        }
+        send(ToClient(*client_req, std::move(*res)));
+    });
+}
+
+void ShardFront::Probe(std::shared_ptr<const StringRequest> req, Responder send, app::TokenKey key,
+                       std::uint32_t shard, std::optional<StringResponse> last) {
+    if (shard == shards_.size()) {
+        // Unknown to every shard that answered
+        return last ? send(ToClient(*req, std::move(*last))) : send(Unavailable(*req));
+    }
+    Forward(shard, *req, [self = shared_from_this(), req, send = std::move(send), key, shard,
+                          last = std::move(last)](auto res) mutable {
+        if (res && !IsUnknownToken(*res)) {
+            self->RememberToken(key, shard);
+            return send(ToClient(*req, std::move(*res)));
+        }
+        self->Probe(std::move(req), std::move(send), key, shard + 1, res ? std::move(res) : std::move(last));
+    });
+}
+
+void ShardFront::RememberToken(const app::TokenKey& key, std::uint32_t shard) {
+    token_shards_.Insert(key, std::make_shared<TokenRoute>(shard, Clock::now()));
+}
+
+void ShardFront::MaybeSweepTokens() {
+    const auto now = Clock::now().time_since_epoch().count();
+    auto last = last_sweep_.load(std::memory_order_relaxed);
+    if (now - last < TOKEN_SWEEP_PERIOD.count()
+        || !last_sweep_.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+        return;
+    }
+    const auto oldest = now - TOKEN_IDLE_TTL.count();
+    token_routes_expired_.Inc(token_shards_.EraseIf([oldest](const app::TokenKey&, const TokenRoute& route) {
+        return route.last_used.load(std::memory_order_relaxed) < oldest;
+    }));
+}
+
+void ShardFront::HandleTick(StringRequest&& req, Responder send) {
+    // Every shard advances its own games; the client gets the first failure, otherwise any success
+    struct Broadcast {
+        std::mutex mutex;
+        size_t pending = 0;
+        std::optional<StringResponse> result;
+        bool unavailable = false;
+    };
+    auto broadcast = std::make_shared<Broadcast>();
+    broadcast->pending = shards_.size();
+
+    auto client_req = std::make_shared<const StringRequest>(std::move(req));
+    for (std::uint32_t shard = 0; shard < shards_.size(); ++shard) {
+        Forward(shard, *client_req, [self = shared_from_this(), client_req, send, broadcast](auto res) {
+            std::unique_lock lock{broadcast->mutex};
+            if (!res) {
+                broadcast->unavailable = true;
+            } else if (!broadcast->result || (broadcast->result->result() == http::status::ok && res->result() != http::status::ok)) {
+                broadcast->result = std::move(res);
+            }
+            if (--broadcast->pending != 0) {
+                return;
+            }
+            lock.unlock();
+            if (broadcast->unavailable) {
+                return send(self->Unavailable(*client_req));
+            }
+            send(ToClient(*client_req, std::move(*broadcast->result)));
+        });
+    }
+}
+
+void ShardFront::Forward(std::uint32_t shard, const StringRequest& req, ResponseCallback callback) {
+    forwarded_[shard]->Inc();
+    shards_[shard]->Exchange(EncodeRequest(req), IsIdempotent(req.method()), std::move(callback));
+}
+
+void ShardFront::Relay(std::uint32_t shard, StringRequest&& req, Responder send) {
+    auto client_req = std::make_shared<const StringRequest>(std::move(req));
+    Forward(shard, *client_req, [self = shared_from_this(), client_req, send = std::move(send)](auto res) {
+        if (!res) {
+            return send(self->Unavailable(*client_req));
+        }
+        send(ToClient(*client_req, std::move(*res)));
+    });
+}
+
+std::uint32_t ShardFront::NextShard() noexcept {
+    return next_shard_.fetch_add(1, std::memory_order_relaxed) % static_cast<std::uint32_t>(shards_.size());
+}
+
+StringResponse ShardFront::ToClient(const StringRequest& req, StringResponse&& res) {
+    res.version(req.version());
+    res.keep_alive(req.keep_alive());
+    return std::move(res);
+}
+
+StringResponse ShardFront::Unavailable(const StringRequest& req) {
+    unavailable_.Inc();
+    return response::Builder::MakeError(req, http::status::service_unavailable,
+                                        error_codes::SHARD_UNAVAILABLE, error_messages::SHARD_UNAVAILABLE);
+}
+
+} // namespace sharding
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+
+#include "http_server.h"
+#include "shard_protocol.h"
+#include "../common/metrics.h"
+#include "../game_app/token_table.h"
+
+namespace sharding {
+
+namespace net = boost::asio;
+namespace sys = boost::system;
+using local_stream = net::local::stream_protocol;
+
+/**
+ * @brief Connections of the front process to one shard worker
+ *
+ * Keeps a pool of idle Unix socket connections; an exchange takes one (or connects a new one),
+ * writes a request frame, reads the response frame and returns the connection to the pool.
+ * A pooled connection the worker has closed meanwhile (e.g. after a worker restart) is retried
+ * once on a fresh connection when the request surely did not reach the worker (the write failed),
+ * or when it may have but running it twice is harmless (EOF before the response, idempotent method).
+ * A join or a player action after such an EOF gets a 503 instead of possibly running twice.
+ * Each exchange has one deadline for connect, write and read together: a worker that hangs
+ * gets its socket closed and the client a 503, instead of a request that never completes.
+ */
+class ShardClient : public std::enable_shared_from_this<ShardClient> {
+public:
+    // nullopt - the worker is unavailable
+    using Callback = std::function<void(std::optional<StringResponse>)>;
+
+    static constexpr std::chrono::steady_clock::duration EXCHANGE_TIMEOUT = std::chrono::seconds{5};
+
+    ShardClient(net::io_context& ioc, std::string socket_path,
+                std::chrono::steady_clock::duration timeout = EXCHANGE_TIMEOUT);
+
+    ShardClient(const ShardClient&) = delete;
+    ShardClient& operator=(const ShardClient&) = delete;
+
+    // frame - encoded request (EncodeRequest); idempotent - the request may be sent twice (GET, HEAD...);
+    // callback runs on the io_context threads
+    void Exchange(std::string frame, bool idempotent, Callback callback);
+
+private:
+    class Operation;
+
+    net::io_context& ioc_;
+    local_stream::endpoint endpoint_;
+    std::chrono::steady_clock::duration timeout_;
+    std::mutex mutex_;
+    std::vector<local_stream::socket> idle_;
+
+    std::optional<local_stream::socket> TakeIdle();
+    void ReturnIdle(local_stream::socket&& socket);
+};
+
+/**
+ * @brief HTTP handler of the front process in multi-process mode (--shard-mode front)
+ *
+ * Every map belongs to one worker process (ShardForMap), the front forwards each request
+ * to the worker that owns the game it refers to:
+ * - join: by the mapId of the request body; the issued token is remembered with its shard
+ * - authorized game requests: by the token's shard; a token the front does not know
+ *   (restored game state, front restart, route expired) is looked up by asking the shards in turn
+ *
+ * Routes of tokens not used for TOKEN_IDLE_TTL are dropped by a sweep that runs on joins at most
+ * once per TOKEN_SWEEP_PERIOD, so tokens of players that retired without a later request do not
+ * pile up. A client that comes back after that only costs one lookup round.
+ * - manual tick: broadcast to all shards
+ * - metrics: the front's own registry
+ * - everything else (maps, records, static files): any shard, round-robin
+ *
+ * The front keeps no game state and opens no database.
+ */
+class ShardFront : public std::enable_shared_from_this<ShardFront> {
+public:
+    using Responder = std::function<void(StringResponse&&)>;
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr Clock::duration TOKEN_IDLE_TTL = std::chrono::minutes{10};
+    static constexpr Clock::duration TOKEN_SWEEP_PERIOD = std::chrono::minutes{1};
+
+    ShardFront(net::io_context& ioc, const std::string& socket_dir, std::uint32_t shard_count);
+
+    ShardFront(const ShardFront&) = delete;
+    ShardFront& operator=(const ShardFront&) = delete;
+
+    /**
+     * @brief Same call signature as RequestHandler, so the front plugs into LoggingRequestHandler
+     * @param send Function to call with the response (copied into the forwarding callbacks)
+     */
+    template <typename Body, typename Allocator, typename Send>
+    void operator()(http::request<Body, http::basic_fields<Allocator>>&& req,
+                    [[maybe_unused]] http_server::RequestArena& arena, Send&& send) {
+        Handle(std::move(req), Responder(std::forward<Send>(send)));
+    }
+
+    void Handle(StringRequest&& req, Responder send);
+
+private:
+    using ResponseCallback = std::function<void(std::optional<StringResponse>)>;
+
+    // Shard of a token's player and when the front last routed a request of the token
+    struct TokenRoute {
+        TokenRoute(std::uint32_t shard, Clock::time_point now) noexcept
+            : shard(shard)
+            , last_used(now.time_since_epoch().count())
+        {}
+
+        std::uint32_t shard;
+        std::atomic<Clock::rep> last_used;
+    };
+
+    std::vector<std::shared_ptr<ShardClient>> shards_;
+    app::TokenTable<TokenRoute> token_shards_;          ///< Token -> shard of its player
+    std::atomic<Clock::rep> last_sweep_{Clock::now().time_since_epoch().count()};
+    std::atomic<std::uint32_t> next_shard_{0};          ///< Round-robin for shard-independent requests
+    std::vector<metrics::Counter*> forwarded_;          ///< Per shard
+    metrics::Counter& unavailable_ = metrics::Registry::Instance().GetCounter(
+        "shard_unavailable_total", "Requests answered 503 because a shard worker did not respond");
+    metrics::Counter& token_probes_ = metrics::Registry::Instance().GetCounter(
+        "shard_token_probes_total", "Tokens unknown to the front looked up by asking the shards");
+    metrics::Counter& token_routes_expired_ = metrics::Registry::Instance().GetCounter(
+        "shard_token_routes_expired_total", "Token routes dropped after TOKEN_IDLE_TTL without requests");
+
+    void HandleJoin(StringRequest&& req, Responder send);
+    void HandleAuthorized(StringRequest&& req, Responder send, const app::TokenKey& key);
+    void Probe(std::shared_ptr<const StringRequest> req, Responder send, app::TokenKey key,
+               std::uint32_t shard, std::optional<StringResponse> last);
+    void HandleTick(StringRequest&& req, Responder send);
+
+    void RememberToken(const app::TokenKey& key, std::uint32_t shard);
+    // Drops idle token routes if TOKEN_SWEEP_PERIOD has passed since the last sweep (one caller sweeps)
+    void MaybeSweepTokens();
+
+    void Forward(std::uint32_t shard, const StringRequest& req, ResponseCallback callback);
+    // Forwards and answers the client with the worker's response (503 if the worker is unavailable)
+    void Relay(std::uint32_t shard, StringRequest&& req, Responder send);
+    std::uint32_t NextShard() noexcept;
+
+    // Worker response adjusted to the client's connection
+    static StringResponse ToClient(const StringRequest& req, StringResponse&& res);
+    StringResponse Unavailable(const StringRequest& req);
+};
+
+} // namespace sharding
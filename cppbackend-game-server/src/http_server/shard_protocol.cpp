@@ -0,0 +1,251 @@
+#include "shard_protocol.h"
+
+#include <limits>
+
+namespace sharding {
+
+namespace {
+
+class Writer {
+public:
+    Writer() {
+        out_.resize(FRAME_HEADER_SIZE);
+    }
+
+    void U8(std::uint8_t value) {
+        out_.push_back(static_cast<char>(value));
+    }
+
+    void U16(std::uint16_t value) {
+        U8(static_cast<std::uint8_t>(value));
+        U8(static_cast<std::uint8_t>(value >> 8));
+    }
+
+    void U32(std::uint32_t value) {
+        U16(static_cast<std::uint16_t>(value));
+        U16(static_cast<std::uint16_t>(value >> 16));
+    }
+
+    void Str16(std::string_view str) {
+        if (str.size() > std::numeric_limits<std::uint16_t>::max()) {
+            throw std::length_error("Shard frame: string field too long");
+        }
+        U16(static_cast<std::uint16_t>(str.size()));
+        out_.append(str);
+    }
+
+    void Body(std::string_view body) {
+        if (body.size() > MAX_FRAME_SIZE) {
+            throw std::length_error("Shard frame: body too long");
+        }
+        U32(static_cast<std::uint32_t>(body.size()));
+        out_.append(body);
+    }
+
+    // Fills in the size prefix
+    std::string Finish() && {
+        const auto size = static_cast<std::uint32_t>(out_.size() - FRAME_HEADER_SIZE);
+        for (size_t i = 0; i < FRAME_HEADER_SIZE; ++i) {
+            out_[i] = static_cast<char>(size >> (8 * i));
+        }
+        return std::move(out_);
+    }
+
+private:
+    std::string out_;
+};
+
+class Reader {
+public:
+    explicit Reader(std::string_view in)
+        : in_(in)
+    {}
+
+    [[nodiscard]] bool Ok() const noexcept {
+        return ok_;
+    }
+
+    [[nodiscard]] bool AtEnd() const noexcept {
+        return in_.empty();
+    }
+
+    std::uint8_t U8() {
+        if (!Need(1)) {
+            return 0;
+        }
+        const auto value = static_cast<std::uint8_t>(in_.front());
+        in_.remove_prefix(1);
+        return value;
+    }
+
+    std::uint16_t U16() {
+        const std::uint16_t lo = U8();
+        return static_cast<std::uint16_t>(lo | (U8() << 8));
+    }
+
+    std::uint32_t U32() {
+        const std::uint32_t lo = U16();
+        return lo | (std::uint32_t{U16()} << 16);
+    }
+
+    std::string_view Str16() {
+        return Bytes(U16());
+    }
+
+    std::string_view Body() {
+        return Bytes(U32());
+    }
+
+private:
+    std::string_view in_;
+    bool ok_ = true;
+
+    bool Need(size_t size) {
+        ok_ = ok_ && in_.size() >= size;
+        return ok_;
+    }
+
+    std::string_view Bytes(size_t size) {
+        if (!Need(size)) {
+            return {};
+        }
+        auto bytes = in_.substr(0, size);
+        in_.remove_prefix(size);
+        return bytes;
+    }
+};
+
+bool IsHopByHop(http::field field) {
+    return field == http::field::content_length || field == http::field::connection;
+}
+
+template <typename Fields>
+void WriteHeaders(Writer& out, const Fields& fields) {
+    size_t count = 0;
+    for (const auto& header : fields) {
+        count += IsHopByHop(header.name()) ? 0 : 1;
+    }
+    if (count > std::numeric_limits<std::uint8_t>::max()) {
+        throw std::length_error("Shard frame: too many headers");
+    }
+    out.U8(static_cast<std::uint8_t>(count));
+    for (const auto& header : fields) {
+        if (IsHopByHop(header.name())) {
+            continue;
+        }
+        out.U16(static_cast<std::uint16_t>(header.name()));
+        if (header.name() == http::field::unknown) {
+            out.Str16(header.name_string());
+        }
+        out.Str16(header.value());
+    }
+}
+
+template <typename Message>
+bool ReadHeaders(Reader& in, Message& message) {
+    const auto count = in.U8();
+    for (size_t i = 0; i < count && in.Ok(); ++i) {
+        const auto field = static_cast<http::field>(in.U16());
+        if (field == http::field::unknown) {
+            const auto name = in.Str16();
+            message.insert(name, in.Str16());
+        } else {
+            message.insert(field, in.Str16());
+        }
+    }
+    return in.Ok();
+}
+
+} // namespace
+
+std::string EncodeRequest(const StringRequest& req) {
+    Writer out;
+    out.U8(PROTOCOL_VERSION);
+    out.U8(static_cast<std::uint8_t>(req.version()));
+    out.U8(static_cast<std::uint8_t>(req.method()));
+    out.Str16(req.target());
+    WriteHeaders(out, req);
+    out.Body(req.body());
+    return std::move(out).Finish();
+}
+
+std::string EncodeResponse(const StringResponse& res) {
+    Writer out;
+    out.U8(PROTOCOL_VERSION);
+    out.U16(static_cast<std::uint16_t>(res.result_int()));
+    WriteHeaders(out, res);
+    out.Body(res.body());
+    return std::move(out).Finish();
+}
+
+std::optional<StringRequest> DecodeRequest(std::string_view payload) {
+    Reader in(payload);
+    if (in.U8() != PROTOCOL_VERSION) {
+        return std::nullopt;
+    }
+    StringRequest req;
+    req.version(in.U8());
+    // http::verb::unlink is the last method Beast knows; unknown (0) is never sent
+    const auto method = in.U8();
+    if (method == static_cast<std::uint8_t>(http::verb::unknown) || method > static_cast<std::uint8_t>(http::verb::unlink)) {
+        return std::nullopt;
+    }
+    req.method(static_cast<http::verb>(method));
+    req.target(in.Str16());
+    if (!ReadHeaders(in, req)) {
+        return std::nullopt;
+    }
+    req.body() = in.Body();
+    if (!in.Ok() || !in.AtEnd()) {
+        return std::nullopt;
+    }
+    req.prepare_payload();
+    return req;
+}
+
+std::optional<StringResponse> DecodeResponse(std::string_view payload) {
+    Reader in(payload);
+    if (in.U8() != PROTOCOL_VERSION) {
+        return std::nullopt;
+    }
+    StringResponse res;
+    res.result(in.U16());
+    if (!ReadHeaders(in, res)) {
+        return std::nullopt;
+    }
+    res.body() = in.Body();
+    if (!in.Ok() || !in.AtEnd()) {
+        return std::nullopt;
+    }
+    res.content_length(res.body().size());
+    return res;
+}
+
+std::optional<std::uint32_t> DecodeFrameSize(std::string_view header) {
+    std::uint32_t size = 0;
+    for (size_t i = 0; i < FRAME_HEADER_SIZE; ++i) {
+        size |= std::uint32_t{static_cast<std::uint8_t>(header[i])} << (8 * i);
+    }
+    if (size > MAX_FRAME_SIZE) {
+        return std::nullopt;
+    }
+    return size;
+}
+
+std::uint32_t ShardForMap(std::string_view map_id, std::uint32_t shard_count) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const unsigned char c : map_id) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return static_cast<std::uint32_t>(hash % shard_count);
+}
+
+std::string ShardSocketPath(std::string_view socket_dir, std::uint32_t shard_index) {
+    std::string path(socket_dir);
+    if (!path.empty() && path.back() != '/') {
+        path.push_back('/');
+    }
+    return path + "shard-" + std::to_string(shard_index) + ".sock";
+}
+
+} // namespace sharding
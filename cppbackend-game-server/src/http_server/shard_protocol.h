@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "http_response.h"
+
+// Front process <-> shard worker protocol over Unix domain sockets (see shard_front.h, shard_worker.h)
+namespace sharding {
+
+namespace http = boost::beast::http;
+
+using http_handler::StringRequest;
+using http_handler::StringResponse;
+
+// Frame: 4-byte little-endian payload size, then the payload.
+// Request payload:  u8 version | u8 HTTP version (10/11) | u8 method (http::verb) | str16 target | headers | body
+// Response payload: u8 version | u16 status | headers | body
+// headers: u8 count, each u16 field (http::field; unknown - followed by str16 name) + str16 value
+// body: u32 size + bytes; str16: u16 size + bytes. Content-Length and Connection are not sent -
+// the receiver sets them from the body and its own connection.
+constexpr inline std::uint8_t PROTOCOL_VERSION = 1;
+constexpr inline size_t FRAME_HEADER_SIZE = 4;
+constexpr inline std::uint32_t MAX_FRAME_SIZE = 16 * 1024 * 1024;
+
+// Whole frame (size prefix included)
+std::string EncodeRequest(const StringRequest& req);
+std::string EncodeResponse(const StringResponse& res);
+
+// Payload without the size prefix; nullopt if it is malformed or of another protocol version
+std::optional<StringRequest> DecodeRequest(std::string_view payload);
+std::optional<StringResponse> DecodeResponse(std::string_view payload);
+
+// Payload size from a frame header; nullopt if it exceeds MAX_FRAME_SIZE
+std::optional<std::uint32_t> DecodeFrameSize(std::string_view header);
+
+// Shard owning a map: stable over processes and restarts (FNV-1a of the map id)
+std::uint32_t ShardForMap(std::string_view map_id, std::uint32_t shard_count);
+
+// Unix socket of a shard worker in the socket directory
+std::string ShardSocketPath(std::string_view socket_dir, std::uint32_t shard_index);
+
+} // namespace sharding
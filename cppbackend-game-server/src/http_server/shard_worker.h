@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+
+#include "http_server.h"
+#include "shard_protocol.h"
+
+namespace sharding {
+
+namespace net = boost::asio;
+namespace sys = boost::system;
+using local_stream = net::local::stream_protocol;
+
+/**
+ * @brief Connection from the front process to a shard worker
+ *
+ * Reads framed requests (see shard_protocol.h) one at a time, passes each to the request
+ * handler with the connection's arena and writes the framed response back. The front keeps
+ * these connections open and reuses them, so one connection carries many requests.
+ */
+template <typename RequestHandler>
+class ShardWorkerSession : public std::enable_shared_from_this<ShardWorkerSession<RequestHandler>> {
+public:
+    template <typename Handler>
+    ShardWorkerSession(local_stream::socket&& socket, Handler&& request_handler)
+        : socket_(std::move(socket))
+        , request_handler_(std::forward<Handler>(request_handler))
+    {}
+
+    void Run() {
+        net::dispatch(socket_.get_executor(), [self = this->shared_from_this()] {
+            self->ReadFrame();
+        });
+    }
+
+private:
+    local_stream::socket socket_;
+    RequestHandler request_handler_;
+    std::array<char, FRAME_HEADER_SIZE> header_{};
+    std::string payload_;
+    std::string response_;
+    http_server::RequestArena arena_;
+
+    void ReadFrame() {
+        arena_.Reset();
+        net::async_read(socket_, net::buffer(header_),
+                        [self = this->shared_from_this()](sys::error_code ec, std::size_t) {
+                            self->OnHeader(ec);
+                        });
+    }
+
+    void OnHeader(sys::error_code ec) {
+        if (ec) {
+            // The front closed an idle connection
+            if (ec != net::error::eof && ec != net::error::operation_aborted) {
+                boost_logger::LogError(EXIT_FAILURE, ec.message(), "ShardWorkerSession::OnHeader");
+            }
+            return;
+        }
+        const auto size = DecodeFrameSize({header_.data(), header_.size()});
+        if (!size) {
+            boost_logger::LogError(EXIT_FAILURE, "Shard frame is too large", "ShardWorkerSession::OnHeader");
+            return;
+        }
+        payload_.resize(*size);
+        net::async_read(socket_, net::buffer(payload_),
+                        [self = this->shared_from_this()](sys::error_code ec, std::size_t) {
+                            self->OnPayload(ec);
+                        });
+    }
+
+    void OnPayload(sys::error_code ec) {
+        if (ec) {
+            boost_logger::LogError(EXIT_FAILURE, ec.message(), "ShardWorkerSession::OnPayload");
+            return;
+        }
+        auto request = DecodeRequest(payload_);
+        if (!request) {
+            boost_logger::LogError(EXIT_FAILURE, "Malformed shard request frame", "ShardWorkerSession::OnPayload");
+            return;
+        }
+        // The handler may answer from the API strand: the write goes back to the connection's strand
+        request_handler_(std::move(*request), arena_, [self = this->shared_from_this()](auto&& response) {
+            auto frame = EncodeResponse(response);
+            net::dispatch(self->socket_.get_executor(), [self, frame = std::move(frame)]() mutable {
+                self->Write(std::move(frame));
+            });
+        });
+    }
+
+    void Write(std::string&& frame) {
+        response_ = std::move(frame);
+        net::async_write(socket_, net::buffer(response_),
+                         [self = this->shared_from_this()](sys::error_code ec, std::size_t) {
+                             if (ec) {
+                                 boost_logger::LogError(EXIT_FAILURE, ec.message(), "ShardWorkerSession::Write");
+                                 return;
+                             }
+                             self->ReadFrame();
+                         });
+    }
+};
+
+/**
+ * @brief Accepts front process connections on the worker's Unix domain socket
+ */
+template <typename RequestHandler>
+class ShardWorkerListener : public std::enable_shared_from_this<ShardWorkerListener<RequestHandler>> {
+public:
+    template <typename Handler>
+    ShardWorkerListener(net::io_context& ioc, const std::string& socket_path, Handler&& request_handler)
+        : ioc_(ioc)
+        , acceptor_(net::make_strand(ioc))
+        , request_handler_(std::forward<Handler>(request_handler)) {
+        // A socket file left by a previous run of this shard would make bind fail
+        std::filesystem::remove(socket_path);
+        const local_stream::endpoint endpoint(socket_path);
+        acceptor_.open(endpoint.protocol());
+        acceptor_.bind(endpoint);
+        acceptor_.listen(net::socket_base::max_listen_connections);
+    }
+
+    void Run() {
+        DoAccept();
+    }
+
+private:
+    net::io_context& ioc_;
+    local_stream::acceptor acceptor_;
+    RequestHandler request_handler_;
+
+    void DoAccept() {
+        acceptor_.async_accept(net::make_strand(ioc_),
+                               [self = this->shared_from_this()](sys::error_code ec, local_stream::socket socket) {
+                                   self->OnAccept(ec, std::move(socket));
+                               });
+    }
+
+    void OnAccept(sys::error_code ec, local_stream::socket socket) {
+        if (ec) {
+            boost_logger::LogError(EXIT_FAILURE, ec.message(), boost_logger::error_locations::accept);
+            return;
+        }
+        std::make_shared<ShardWorkerSession<RequestHandler>>(std::move(socket), request_handler_)->Run();
+        DoAccept();
+    }
+};
+
+/**
+ * @brief Serve a shard worker: requests forwarded by the front process over a Unix domain socket
+ * @param handler Called as handler(request, arena, send), like RequestHandler
+ */
+template <typename RequestHandler>
+void ServeShardWorker(net::io_context& ioc, const std::string& socket_path, RequestHandler&& handler) {
+    using MyListener = ShardWorkerListener<std::decay_t<RequestHandler>>;
+
+    std::make_shared<MyListener>(ioc, socket_path, std::forward<RequestHandler>(handler))->Run();
+}
+
+} // namespace sharding
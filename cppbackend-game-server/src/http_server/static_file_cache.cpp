@@ -0,0 +1,66 @@
+#include "static_file_cache.h"
+
+#include <fstream>
+#include <iterator>
+
+namespace http_handler {
+
+namespace fs = std::filesystem;
+
+StaticFileCache::StaticFileCache(std::uintmax_t max_file_size, std::uintmax_t max_total_size)
+    : max_file_size_(max_file_size)
+    , max_total_size_(max_total_size)
+{}
+
+CachedBodyPtr StaticFileCache::Get(const fs::path& path) {
+    std::error_code ec;
+    const auto size = fs::file_size(path, ec);
+    if (ec || size > max_file_size_) {
+        return nullptr;
+    }
+    const auto modified = fs::last_write_time(path, ec);
+    if (ec) {
+        return nullptr;
+    }
+
+    const auto key = path.string();
+    {
+        std::lock_guard lock{mutex_};
+        if (auto it = entries_.find(key); it != entries_.end()) {
+            if (it->second.size == size && it->second.modified == modified) {
+                return it->second.body;
+            }
+            total_size_ -= BodySize(*it->second.body);
+            entries_.erase(it);
+        }
+        // Identity plus two variants, each kept only if smaller: at most 3 * size
+        if (total_size_ + 3 * size > max_total_size_) {
+            return nullptr;
+        }
+    }
+
+    // Read and compress outside the lock; a concurrent first request of the same file does the same work
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return nullptr;
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (content.size() != size) {
+        // Being rewritten
+        return nullptr;
+    }
+    auto body = CachedBody::Make(std::move(content));
+
+    std::lock_guard lock{mutex_};
+    if (const auto body_size = BodySize(*body); total_size_ + body_size <= max_total_size_
+                                                && entries_.try_emplace(key, Entry{size, modified, body}).second) {
+        total_size_ += body_size;
+    }
+    return body;
+}
+
+std::uintmax_t StaticFileCache::BodySize(const CachedBody& body) noexcept {
+    return body.identity.size() + body.gzip.size() + body.deflate.size();
+}
+
+} // namespace http_handler
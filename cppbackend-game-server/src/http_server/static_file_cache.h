@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cached_body.h"
+
+namespace http_handler {
+
+/**
+ * @brief Static files read and compressed once, shared between requests
+ *
+ * An entry remembers the size and modification time of its file; a lookup that finds them changed
+ * reads and compresses the file again. Files larger than max_file_size, and files over the
+ * max_total_size budget, are not cached (the caller serves them as before).
+ * Thread-safe: static files are served on the connection threads.
+ */
+class StaticFileCache {
+public:
+    static constexpr std::uintmax_t DEFAULT_MAX_FILE_SIZE = 4 * 1024 * 1024;
+    static constexpr std::uintmax_t DEFAULT_MAX_TOTAL_SIZE = 64 * 1024 * 1024;
+
+    explicit StaticFileCache(std::uintmax_t max_file_size = DEFAULT_MAX_FILE_SIZE,
+                             std::uintmax_t max_total_size = DEFAULT_MAX_TOTAL_SIZE);
+
+    StaticFileCache(const StaticFileCache&) = delete;
+    StaticFileCache& operator=(const StaticFileCache&) = delete;
+
+    // nullptr - the file cannot be read or is not cached
+    CachedBodyPtr Get(const std::filesystem::path& path);
+
+private:
+    struct Entry {
+        std::uintmax_t size;
+        std::filesystem::file_time_type modified;
+        CachedBodyPtr body;
+    };
+
+    std::uintmax_t max_file_size_;
+    std::uintmax_t max_total_size_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::uintmax_t total_size_ = 0;     ///< Identity and compressed bytes of all entries
+
+    static std::uintmax_t BodySize(const CachedBody& body) noexcept;
+};
+
+} // namespace http_handler
@@ -4,9 +4,15 @@
 #include <boost/asio/signal_set.hpp>
 
 #include "common/main_utils.h"
+#include "common/async_logger.h"
 #include "common/cmd_parser.h"
+#include "common/io_shards.h"
 #include "common/json_loader.h"
+#include "http_server/admission_control.h"
+#include "http_server/compression.h"
 #include "http_server/logging_request_handler.h"
+#include "http_server/shard_front.h"
+#include "http_server/shard_worker.h"
 
 #include "game_db/pooled_database.h"    // real remote DB
 #include "game_db/mock_database.h"      // dummy when DB is disabled
@@ -15,6 +21,44 @@
 namespace {
     namespace net = boost::asio;
     namespace sys = boost::system;
+
+    const auto SERVER_ADDRESS = net::ip::make_address("0.0.0.0");
+    constexpr net::ip::port_type SERVER_PORT = 8080;
+
+    std::shared_ptr<admission::AdmissionControl> MakeAdmissionControl(const parse::Args& args) {
+        return std::make_shared<admission::AdmissionControl>(admission::Options{.token_rate = args.token_rate,
+                                                                                .ip_rate = args.ip_rate,
+                                                                                .burst = args.rate_burst,
+                                                                                .max_in_flight = args.max_in_flight});
+    }
+
+    // Front of a multi-process server: accepts HTTP and routes requests to the map shard workers.
+    // Holds no game and opens no database.
+    void RunShardFront(const parse::Args& args, io_shards::IoContextShards& shards, async_logger::AsyncLogger* async_log) {
+        net::signal_set signals(shards.Primary(), SIGINT, SIGTERM);
+        signals.async_wait([&shards](const sys::error_code& ec, [[maybe_unused]] int signal_number) {
+            if (!ec) {
+                shards.Stop();
+            }
+        });
+
+        auto front = std::make_shared<sharding::ShardFront>(shards.Primary(), args.shard_socket_dir, args.shard_count);
+        server_logging::LoggingRequestHandler logging_handler{
+                                                              admission::AdmissionRequestHandler{
+                                                                  [front](auto&& endpoint, auto&& req, auto& arena, auto&& send) {
+                                                                      (*front)(
+                                                                               std::forward<decltype(req)>(req),
+                                                                               arena,
+                                                                               std::forward<decltype(send)>(send)
+                                                                              );
+                                                                  },
+                                                                  MakeAdmissionControl(args)},
+                                                              async_log};
+        http_server::ServeHttpSharded(shards, {SERVER_ADDRESS, SERVER_PORT}, logging_handler);
+        boost_logger::LogServerStarted(SERVER_PORT, SERVER_ADDRESS.to_string());
+
+        shards.Run(args.pin_threads);
+    }
 }  // namespace
 
 int main(int argc, const char* argv[]) {
@@ -26,14 +70,41 @@ int main(int argc, const char* argv[]) {
         // 0b. Logger initialize & configure
         boost_logger::InitBoostLogSetFilter();
         boost_logger::SendBoostLogToStream();
+        // Request/response lines go through the background formatter when --async-log is set
+        std::unique_ptr<async_logger::AsyncLogger> async_log;
+        if (args->async_log) {
+            async_log = std::make_unique<async_logger::AsyncLogger>(
+                async_logger::Options{.sample_rate = args->log_sample});
+            async_log->Start();
+        }
+
+        // 0c. Response compression (read by every response::Builder, so set before serving)
+        http_handler::compression::Configure({.enabled = args->compress,
+                                              .min_size = args->compress_min_size,
+                                              .level = static_cast<int>(args->compress_level)});
 
-        // 0c. Initialize io_context
+        // 0d. Initialize io_context
+        // Sharded mode (--io-shards N): N io_contexts, each with own thread & acceptor,
+        // otherwise single io_context served by hardware_concurrency threads
         const unsigned num_threads = std::max(1u, std::thread::hardware_concurrency());
-        net::io_context ioc(num_threads);
+        const bool sharded = args->io_shards > 1;
+        io_shards::IoContextShards shards(sharded ? args->io_shards : 1u, sharded ? 1u : num_threads);
+        net::io_context& ioc = shards.Primary();
+
+        if (args->shard_mode == parse::SHARD_MODE_FRONT) {
+            RunShardFront(args.value(), shards, async_log.get());
+            if (async_log) {
+                async_log->Stop();
+            }
+            boost_logger::LogServerExited(EXIT_SUCCESS);
+            utils::Pause();
+            return EXIT_SUCCESS;
+        }
 
         // 1a. Load Game data from config-file and build game model
         auto game_data = json_loader::LoadGame(args.value().config_file);
         // json_loader::CheckGameLoad(game);    // Debug
+        // Only network I/O is sharded: game sessions, players and the ticker all run on the API strand of shard 0
 
 
         // 1b. Process database
@@ -69,9 +140,9 @@ int main(int argc, const char* argv[]) {
 
         // 3. Add asynchronous signal handler for SIGINT & SIGTERM
         net::signal_set signals(ioc, SIGINT, SIGTERM);
-        signals.async_wait([&ioc](const sys::error_code& ec, [[maybe_unused]] int signal_number) {
+        signals.async_wait([&shards](const sys::error_code& ec, [[maybe_unused]] int signal_number) {
             if (!ec) {
-                ioc.stop();
+                shards.Stop();
             }
         });
 
@@ -79,30 +150,44 @@ int main(int argc, const char* argv[]) {
         auto handler = std::make_shared<http_handler::RequestHandler>(
             app, ioc);
 
-        // 4b. Wrap with logging decorator
+        // 4b. Wrap with admission control (rate limits, load shedding) and logging decorators
         server_logging::LoggingRequestHandler logging_handler{
-                                                              [handler](auto&& endpoint, auto&& req, auto&& send) {
-                                                                  (*handler)(
-                                                                             std::forward<decltype(req)>(req),
-                                                                             std::forward<decltype(send)>(send)
-                                                                            );
-                                                              }};
+                                                              admission::AdmissionRequestHandler{
+                                                                  [handler](auto&& endpoint, auto&& req, auto& arena, auto&& send) {
+                                                                      (*handler)(
+                                                                                 std::forward<decltype(req)>(req),
+                                                                                 arena,
+                                                                                 std::forward<decltype(send)>(send)
+                                                                                );
+                                                                  },
+                                                                  MakeAdmissionControl(args.value())},
+                                                              async_log.get()};
 
         // 5. Launch the HTTP request handler
-        const auto address = net::ip::make_address("0.0.0.0");
-        constexpr net::ip::port_type port = 8080;
-
-        http_server::ServeHttp(ioc, {address, port}, logging_handler);
+        if (args->shard_mode == parse::SHARD_MODE_WORKER) {
+            // Map shard worker: requests come from the front process (already logged there) over a Unix socket
+            const auto socket_path = sharding::ShardSocketPath(args->shard_socket_dir, args->shard_index);
+            sharding::ServeShardWorker(ioc, socket_path, [handler](auto&& req, auto& arena, auto&& send) {
+                (*handler)(std::forward<decltype(req)>(req), arena, std::forward<decltype(send)>(send));
+            });
+            boost_logger::LogInfo("shard worker " + std::to_string(args->shard_index) + " listening on " + socket_path);
+        } else {
+            // One SO_REUSEPORT acceptor per shard (plain single listener when not sharded)
+            http_server::ServeHttpSharded(shards, {SERVER_ADDRESS, SERVER_PORT}, logging_handler);
 
-        // This informs tests that the server is running and ready to process requests
-        boost_logger::LogServerStarted(port, address.to_string());
+            // This informs tests that the server is running and ready to process requests
+            boost_logger::LogServerStarted(SERVER_PORT, SERVER_ADDRESS.to_string());
+        }
 
         // 6. Start processing asynchronous operations
-        utils::RunWorkers(num_threads, [&ioc] {
-            ioc.run();
-        });
+        shards.Run(args->pin_threads);
+
+        // 7a. Flush queued log records
+        if (async_log) {
+            async_log->Stop();
+        }
 
-        // 7. Save Game state if required
+        // 7b. Save Game state if required
         if (!args.value().state_file.empty()) {
             app.SaveGameState(args->state_file);
         }
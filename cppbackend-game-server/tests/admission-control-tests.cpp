@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <string>
+
+#include "../src/http_server/admission_control.h"
+
+using namespace std::literals;
+using namespace http_handler;
+
+namespace {
+
+StringRequest MakeRequest(http::verb method, std::string_view target) {
+    StringRequest req{method, target, 11};
+    return req;
+}
+
+} // namespace
+
+SCENARIO("Admission control of API requests") {
+    const auto t0 = admission::Clock::time_point{} + std::chrono::hours(1);
+    const auto client = boost::asio::ip::make_address("10.0.0.1");
+    const auto other_client = boost::asio::ip::make_address("10.0.0.2");
+    auto MakeAuthorized = [](std::string_view token) {
+        auto req = MakeRequest(http::verb::get, "/api/v1/game/state"sv);
+        req.set(http::field::authorization, "Bearer " + std::string(token));
+        return req;
+    };
+
+    GIVEN("2 requests per second per token, burst 2") {
+        admission::AdmissionControl control({.token_rate = 2, .burst = 2});
+        const auto req = MakeAuthorized("0123456789abcdef0123456789abcdef");
+
+        THEN("a burst is admitted, the next request gets 429 with Retry-After until the bucket refills") {
+            CHECK(!control.Admit(client, req, t0));
+            CHECK(!control.Admit(other_client, req, t0));
+            const auto rejected = control.Admit(client, req, t0);
+            REQUIRE(rejected);
+            CHECK(rejected->result() == http::status::too_many_requests);
+            CHECK(rejected->at(http::field::retry_after) == "1"sv);
+            CHECK(!control.Admit(client, req, t0 + std::chrono::milliseconds(500)));
+            CHECK(control.Admit(client, req, t0 + std::chrono::milliseconds(600)));
+        }
+        THEN("other tokens have their own buckets") {
+            CHECK(!control.Admit(client, req, t0));
+            CHECK(!control.Admit(client, req, t0));
+            CHECK(!control.Admit(client, MakeAuthorized("ffffffffffffffffffffffffffffffff"), t0));
+        }
+    }
+
+    GIVEN("1 request per second per IP") {
+        admission::AdmissionControl control({.ip_rate = 1});
+        const auto req = MakeRequest(http::verb::get, "/api/v1/maps"sv);
+
+        THEN("each address is limited separately, IPv4 and its IPv6-mapped form alike") {
+            CHECK(!control.Admit(client, req, t0));
+            CHECK(control.Admit(client, req, t0));
+            CHECK(control.Admit(boost::asio::ip::make_address("::ffff:10.0.0.1"), req, t0));
+            CHECK(!control.Admit(other_client, req, t0));
+        }
+    }
+
+    GIVEN("a token limiter capped at 1024 buckets") {
+        admission::RateLimiter limiter(1.0, 2.0, 1024);
+        app::TokenGen gen;
+        std::chrono::seconds retry_after{};
+
+        WHEN("a flood of made-up tokens arrives") {
+            // Each new bucket has a token left, so none is full and the sweep cannot free them
+            for (int i = 0; i < 20000; ++i) {
+                limiter.TryAcquire(gen.NewKey(), t0, retry_after);
+            }
+
+            THEN("the table stays within its cap and keeps limiting") {
+                CHECK(limiter.Size() <= 1024);
+                const auto key = gen.NewKey();
+                CHECK(limiter.TryAcquire(key, t0, retry_after));
+                CHECK(limiter.TryAcquire(key, t0, retry_after));
+                CHECK_FALSE(limiter.TryAcquire(key, t0, retry_after));
+            }
+        }
+    }
+
+    GIVEN("at most 2 API requests in flight") {
+        admission::AdmissionControl control({.max_in_flight = 2});
+        const auto req = MakeRequest(http::verb::get, "/api/v1/maps"sv);
+
+        THEN("the third is shed with 503 until a response is sent") {
+            CHECK(!control.Admit(client, req, t0));
+            CHECK(!control.Admit(client, req, t0));
+            const auto shed = control.Admit(client, req, t0);
+            REQUIRE(shed);
+            CHECK(shed->result() == http::status::service_unavailable);
+            CHECK(control.InFlight() == 2);
+            control.Release();
+            CHECK(!control.Admit(client, req, t0));
+        }
+    }
+}
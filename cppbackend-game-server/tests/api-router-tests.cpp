@@ -0,0 +1,248 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <string>
+
+#include "../src/http_server/api_router.h"
+#include "../src/http_server/map_catalogue.h"
+
+using namespace std::literals;
+using namespace http_handler;
+
+namespace {
+
+// Minimal handler target: each handler answers with its own name in the body
+struct TestTarget {
+    StringResponse Maps(const RequestContext& ctx) const {
+        return response::Builder::MakeText(ctx.req, "maps"sv);
+    }
+    StringResponse MapById(const RequestContext& ctx) const {
+        return response::Builder::MakeText(ctx.req, ctx.path_params.Find("id"sv).value_or("none"sv));
+    }
+    StringResponse State(const RequestContext& ctx) const {
+        return response::Builder::MakeText(ctx.req, "state"sv);
+    }
+    StringResponse Tick(const RequestContext& ctx) const {
+        return response::Builder::MakeText(ctx.req, "tick"sv);
+    }
+};
+
+using Spec = RouteSpec<TestTarget>;
+
+constexpr auto TEST_ROUTES = routing::SortRoutes(std::array{
+    Spec{"/api/v1/maps/:id"sv, {.allowed_methods = Methods({http::verb::get, http::verb::head})}, &TestTarget::MapById},
+    Spec{"/api/v1/maps"sv, {.allowed_methods = Methods({http::verb::get, http::verb::head})}, &TestTarget::Maps},
+    Spec{"/api/v1/game/state"sv, {.allowed_methods = Methods({http::verb::get}), .requires_auth = true}, &TestTarget::State},
+    Spec{"/api/v1/game/tick"sv, {.allowed_methods = Methods({http::verb::post}),
+                                 .content_type = ContentType::APPLICATION_JSON,
+                                 .manual_tick = true}, &TestTarget::Tick},
+});
+static_assert(routing::ValidateRoutes(TEST_ROUTES));
+static_assert(!routing::IsDynamic(TEST_ROUTES[0].pattern) && routing::IsDynamic(TEST_ROUTES.back().pattern),
+              "static routes must precede dynamic ones");
+
+StringRequest MakeRequest(http::verb method, std::string_view target) {
+    StringRequest req{method, target, 11};
+    return req;
+}
+
+} // namespace
+
+SCENARIO("Route pattern matching") {
+    GIVEN("a dynamic pattern with one placeholder") {
+        constexpr auto pattern = "/api/v1/maps/:id"sv;
+
+        WHEN("the path has a value for the placeholder") {
+            PathParams params;
+            bool matched = routing::MatchPattern(pattern, "/api/v1/maps/map1"sv, params);
+            THEN("the value is a view into the path") {
+                REQUIRE(matched);
+                CHECK(params.Size() == 1);
+                CHECK(params.Find("id"sv) == "map1"sv);
+                CHECK(!params.Find("name"sv).has_value());
+            }
+        }
+        WHEN("the placeholder segment is missing or extra segments follow") {
+            PathParams params;
+            THEN("the pattern does not match and params stay empty") {
+                CHECK(!routing::MatchPattern(pattern, "/api/v1/maps"sv, params));
+                CHECK(!routing::MatchPattern(pattern, "/api/v1/maps/map1/extra"sv, params));
+                CHECK(!routing::MatchPattern(pattern, "/api/v1/game/map1"sv, params));
+                CHECK(params.Empty());
+            }
+        }
+    }
+    GIVEN("request targets with query strings and trailing slashes") {
+        THEN("they are normalized to the plain path") {
+            CHECK(routing::NormalizePath("/api/v1/maps/?a=1"sv) == "/api/v1/maps"sv);
+            CHECK(routing::NormalizePath("/api/v1/game/records?start=0"sv) == "/api/v1/game/records"sv);
+            CHECK(routing::NormalizePath("/"sv) == "/"sv);
+        }
+    }
+}
+
+SCENARIO("Routing requests through the compile-time table") {
+    GIVEN("a router over the test table") {
+        TestTarget target;
+        ApiRouter<TestTarget> router(TEST_ROUTES);
+
+        WHEN("a static route is requested") {
+            auto req = MakeRequest(http::verb::get, "/api/v1/maps"sv);
+            auto ctx = MakeRequestContext(req, nullptr);
+            auto res = router.Route(target, ctx);
+            THEN("its handler is called and static routes win over dynamic ones") {
+                REQUIRE(res.has_value());
+                CHECK(res->result() == http::status::ok);
+                CHECK(res->body() == "maps");
+            }
+        }
+        WHEN("a dynamic route is requested") {
+            auto req = MakeRequest(http::verb::head, "/api/v1/maps/town?x=1"sv);
+            auto ctx = MakeRequestContext(req, nullptr);
+            auto res = router.Route(target, ctx);
+            THEN("the path parameter reaches the handler") {
+                REQUIRE(res.has_value());
+                CHECK(res->body() == "town");
+            }
+        }
+        WHEN("an unknown path is requested") {
+            auto req = MakeRequest(http::verb::get, "/api/v1/unknown"sv);
+            auto ctx = MakeRequestContext(req, nullptr);
+            THEN("no route is found") {
+                CHECK(!router.Route(target, ctx).has_value());
+            }
+        }
+        WHEN("a method is not allowed") {
+            auto req = MakeRequest(http::verb::post, "/api/v1/maps"sv);
+            auto ctx = MakeRequestContext(req, nullptr);
+            auto res = router.Route(target, ctx);
+            THEN("405 with the Allow header is returned") {
+                REQUIRE(res.has_value());
+                CHECK(res->result() == http::status::method_not_allowed);
+                CHECK(res->at(http::field::allow) == "GET, HEAD");
+            }
+        }
+        WHEN("an endpoint requires authorization and no token is given") {
+            auto req = MakeRequest(http::verb::get, "/api/v1/game/state"sv);
+            auto ctx = MakeRequestContext(req, nullptr);
+            auto res = router.Route(target, ctx);
+            THEN("401 is returned") {
+                REQUIRE(res.has_value());
+                CHECK(res->result() == http::status::unauthorized);
+            }
+        }
+        WHEN("the Content-Type does not match") {
+            auto req = MakeRequest(http::verb::post, "/api/v1/game/tick"sv);
+            req.set(http::field::content_type, "text/plain");
+            auto ctx = MakeRequestContext(req, nullptr);
+            auto res = router.Route(target, ctx);
+            THEN("400 is returned") {
+                REQUIRE(res.has_value());
+                CHECK(res->result() == http::status::bad_request);
+            }
+        }
+    }
+    GIVEN("a router with auto-tick enabled") {
+        TestTarget target;
+        ApiRouter<TestTarget> router(TEST_ROUTES, true);
+
+        WHEN("the manual tick endpoint is requested") {
+            auto req = MakeRequest(http::verb::post, "/api/v1/game/tick"sv);
+            req.set(http::field::content_type, ContentType::APPLICATION_JSON);
+            auto ctx = MakeRequestContext(req, nullptr);
+            auto res = router.Route(target, ctx);
+            THEN("it is blocked") {
+                REQUIRE(res.has_value());
+                CHECK(res->result() == http::status::bad_request);
+                CHECK(res->body() != "tick");
+            }
+        }
+    }
+}
+
+SCENARIO("Pre-serialized map catalogue") {
+    GIVEN("a catalogue of a game with one map") {
+        model::Game game{std::make_shared<extra_data::GameExtraData>()};
+        model::Map map{model::Map::Id{"town"}, "Town"};
+        for (int i = 0; i < 50; ++i) {
+            map.AddRoad(model::Road(model::Road::HORIZONTAL, model_geom::Point2D{0, i * 10}, 100));
+        }
+        game.AddMap(std::move(map));
+        const MapCatalogue catalogue{game};
+
+        THEN("bodies are built once and shared") {
+            const auto body = catalogue.FindMap("town"sv);
+            REQUIRE(body);
+            CHECK(body == catalogue.FindMap("town"sv));
+            CHECK(body->identity.find("\"roads\"") != std::string::npos);
+            CHECK(catalogue.GetMapsList()->identity == R"([{"id":"town","name":"Town"}])");
+            CHECK_FALSE(catalogue.FindMap("unknown"sv));
+            // 50 similar roads compress well
+            CHECK_FALSE(body->gzip.empty());
+            CHECK(body->gzip.size() < body->identity.size());
+            CHECK(body->etag != body->gzip_etag);
+        }
+
+        WHEN("the map is requested without conditions") {
+            const auto body = catalogue.FindMap("town"sv);
+            auto req = MakeRequest(http::verb::get, "/api/v1/maps/town"sv);
+            auto res = MapCatalogue::MakeResponse(req, *body);
+            THEN("the identity body is sent with its ETag") {
+                CHECK(res.result() == http::status::ok);
+                CHECK(res.body() == body->identity);
+                CHECK(res.at(http::field::etag) == body->etag);
+                CHECK(res.find(http::field::content_encoding) == res.end());
+            }
+        }
+        WHEN("the client accepts gzip") {
+            const auto body = catalogue.FindMap("town"sv);
+            auto req = MakeRequest(http::verb::get, "/api/v1/maps/town"sv);
+            req.set(http::field::accept_encoding, "deflate, gzip;q=0.8");
+            auto res = MapCatalogue::MakeResponse(req, *body);
+            THEN("the gzip body is sent with its own ETag") {
+                CHECK(res.body() == body->gzip);
+                CHECK(res.at(http::field::content_encoding) == "gzip");
+                CHECK(res.at(http::field::etag) == body->gzip_etag);
+            }
+        }
+        WHEN("the client refuses gzip but accepts any other coding") {
+            const auto body = catalogue.FindMap("town"sv);
+            auto req = MakeRequest(http::verb::get, "/api/v1/maps/town"sv);
+            req.set(http::field::accept_encoding, "*, gzip;q=0");
+            auto res = MapCatalogue::MakeResponse(req, *body);
+            THEN("the deflate body is sent with its own ETag") {
+                REQUIRE_FALSE(body->deflate.empty());
+                CHECK(res.body() == body->deflate);
+                CHECK(res.at(http::field::content_encoding) == "deflate");
+                CHECK(res.at(http::field::etag) == body->deflate_etag);
+            }
+        }
+        WHEN("the client accepts neither gzip nor deflate") {
+            const auto body = catalogue.FindMap("town"sv);
+            auto req = MakeRequest(http::verb::get, "/api/v1/maps/town"sv);
+            req.set(http::field::accept_encoding, "br, gzip;q=0");
+            THEN("the identity body is sent") {
+                CHECK(MapCatalogue::MakeResponse(req, *body).body() == body->identity);
+            }
+        }
+        WHEN("If-None-Match lists the current ETag") {
+            const auto body = catalogue.GetMapsList();
+            auto req = MakeRequest(http::verb::get, "/api/v1/maps"sv);
+            req.set(http::field::if_none_match, "\"0000000000000000\", W/" + body->etag);
+            auto res = MapCatalogue::MakeResponse(req, *body);
+            THEN("304 without a body is returned") {
+                CHECK(res.result() == http::status::not_modified);
+                CHECK(res.body().empty());
+                CHECK(res.at(http::field::etag) == body->etag);
+            }
+        }
+        WHEN("If-None-Match lists another ETag") {
+            const auto body = catalogue.GetMapsList();
+            auto req = MakeRequest(http::verb::get, "/api/v1/maps"sv);
+            req.set(http::field::if_none_match, "\"0000000000000000\"");
+            THEN("the full response is sent") {
+                CHECK(MapCatalogue::MakeResponse(req, *body).result() == http::status::ok);
+            }
+        }
+    }
+}
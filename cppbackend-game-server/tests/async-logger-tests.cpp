@@ -0,0 +1,163 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/common/async_logger.h"
+
+namespace {
+
+struct Item {
+    std::uint32_t producer = 0;
+    std::uint32_t seq = 0;
+};
+
+template <typename Ring>
+bool Push(Ring& ring, std::uint32_t producer, std::uint32_t seq) {
+    return ring.TryPush([&](Item& item) {
+        item = Item{producer, seq};
+    });
+}
+
+} // namespace
+
+SCENARIO("MPSC ring with one producer") {
+    GIVEN("an empty ring of 8 cells") {
+        async_logger::MpscRing<Item, 8> ring;
+        std::vector<std::uint32_t> popped;
+        const auto pop_all = [&] {
+            while (ring.TryPop([&](const Item& item) {
+                popped.push_back(item.seq);
+            })) {
+            }
+        };
+
+        THEN("popping an empty ring fails") {
+            CHECK_FALSE(ring.TryPop([](const Item&) {}));
+        }
+
+        WHEN("it is filled to capacity") {
+            for (std::uint32_t i = 0; i < 8; ++i) {
+                REQUIRE(Push(ring, 0, i));
+            }
+
+            THEN("the next push fails until a record is popped") {
+                CHECK_FALSE(Push(ring, 0, 8));
+                REQUIRE(ring.TryPop([&](const Item& item) {
+                    popped.push_back(item.seq);
+                }));
+                CHECK(Push(ring, 0, 8));
+                CHECK_FALSE(Push(ring, 0, 9));
+                pop_all();
+                CHECK(popped == std::vector<std::uint32_t>{0, 1, 2, 3, 4, 5, 6, 7, 8});
+            }
+        }
+
+        WHEN("records are pushed and popped in uneven chunks, wrapping around many times") {
+            std::uint32_t next = 0;
+            for (int round = 0; round < 200; ++round) {
+                for (int i = 0; i < 1 + round % 8; ++i) {
+                    REQUIRE(Push(ring, 0, next++));
+                }
+                pop_all();
+            }
+
+            THEN("every record comes out once, in order") {
+                REQUIRE(popped.size() == next);
+                for (std::uint32_t i = 0; i < next; ++i) {
+                    CHECK(popped[i] == i);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("MPSC ring with several producers") {
+    GIVEN("4 producers pushing into a small ring while one consumer drains it") {
+        constexpr std::uint32_t PRODUCERS = 4;
+        constexpr std::uint32_t PER_PRODUCER = 50'000;
+        async_logger::MpscRing<Item, 64> ring;
+
+        std::vector<std::uint32_t> next_seq(PRODUCERS, 0);
+        std::uint64_t popped = 0;
+        std::uint64_t out_of_order = 0;
+        const auto consume = [&](const Item& item) {
+            if (item.producer >= PRODUCERS || item.seq != next_seq[item.producer]) {
+                ++out_of_order;
+            } else {
+                ++next_seq[item.producer];
+            }
+            ++popped;
+        };
+
+        std::vector<std::thread> producers;
+        for (std::uint32_t p = 0; p < PRODUCERS; ++p) {
+            producers.emplace_back([&, p] {
+                for (std::uint32_t seq = 0; seq < PER_PRODUCER; ++seq) {
+                    // A full ring is retried here; the logger counts a drop instead
+                    while (!Push(ring, p, seq)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        while (popped < std::uint64_t{PRODUCERS} * PER_PRODUCER) {
+            if (!ring.TryPop(consume)) {
+                std::this_thread::yield();
+            }
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+
+        THEN("every record arrives once, in the order of its producer, and the ring ends empty") {
+            CHECK(out_of_order == 0);
+            for (std::uint32_t p = 0; p < PRODUCERS; ++p) {
+                CHECK(next_seq[p] == PER_PRODUCER);
+            }
+            CHECK_FALSE(ring.TryPop(consume));
+        }
+    }
+}
+
+SCENARIO("Async logger reports every sampled-out request on shutdown") {
+    GIVEN("a logger keeping 1 of 4 requests and writing to a file") {
+        std::FILE* output = std::tmpfile();
+        REQUIRE(output != nullptr);
+        async_logger::AsyncLogger logger({.sample_rate = 4, .output = output});
+        logger.Start();
+
+        WHEN("3 request threads make 10 sampling decisions each and the logger stops") {
+            constexpr int THREADS = 3;
+            constexpr int REQUESTS = 10;
+            std::vector<std::thread> threads;
+            for (int t = 0; t < THREADS; ++t) {
+                threads.emplace_back([&logger] {
+                    for (int i = 0; i < REQUESTS; ++i) {
+                        (void)logger.Sample();
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            logger.Stop();
+
+            std::string text;
+            std::rewind(output);
+            for (int c = std::fgetc(output); c != EOF; c = std::fgetc(output)) {
+                text += static_cast<char>(c);
+            }
+            std::fclose(output);
+
+            THEN("the last report counts all of them, not only full per-thread chunks") {
+                // Each new thread keeps requests 0, 4 and 8 and skips the other 7
+                CHECK(logger.SampledOut() == THREADS * 7);
+                CHECK(text.find(R"("sampled_out":21)") != std::string::npos);
+            }
+        }
+    }
+}
@@ -0,0 +1,196 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <vector>
+
+#include "../src/common/game_utils/philox.h"
+#include "../src/common/metrics.h"
+#include "../src/game_bots/bot_manager.h"
+#include "../src/game_bots/bot_workers.h"
+
+using namespace std::literals;
+
+namespace {
+
+// 3x3 grid of roads over [0, 20] x [0, 20] with one office in the middle
+model::Map MakeGridMap() {
+    model::Map map(model::Map::Id{"grid"}, "Grid");
+    for (int c = 0; c <= 20; c += 10) {
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, model_geom::Point2D{0, c}, 20));
+        map.AddRoad(model::Road(model::Road::VERTICAL, model_geom::Point2D{c, 0}, 20));
+    }
+    map.AddOffice(model::Office(model::Office::Id{"office"}, {10, 10}, {0, 0}));
+    map.SetDefaultSpeed({2.0, 2.0});
+    map.SetDefaultCapacity(2);
+    map.BuildRoadIndex();
+    return map;
+}
+
+model::BotWorldState MakeWorldState() {
+    model::BotWorldState state;
+    std::uint32_t id = 1;
+    for (int c = 0; c <= 20; c += 5) {
+        state.loot.Add(id++, {static_cast<double>(c), 0.0});
+        state.loot.Add(id++, {20.0, static_cast<double>(c)});
+    }
+    state.loot.Build();
+    state.offices.Add(0, {10.0, 10.0});
+    state.offices.Build();
+    return state;
+}
+
+std::vector<app_geom::Position2D> RunBots(const model::Map& map, model::BotOptions options, int ticks) {
+    model::BotManager manager(&map, options);
+    manager.CreateBots();
+    const auto state = MakeWorldState();
+    for (int i = 0; i < ticks; ++i) {
+        manager.MoveBots(100ms);
+        manager.UpdateDirections(state, 100ms);
+    }
+    std::vector<app_geom::Position2D> positions;
+    for (const auto& bot : manager.GetBots()) {
+        positions.push_back(bot.second.GetPosition());
+    }
+    return positions;
+}
+
+} // namespace
+
+SCENARIO("Philox random streams") {
+    GIVEN("two generators with the same seed") {
+        game_rng::Philox4x32 a{42, 7};
+        game_rng::Philox4x32 b{42, 7};
+
+        THEN("they produce the same sequence") {
+            for (int i = 0; i < 100; ++i) {
+                CHECK(a() == b());
+            }
+        }
+    }
+
+    GIVEN("generators of different streams") {
+        game_rng::Philox4x32 a{42, 1};
+        game_rng::Philox4x32 b{42, 2};
+
+        THEN("their sequences differ") {
+            int same = 0;
+            for (int i = 0; i < 100; ++i) {
+                same += a() == b() ? 1 : 0;
+            }
+            CHECK(same < 5);
+        }
+    }
+
+    GIVEN("a generator that skips outputs") {
+        game_rng::Philox4x32 a{1, 1};
+        game_rng::Philox4x32 b{1, 1};
+        a.discard(9);
+        for (int i = 0; i < 9; ++i) {
+            b();
+        }
+        THEN("it continues where the other one is") {
+            CHECK(a() == b());
+        }
+    }
+}
+
+SCENARIO("Bot decisions are reproducible for a seed") {
+    GIVEN("a map with roads, loot and an office") {
+        const auto map = MakeGridMap();
+
+        WHEN("bots run with the same seed serially and on worker threads") {
+            model::BotWorkers workers{3};
+            auto serial = RunBots(map, {.seed = 12345}, 200);
+            auto parallel = RunBots(map, {.seed = 12345, .workers = &workers}, 200);
+
+            THEN("every bot ends up at the same position") {
+                REQUIRE(serial.size() == common_values::BOTS_PER_SESSION);
+                CHECK(serial == parallel);
+            }
+        }
+
+        WHEN("path planning is limited by a per-tick budget") {
+            model::BotWorkers workers{3};
+            auto serial = RunBots(map, {.seed = 777, .plan_budget = 10}, 200);
+            auto parallel = RunBots(map, {.seed = 777, .workers = &workers, .plan_budget = 10}, 200);
+            auto start = RunBots(map, {.seed = 777, .plan_budget = 10}, 0);
+
+            THEN("bots still move and the result does not depend on threads") {
+                CHECK(serial == parallel);
+                CHECK(serial != start);
+            }
+        }
+
+        WHEN("bots run with different seeds") {
+            auto first = RunBots(map, {.seed = 1}, 0);
+            auto second = RunBots(map, {.seed = 2}, 0);
+
+            THEN("they start at different positions") {
+                CHECK(first != second);
+            }
+        }
+    }
+}
+
+SCENARIO("Bot plan budget shared by sessions") {
+    GIVEN("a budget") {
+        model::BotPlanBudget budget;
+
+        WHEN("a tick spends more than its budget") {
+            budget.Refill(10);
+            budget.Spend(25);
+
+            THEN("the debt is paid from the next ticks and unused expansions are not saved up") {
+                CHECK_FALSE(budget.CanSearch());
+                budget.Refill(10);
+                CHECK_FALSE(budget.CanSearch());
+                budget.Refill(10);
+                CHECK(budget.Remaining() == 5);
+                budget.Refill(10);
+                CHECK(budget.Remaining() == 10);
+            }
+        }
+    }
+
+    GIVEN("two bot managers planning from one budget") {
+        const auto map = MakeGridMap();
+        const auto state = MakeWorldState();
+        model::BotManager first(&map, {.seed = 5, .plan_budget = 3});
+        model::BotManager second(&map, {.seed = 6, .plan_budget = 3});
+        first.CreateBots();
+        second.CreateBots();
+        auto& plans = metrics::Registry::Instance().GetCounter("bot_path_plans_total", "");
+
+        WHEN("the first manager runs out of the tick's budget") {
+            model::BotPlanBudget budget;
+            std::uint64_t first_plans = 0;
+            std::uint64_t second_plans = 0;
+            bool second_starved = false;
+            for (int i = 0; i < 200; ++i) {
+                budget.Refill(3);
+                first.MoveBots(100ms);
+                second.MoveBots(100ms);
+
+                auto before = plans.Value();
+                first.UpdateDirections(state, 100ms, &budget);
+                first_plans += plans.Value() - before;
+
+                const bool exhausted = !budget.CanSearch();
+                before = plans.Value();
+                second.UpdateDirections(state, 100ms, &budget);
+                const auto planned = plans.Value() - before;
+                second_plans += planned;
+                if (exhausted) {
+                    second_starved = true;
+                    CHECK(planned == 0);
+                }
+            }
+
+            THEN("the second one plans nothing in that tick, there is no per-session minimum") {
+                CHECK(second_starved);
+                CHECK(first_plans > 0);
+                CHECK(second_plans > 0);
+            }
+        }
+    }
+}
@@ -1,8 +1,9 @@
 #define _USE_MATH_DEFINES
 
-#include "../src/common/collision_detector.h"
+#include "../src/common/game_utils/collision_detector.h"
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_vector.hpp>
+#include <random>
 #include <sstream>
 #include <vector>
 
@@ -306,3 +307,32 @@ TEST_CASE("Simultaneous events with different gatherers and items") {
     CHECK(found00);
     CHECK(found10);
 }
+
+TEST_CASE("Grid-indexed search finds the same events") {
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<double> coord{0.0, 200.0};
+    std::uniform_real_distribution<double> step{-5.0, 5.0};
+    collision_detector::ItemGatherer provider;
+    for (int i = 0; i < 300; ++i) {
+        provider.AddItem({{coord(rng), coord(rng)}, i % 10 == 0 ? common_values::COLLISION_WIDTH_OFFICE : 0.0});
+    }
+    for (int i = 0; i < 200; ++i) {
+        const app_geom::Position2D start{coord(rng), coord(rng)};
+        // Every 20th gatherer stands still
+        const app_geom::Position2D end = i % 20 == 0 ? start : app_geom::Position2D{start.x + step(rng), start.y + step(rng)};
+        provider.AddGatherer({start, end, common_values::COLLISION_WIDTH_PLAYER});
+    }
+
+    auto expected = collision_detector::FindGatherEvents(provider);
+    spatial::SpatialGrid grid;
+    auto events = collision_detector::FindGatherEvents(provider, grid);
+    collision_detector::SortEvents(expected);
+
+    REQUIRE(!events.empty());
+    REQUIRE(events.size() == expected.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        CHECK(events[i].gatherer_id == expected[i].gatherer_id);
+        CHECK(events[i].item_id == expected[i].item_id);
+        CHECK(events[i].time == expected[i].time);
+    }
+}
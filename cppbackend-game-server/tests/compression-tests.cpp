@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+#include "../src/http_server/http_response.h"
+
+using namespace std::literals;
+using namespace http_handler;
+
+namespace {
+
+StringRequest MakeRequest(http::verb method, std::string_view target) {
+    StringRequest req{method, target, 11};
+    return req;
+}
+
+} // namespace
+
+SCENARIO("Response compression in the builder") {
+    // Settings are process-wide: restore the default (disabled) when the scenario ends
+    struct SettingsGuard {
+        explicit SettingsGuard(const compression::Settings& settings) {
+            compression::Configure(settings);
+        }
+        ~SettingsGuard() {
+            compression::Configure({});
+        }
+    };
+
+    GIVEN("compression enabled with a 64 byte threshold") {
+        const SettingsGuard guard{{.enabled = true, .min_size = 64, .level = compression::FAST_LEVEL}};
+        std::string large_body;
+        for (int i = 0; i < 20; ++i) {
+            large_body += R"({"id":"dog","pos":[1.0,2.0]},)";
+        }
+        auto req = MakeRequest(http::verb::get, "/api/v1/game/state"sv);
+
+        WHEN("the client accepts deflate") {
+            req.set(http::field::accept_encoding, "deflate");
+            auto res = response::Builder::MakeJson(req, json::string(large_body));
+            THEN("the body is compressed once, with Vary and the encoded length") {
+                CHECK(res.at(http::field::content_encoding) == "deflate");
+                CHECK(res.at(http::field::vary) == "Accept-Encoding");
+                CHECK(res.body() == compression::Deflate(json::serialize(json::string(large_body)),
+                                                         compression::FAST_LEVEL));
+                CHECK(res[http::field::content_length] == std::to_string(res.body().size()));
+            }
+        }
+        WHEN("the client sends no Accept-Encoding") {
+            auto res = response::Builder::MakeText(req, large_body);
+            THEN("the body is sent as it is, still varying on Accept-Encoding") {
+                CHECK(res.body() == large_body);
+                CHECK(res.find(http::field::content_encoding) == res.end());
+                CHECK(res.at(http::field::vary) == "Accept-Encoding");
+            }
+        }
+        WHEN("the body is below the threshold or the response is an error") {
+            req.set(http::field::accept_encoding, "gzip");
+            auto small = response::Builder::MakeText(req, "tick"sv);
+            auto error = response::Builder::MakeText(req, large_body, http::status::bad_request);
+            THEN("neither is compressed") {
+                CHECK(small.body() == "tick");
+                CHECK(small.find(http::field::content_encoding) == small.end());
+                CHECK(error.body() == large_body);
+                CHECK(error.find(http::field::content_encoding) == error.end());
+            }
+        }
+    }
+    GIVEN("compression disabled") {
+        auto req = MakeRequest(http::verb::get, "/api/v1/game/state"sv);
+        req.set(http::field::accept_encoding, "gzip");
+        const std::string large_body(4096, 'x');
+        THEN("responses are not touched") {
+            auto res = response::Builder::MakeText(req, large_body);
+            CHECK(res.body() == large_body);
+            CHECK(res.find(http::field::content_encoding) == res.end());
+            CHECK(res.find(http::field::vary) == res.end());
+        }
+    }
+}
@@ -2,9 +2,13 @@
 #include <catch2/catch_test_macros.hpp>
 #include <boost/asio/io_context.hpp>
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include "../src/game_model/game_model.h"
 #include "../src/game_model/game_map.h"
@@ -115,11 +119,12 @@ SCENARIO("Game session creation and retrieval") {
             auto session_id = session_data.first;
             model::GameSession* session = game.FindGameSession(session_id);
 
-            // Add dogs until the session reaches MAX_PLAYERS_ON_MAP
-            for (size_t i = session->GetDogs().size(); i < model::MAX_PLAYERS_ON_MAP; ++i) {
+            // Add dogs until the session reaches maxPlayersPerSession
+            const size_t max_players = game.GetGameExtraData()->GetMaxPlayersPerSession();
+            for (size_t i = session->GetDogs().size(); i < max_players; ++i) {
                 auto dog = session->RequestDog(static_cast<std::uint32_t>(i), "Dog" + std::to_string(i));
             }
-            REQUIRE(session->GetDogs().size() == model::MAX_PLAYERS_ON_MAP);
+            REQUIRE(session->GetDogs().size() == max_players);
 
             THEN("a new request for the same map creates a new session") {
                 auto new_session_data = game.RequestGameSession(map_id, ioc);
@@ -178,4 +183,231 @@ SCENARIO("Updating all game sessions") {
             }
         }
     }
-}
\ No newline at end of file
+}
+
+SCENARIO("Large sessions with an area of interest") {
+    GIVEN("a game configured for big sessions on a long road") {
+        boost::asio::io_context ioc;
+        auto extra_data = MakeTestExtraData();
+        extra_data->SetMaxPlayersPerSession(500);
+        model::Game game(extra_data);
+        model::Map::Id map_id("long");
+        model::Map map(map_id, "Long Road");
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, model_geom::Point2D{0, 0}, 1000));
+        game.AddMap(std::move(map));
+
+        WHEN("500 players join the map") {
+            auto first = game.RequestGameSession(map_id, ioc).first;
+            model::GameSession* session = game.FindGameSession(first);
+            for (std::uint32_t id = 0; id < 500; ++id) {
+                REQUIRE(game.RequestGameSession(map_id, ioc).first == first);
+                auto* dog = session->RequestDog(id, "Dog" + std::to_string(id));
+                dog->SetPosition({static_cast<double>(id * 2), 0.0});
+            }
+
+            THEN("they share one session and the 501st opens another") {
+                CHECK(session->GetDogs().size() == 500);
+                CHECK(game.RequestGameSession(map_id, ioc).first != first);
+            }
+
+            THEN("the interest set holds only dogs and loot within the radius") {
+                auto& storage = session->GetLootStorage();
+                storage.AddLootObject({.object_id = 1, .pos = {101.0, 0.0}});
+                storage.AddLootObject({.object_id = 2, .pos = {300.0, 0.0}});
+
+                const auto interest = session->GetInterestSet({100.0, 0.0}, 5.0);
+                std::vector<std::uint32_t> ids;
+                for (const auto* dog : interest.dogs) {
+                    ids.push_back(dog->GetId());
+                }
+                CHECK(ids == std::vector<std::uint32_t>{48, 49, 50, 51, 52});
+                REQUIRE(interest.loot.size() == 1);
+                CHECK(interest.loot.front()->object_id == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("Load-aware session placement") {
+    GIVEN("a game with two players per session") {
+        boost::asio::io_context ioc;
+        auto extra_data = MakeTestExtraData();
+        extra_data->SetMaxPlayersPerSession(2);
+        extra_data->SetDogRetirementTime(1s);
+        extra_data->SetSessionIdleTime(3s);
+        model::Game game(extra_data);
+        model::Map::Id map_id("map1");
+        model::Map map(map_id, "Map 1");
+        AddMinimalRoad(map);
+        game.AddMap(std::move(map));
+
+        auto join = [&](std::uint32_t dog_id) {
+            auto session_id = game.RequestGameSession(map_id, ioc).first;
+            auto* dog = game.FindGameSession(session_id)->RequestDog(dog_id, "Dog" + std::to_string(dog_id));
+            REQUIRE(dog != nullptr);
+            return session_id;
+        };
+
+        WHEN("players join one by one") {
+            const auto first = join(0);
+            REQUIRE(join(1) == first);
+            const auto second = join(2);
+
+            THEN("a full session sends newcomers to a new one, which is filled before a third is opened") {
+                CHECK(second != first);
+                CHECK(join(3) == second);
+                const auto third = join(4);
+                CHECK(third != first);
+                CHECK(third != second);
+            }
+        }
+
+        WHEN("every player of a session retires") {
+            using Lifecycle = model::GameSession::Lifecycle;
+            const auto first = join(0);
+            join(1);
+            model::GameSession* session = game.FindGameSession(first);
+            game.UpdateAllGameSessions(2s);
+
+            THEN("the session idles, hibernates after sessionIdleTime and wakes up for the next player") {
+                CHECK(session->GetDogs().empty());
+                CHECK(session->GetLifecycle() == Lifecycle::IDLE);
+                game.UpdateAllGameSessions(1s);
+                CHECK(session->GetLifecycle() == Lifecycle::HIBERNATED);
+
+                CHECK(join(2) == first);
+                CHECK(session->GetLifecycle() == Lifecycle::ACTIVE);
+                game.UpdateAllGameSessions(100ms);
+                CHECK(session->GetLifecycle() == Lifecycle::ACTIVE);
+                CHECK(session->GetDogs().size() == 1);
+            }
+        }
+
+        WHEN("players keep joining a reused session and retiring for a long time") {
+            const auto first = join(0);
+            for (std::uint32_t dog_id = 1; dog_id <= 1000; ++dog_id) {
+                game.UpdateAllGameSessions(1s);
+                REQUIRE(join(dog_id) == first);
+            }
+
+            THEN("the placement heap stays bounded by the number of sessions") {
+                CHECK(game.GetSessions().size() == 1);
+                CHECK(game.GetSessionLoadEntries(map_id) <= 2 * game.GetSessions().size() + 8);
+            }
+        }
+    }
+}
+
+SCENARIO("Dog retirement countdown") {
+    GIVEN("a session with a 1 second retirement time") {
+        boost::asio::io_context ioc;
+        auto extra_data = MakeTestExtraData();
+        extra_data->SetDogRetirementTime(1s);
+        model::Game game(extra_data);
+        model::Map::Id map_id("map1");
+        model::Map map(map_id, "Map 1");
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, model_geom::Point2D{0, 0}, 1000));
+        map.SetDefaultSpeed({1.0, 1.0});
+        game.AddMap(std::move(map));
+
+        model::GameSession* session = game.FindGameSession(game.RequestGameSession(map_id, ioc).first);
+        model::Dog* standing = session->RequestDog(0, "Standing");
+        model::Dog* walking = session->RequestDog(1, "Walking");
+
+        WHEN("one dog keeps walking and the other stands still") {
+            session->SetDogDirection(*walking, app_geom::Direction2D::RIGHT);
+            session->UpdateGameState(600ms);
+            CHECK(session->GetDogs().size() == 2);
+            session->UpdateGameState(400ms);
+
+            THEN("only the standing dog retires, exactly at the deadline") {
+                CHECK(session->FindDog(0) == nullptr);
+                CHECK(session->FindDog(1) != nullptr);
+            }
+        }
+
+        WHEN("a dog walks for a while and stops") {
+            session->SetDogDirection(*standing, app_geom::Direction2D::RIGHT);
+            session->UpdateGameState(900ms);
+            session->SetDogDirection(*standing, app_geom::Direction2D::STOP);
+            session->UpdateGameState(900ms);
+
+            THEN("its countdown starts over from the stop") {
+                CHECK(session->FindDog(0) != nullptr);
+                session->UpdateGameState(100ms);
+                CHECK(session->FindDog(0) == nullptr);
+            }
+        }
+
+        WHEN("several actions of a player are posted before a tick") {
+            auto slot = std::make_shared<model::ActionSlot>(0);
+            session->PostDogDirection(slot, app_geom::Direction2D::LEFT);
+            session->PostDogDirection(slot, app_geom::Direction2D::STOP);
+            session->PostDogDirection(slot, app_geom::Direction2D::RIGHT);
+            // Posted for a dog that has retired already
+            session->PostDogDirection(std::make_shared<model::ActionSlot>(42), app_geom::Direction2D::LEFT);
+
+            THEN("nothing changes until the tick, which applies only the last one") {
+                CHECK(standing->GetSpeed() == app_geom::Speed2D::Zero());
+                session->UpdateGameState(600ms);
+                CHECK(standing->GetDirection() == app_geom::Direction2D::RIGHT);
+                CHECK(standing->GetPosition().x > 0.5);
+                session->UpdateGameState(600ms);
+                CHECK(session->FindDog(0) != nullptr);
+            }
+        }
+    }
+}
+
+SCENARIO("Action inbox under concurrent posts and drains") {
+    GIVEN("one writer thread per slot and a draining tick thread") {
+        constexpr std::uint32_t SLOTS = 8;
+        constexpr int POSTS = 20000;
+        constexpr std::array MOVES{app_geom::Direction2D::LEFT, app_geom::Direction2D::RIGHT,
+                                   app_geom::Direction2D::UP, app_geom::Direction2D::DOWN};
+
+        THEN("the last intent of every writer is applied, in every round") {
+            for (int round = 0; round < 20; ++round) {
+                model::ActionInbox inbox;
+                std::vector<std::shared_ptr<model::ActionSlot>> slots;
+                for (std::uint32_t i = 0; i < SLOTS; ++i) {
+                    slots.push_back(std::make_shared<model::ActionSlot>(i));
+                }
+                // Writers post STOP only as their final intent
+                std::vector<app_geom::Direction2D> applied(SLOTS, app_geom::Direction2D::LEFT);
+                const auto apply = [&applied](std::uint32_t dog_id, app_geom::Direction2D dir) {
+                    applied[dog_id] = dir;
+                };
+
+                std::atomic<std::uint32_t> writing{SLOTS};
+                std::vector<std::thread> writers;
+                for (std::uint32_t i = 0; i < SLOTS; ++i) {
+                    writers.emplace_back([&, i] {
+                        for (int n = 0; n < POSTS; ++n) {
+                            inbox.Post(slots[i], MOVES[(n + i) % MOVES.size()]);
+                        }
+                        // The final intent, the one a lost wakeup would leave behind
+                        inbox.Post(slots[i], app_geom::Direction2D::STOP);
+                        writing.fetch_sub(1, std::memory_order_release);
+                    });
+                }
+                while (writing.load(std::memory_order_acquire) != 0) {
+                    inbox.Drain(apply);
+                }
+                for (auto& writer : writers) {
+                    writer.join();
+                }
+                inbox.Drain(apply);
+
+                for (std::uint32_t i = 0; i < SLOTS; ++i) {
+                    CHECK(applied[i] == app_geom::Direction2D::STOP);
+                }
+                int left_over = 0;
+                inbox.Drain([&left_over](std::uint32_t, app_geom::Direction2D) {
+                    ++left_over;
+                });
+                CHECK(left_over == 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include "../src/common/metrics.h"
+
+using namespace std::literals;
+
+namespace {
+
+// Value of one rendered series ("name{labels} value"), empty if the series is missing
+std::string SeriesValue(const std::string& text, const std::string& series) {
+    const auto line = "\n" + series + " ";
+    const auto pos = text.find(line);
+    if (pos == std::string::npos) {
+        return {};
+    }
+    const auto begin = pos + line.size();
+    return text.substr(begin, text.find('\n', begin) - begin);
+}
+
+} // namespace
+
+SCENARIO("Histogram buckets") {
+    GIVEN("an empty histogram") {
+        metrics::Histogram histogram;
+
+        WHEN("values are observed on both sides of a power of two") {
+            histogram.Observe(15us);
+            histogram.Observe(16us);
+            histogram.Observe(17us);
+
+            THEN("2^k - 1 is the upper bound of a bucket and 2^k starts the next one") {
+                CHECK(metrics::Histogram::BucketUpperBound(metrics::Histogram::BucketIndex(15)) == 15);
+                CHECK(metrics::Histogram::BucketIndex(16) == metrics::Histogram::BucketIndex(15) + 1);
+                CHECK(histogram.CountAtMost(15) == 1);
+                CHECK(histogram.CountAtMost(31) == 3);
+                CHECK(histogram.Count() == 3);
+                CHECK(histogram.SumMicroseconds() == 48);
+            }
+        }
+
+        WHEN("values are observed across the range") {
+            for (std::int64_t us = 0; us < 1000; ++us) {
+                histogram.Observe(std::chrono::microseconds{us});
+            }
+
+            THEN("a quantile is the upper bound of its bucket, within 1/SUB_BUCKETS of the exact value") {
+                const auto p50 = histogram.ValueAtQuantile(0.5);
+                CHECK(p50 >= 500);
+                CHECK(p50 < 500 + 500 / metrics::Histogram::SUB_BUCKETS);
+                CHECK(histogram.ValueAtQuantile(0.0) == 0);
+                CHECK(histogram.ValueAtQuantile(1.0)
+                      == metrics::Histogram::BucketUpperBound(metrics::Histogram::BucketIndex(999)));
+            }
+        }
+    }
+}
+
+SCENARIO("Prometheus rendering") {
+    auto& registry = metrics::Registry::Instance();
+
+    // The registry is process-wide, so values are recorded once and checked in one THEN
+    GIVEN("a counter, a gauge and a histogram") {
+        auto& counter = registry.GetCounter("test_render_total", "Test counter", R"(kind="a")");
+        auto& gauge = registry.GetGauge("test_render_gauge", "Test gauge");
+        auto& histogram = registry.GetHistogram("test_render_seconds", "Test histogram");
+
+        counter.Inc(3);
+        gauge.Set(-7);
+        // Exactly on the 2^4 us boundary, then one just below it
+        histogram.Observe(16us);
+        histogram.Observe(15us);
+
+        WHEN("the registry is rendered") {
+            const auto text = "\n" + registry.Render();
+
+            THEN("counters and gauges carry their labels, and every le bucket counts observations <= its bound") {
+                CHECK(text.find("\n# TYPE test_render_total counter\n") != std::string::npos);
+                CHECK(SeriesValue(text, R"(test_render_total{kind="a"})") == "3");
+                CHECK(text.find("\n# TYPE test_render_gauge gauge\n") != std::string::npos);
+                CHECK(SeriesValue(text, "test_render_gauge") == "-7");
+                CHECK(text.find("\n# TYPE test_render_seconds histogram\n") != std::string::npos);
+                CHECK(SeriesValue(text, R"(test_render_seconds_bucket{le="0.000015"})") == "1");
+                CHECK(SeriesValue(text, R"(test_render_seconds_bucket{le="0.000031"})") == "2");
+                CHECK(SeriesValue(text, R"(test_render_seconds_bucket{le="33.554431"})") == "2");
+                CHECK(SeriesValue(text, R"(test_render_seconds_bucket{le="+Inf"})") == "2");
+                CHECK(SeriesValue(text, "test_render_seconds_sum") == "0.000031");
+                CHECK(SeriesValue(text, "test_render_seconds_count") == "2");
+            }
+        }
+    }
+
+    GIVEN("a metric name registered as a counter") {
+        registry.GetCounter("test_render_type_clash", "Test counter");
+
+        THEN("registering it as another type throws") {
+            CHECK_THROWS_AS(registry.GetGauge("test_render_type_clash", "Test gauge"), std::logic_error);
+        }
+    }
+}
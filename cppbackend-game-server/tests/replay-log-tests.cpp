@@ -0,0 +1,215 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include <boost/asio/io_context.hpp>
+
+#include "../src/game_app/application.h"
+#include "../src/game_app/replay_log.h"
+#include "../src/game_db/mock_database.h"
+
+using namespace std::literals;
+
+namespace {
+
+const model::Map::Id MAP_ID{"grid"s};
+
+// 3x3 grid of roads over [0, 20] x [0, 20] with one office and one loot type
+model::Game MakeGame() {
+    auto extra = std::make_shared<extra_data::GameExtraData>();
+    extra->AddLootGeneratorConfig({1s, 0.5});
+    extra_data::LootData loot_data;
+    loot_data.map_id = MAP_ID;
+    loot_data.name = "coin";
+    loot_data.value = 5;
+    extra->AddLootTypes(MAP_ID, {loot_data});
+
+    model::Game game{extra};
+    model::Map map(MAP_ID, "Grid");
+    for (int c = 0; c <= 20; c += 10) {
+        map.AddRoad(model::Road(model::Road::HORIZONTAL, model_geom::Point2D{0, c}, 20));
+        map.AddRoad(model::Road(model::Road::VERTICAL, model_geom::Point2D{c, 0}, 20));
+    }
+    map.AddOffice(model::Office(model::Office::Id{"office"}, {10, 10}, {0, 0}));
+    map.SetDefaultSpeed({2.0, 2.0});
+    map.SetDefaultCapacity(3);
+    game.AddMap(std::move(map));
+    return game;
+}
+
+parse::Args MakeArgs() {
+    parse::Args args;
+    args.config_file = "grid.json";
+    args.enable_bots = true;
+    args.bot_seed = 11;
+    args.game_seed = 22;
+    args.randomize_spawn_points = true;
+    args.no_database = true;
+    return args;
+}
+
+// Joins two players and walks them around the grid
+void PlayScript(app::Application& app) {
+    using app_geom::Direction2D;
+    const Direction2D moves[] = {Direction2D::RIGHT, Direction2D::DOWN, Direction2D::LEFT, Direction2D::UP};
+    const auto& first = app.AddPlayer("first", *MAP_ID);
+    auto first_id = first.GetId();
+    for (int tick = 0; tick < 300; ++tick) {
+        if (tick == 40) {
+            (void)app.AddPlayer("second", *MAP_ID);
+        }
+        if (tick % 25 == 0) {
+            app.SetPlayerDirection(*app.GetPlayers().FindPlayerById(first_id), moves[tick / 25 % 4]);
+        }
+        app.Tick(tick % 3 == 0 ? 50ms : 30ms);
+    }
+}
+
+std::uint64_t Replay(const std::filesystem::path& log, size_t& ticks) {
+    replay::ReplayReader reader(log);
+    const auto& header = reader.GetHeader();
+    parse::Args args;
+    args.enable_bots = header.enable_bots;
+    args.bot_seed = header.bot_seed;
+    args.game_seed = header.game_seed;
+    args.randomize_spawn_points = header.randomize_spawn_points;
+    args.no_database = !header.enable_retirement;
+
+    // Sessions hold strands of the io_context: it must outlive the game
+    boost::asio::io_context ioc;
+    auto game = MakeGame();
+    db::MockDatabase database;
+    app::Application app(game, args, ioc, database);
+
+    replay::Record record;
+    while (reader.Next(record)) {
+        switch (record.type) {
+            case replay::RecordType::TICK:
+                app.Tick(record.delta);
+                ++ticks;
+                break;
+            case replay::RecordType::JOIN:
+                (void)app.AddPlayer(record.name, record.map);
+                break;
+            case replay::RecordType::ACTION:
+                app.SetPlayerDirection(*app.GetPlayers().FindPlayerById(record.player_id), record.direction);
+                break;
+        }
+    }
+    return replay::HashGameState(game);
+}
+
+} // namespace
+
+SCENARIO("Replay log records") {
+    const auto path = std::filesystem::temp_directory_path() / "replay-log-tests-records.bin";
+
+    GIVEN("a log with a header and every record type") {
+        {
+            replay::ReplayWriter writer(path, {"config.json", 1ull << 40, 7, 300, true, false, true});
+            writer.WriteJoin("dog", "map1");
+            writer.WriteAction(3, app_geom::Direction2D::LEFT);
+            writer.WriteTick(1234ms);
+        }
+
+        WHEN("it is read back") {
+            replay::ReplayReader reader(path);
+            const auto& header = reader.GetHeader();
+            replay::Record join, action, tick, end;
+            const bool has_records = reader.Next(join) && reader.Next(action) && reader.Next(tick);
+
+            THEN("header and records are the same") {
+                CHECK(header.config_file == "config.json");
+                CHECK(header.game_seed == 1ull << 40);
+                CHECK(header.bot_seed == 7);
+                CHECK(header.bot_plan_budget == 300);
+                CHECK(header.enable_bots);
+                CHECK_FALSE(header.randomize_spawn_points);
+                CHECK(header.enable_retirement);
+
+                REQUIRE(has_records);
+                CHECK(join.type == replay::RecordType::JOIN);
+                CHECK(join.name == "dog");
+                CHECK(join.map == "map1");
+                CHECK(action.type == replay::RecordType::ACTION);
+                CHECK(action.player_id == 3);
+                CHECK(action.direction == app_geom::Direction2D::LEFT);
+                CHECK(tick.type == replay::RecordType::TICK);
+                CHECK(tick.delta == 1234ms);
+                CHECK_FALSE(reader.Next(end));
+            }
+        }
+
+        WHEN("the last record is cut off") {
+            const auto size = std::filesystem::file_size(path);
+            std::filesystem::resize_file(path, size - 1);
+            replay::ReplayReader reader(path);
+            replay::Record record;
+
+            THEN("the log ends before it") {
+                CHECK(reader.Next(record));
+                CHECK(reader.Next(record));
+                CHECK_FALSE(reader.Next(record));
+            }
+        }
+    }
+
+    GIVEN("a file that is not a replay log") {
+        std::ofstream{path} << "not a log";
+
+        THEN("reading it throws") {
+            CHECK_THROWS(replay::ReplayReader{path});
+        }
+    }
+
+    std::filesystem::remove(path);
+}
+
+SCENARIO("Replay reproduces a recorded game") {
+    const auto path = std::filesystem::temp_directory_path() / "replay-log-tests-game.bin";
+
+    GIVEN("a game recorded with players, bots and random spawns") {
+        boost::asio::io_context ioc;
+        auto game = MakeGame();
+        auto args = MakeArgs();
+        args.record_replay = path.string();
+        std::uint64_t recorded_hash = 0;
+        {
+            db::MockDatabase database;
+            app::Application app(game, args, ioc, database);
+            PlayScript(app);
+            recorded_hash = replay::HashGameState(game);
+        }
+
+        WHEN("the log is replayed twice") {
+            size_t first_ticks = 0, second_ticks = 0;
+            const auto first = Replay(path, first_ticks);
+            const auto second = Replay(path, second_ticks);
+
+            THEN("both end in the recorded state") {
+                CHECK(first_ticks == 300);
+                CHECK(first == recorded_hash);
+                CHECK(second == recorded_hash);
+            }
+        }
+
+        WHEN("the same script runs with another game seed") {
+            boost::asio::io_context other_ioc;
+            auto other_game = MakeGame();
+            auto other_args = MakeArgs();
+            other_args.game_seed = 23;
+            db::MockDatabase database;
+            app::Application app(other_game, other_args, other_ioc, database);
+            PlayScript(app);
+
+            THEN("the state differs") {
+                CHECK(replay::HashGameState(other_game) != recorded_hash);
+            }
+        }
+    }
+
+    std::filesystem::remove(path);
+}
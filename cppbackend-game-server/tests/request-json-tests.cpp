@@ -0,0 +1,43 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string_view>
+
+#include "../src/http_server/request_json.h"
+
+using namespace std::literals;
+using namespace http_handler;
+
+SCENARIO("Fast path parsing of join and action bodies") {
+    GIVEN("plain bodies") {
+        THEN("members are found in any order and with any whitespace") {
+            const auto join = request_json::ParseJoinBody(R"({"userName":"Scooby Doo","mapId":"map1"})"sv);
+            REQUIRE(join);
+            CHECK(join->user_name == "Scooby Doo"sv);
+            CHECK(join->map_id == "map1"sv);
+
+            const auto reordered = request_json::ParseJoinBody(" {\n\t\"mapId\" : \"town\" ,\"userName\":\"\"}\r\n"sv);
+            REQUIRE(reordered);
+            CHECK(reordered->user_name.empty());
+            CHECK(reordered->map_id == "town"sv);
+
+            CHECK(request_json::ParseActionBody(R"({"move":"L"})"sv) == "L"sv);
+            CHECK(request_json::ParseActionBody(R"({ "move" : "" })"sv) == ""sv);
+            // Unknown move values are rejected by the handler, as with the generic parser
+            CHECK(request_json::ParseActionBody(R"({"move":"X"})"sv) == "X"sv);
+        }
+    }
+
+    GIVEN("bodies of another shape") {
+        THEN("they are left to the generic parser") {
+            for (const auto body : {R"({"move":"L")"sv, R"({"move":"L"}x)"sv, R"({"move":1})"sv, R"({"move":"\u004C"})"sv,
+                                    R"({"move":"L","move":"R"})"sv, R"({"move":"L","extra":"1"})"sv, R"({})"sv,
+                                    R"(["move","L"])"sv, ""sv}) {
+                CHECK_FALSE(request_json::ParseActionBody(body));
+            }
+            CHECK_FALSE(request_json::ParseJoinBody(R"({"userName":"Dog"})"sv));
+            CHECK_FALSE(request_json::ParseJoinBody(R"({"userName":"Dog","userName":"Cat"})"sv));
+            CHECK_FALSE(request_json::ParseJoinBody(R"({"userName":null,"mapId":"map1"})"sv));
+            CHECK_FALSE(request_json::ParseJoinBody("{\"userName\":\"\xD0\x9F\xD1\x91\xD1\x81\",\"mapId\":\"map1\"}"sv));
+        }
+    }
+}
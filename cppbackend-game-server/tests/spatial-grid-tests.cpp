@@ -0,0 +1,156 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../src/common/game_utils/spatial_grid.h"
+
+namespace {
+
+// Reference answer: sort every accepted item by distance
+template <typename Filter>
+std::vector<std::uint32_t> BruteForceNearest(const std::vector<spatial::Item>& items,
+                                             app_geom::Position2D pos, size_t k, Filter filter) {
+    std::vector<std::pair<double, std::uint32_t>> all;
+    for (const auto& item : items) {
+        if (filter(item)) {
+            all.emplace_back(std::hypot(item.pos.x - pos.x, item.pos.y - pos.y), item.id);
+        }
+    }
+    std::ranges::sort(all);
+    std::vector<std::uint32_t> ids;
+    for (size_t i = 0; i < std::min(k, all.size()); ++i) {
+        ids.push_back(all[i].second);
+    }
+    return ids;
+}
+
+std::vector<std::uint32_t> Ids(const std::vector<spatial::Neighbor>& neighbors) {
+    std::vector<std::uint32_t> ids;
+    for (const auto& neighbor : neighbors) {
+        ids.push_back(neighbor.id);
+    }
+    return ids;
+}
+
+} // namespace
+
+SCENARIO("Spatial grid nearest queries") {
+    GIVEN("an empty grid") {
+        spatial::SpatialGrid grid;
+        grid.Build();
+
+        THEN("queries find nothing") {
+            std::vector<spatial::Neighbor> out;
+            grid.KNearest({1.0, 1.0}, 3, out);
+            CHECK(out.empty());
+            CHECK_FALSE(grid.Nearest({1.0, 1.0}).has_value());
+            CHECK(grid.Find(1) == nullptr);
+        }
+    }
+
+    GIVEN("a few items on a line") {
+        spatial::SpatialGrid grid;
+        grid.Add(10, {0.0, 0.0});
+        grid.Add(20, {5.0, 0.0});
+        grid.Add(30, {9.0, 0.0});
+        grid.Build();
+
+        WHEN("the nearest item is requested") {
+            auto nearest = grid.Nearest({6.0, 0.5});
+            THEN("the closest one is returned with its distance") {
+                REQUIRE(nearest.has_value());
+                CHECK(nearest->id == 20);
+                CHECK(std::abs(nearest->distance - std::hypot(1.0, 0.5)) < 1e-9);
+            }
+        }
+
+        WHEN("a filter rejects the closest item") {
+            auto nearest = grid.Nearest({6.0, 0.0}, [](const spatial::Item& item) { return item.id != 20; });
+            THEN("the next closest accepted item is returned") {
+                REQUIRE(nearest.has_value());
+                CHECK(nearest->id == 30);
+            }
+        }
+
+        WHEN("more items are requested than the grid holds") {
+            std::vector<spatial::Neighbor> out;
+            grid.KNearest({-3.0, 0.0}, 10, out);
+            THEN("all items are returned sorted by distance") {
+                CHECK(Ids(out) == std::vector<std::uint32_t>{10, 20, 30});
+            }
+        }
+
+        WHEN("items are looked up by id") {
+            THEN("present ids are found and absent ids are not") {
+                REQUIRE(grid.Find(30) != nullptr);
+                CHECK(grid.Find(30)->pos.x == 9.0);
+                CHECK(grid.Find(25) == nullptr);
+            }
+        }
+    }
+
+    GIVEN("many random items") {
+        std::mt19937 rng{42};
+        std::uniform_real_distribution<double> coord{0.0, 100.0};
+        std::vector<spatial::Item> items;
+        spatial::SpatialGrid grid;
+        for (std::uint32_t id = 0; id < 500; ++id) {
+            items.push_back({id, {coord(rng), coord(rng)}});
+            grid.Add(items.back().id, items.back().pos);
+        }
+        grid.Build();
+        REQUIRE(grid.Size() == items.size());
+
+        THEN("k-nearest matches brute force, inside and outside the grid bounds") {
+            auto even = [](const spatial::Item& item) { return item.id % 2 == 0; };
+            std::uniform_real_distribution<double> query{-20.0, 120.0};
+            std::vector<spatial::Neighbor> out;
+            for (int i = 0; i < 200; ++i) {
+                app_geom::Position2D pos{query(rng), query(rng)};
+
+                grid.KNearest(pos, 5, out);
+                CHECK(Ids(out) == BruteForceNearest(items, pos, 5, [](const spatial::Item&) { return true; }));
+
+                grid.KNearest(pos, 3, even, out);
+                CHECK(Ids(out) == BruteForceNearest(items, pos, 3, even));
+            }
+        }
+
+        THEN("radius queries match brute force") {
+            std::uniform_real_distribution<double> query{-20.0, 120.0};
+            std::uniform_real_distribution<double> radius{0.0, 30.0};
+            for (int i = 0; i < 200; ++i) {
+                const app_geom::Position2D pos{query(rng), query(rng)};
+                const double r = radius(rng);
+
+                std::vector<std::uint32_t> found;
+                grid.ForEachInRadius(pos, r, [&found](const spatial::Item& item) { found.push_back(item.id); });
+                std::ranges::sort(found);
+
+                std::vector<std::uint32_t> expected;
+                for (const auto& item : items) {
+                    const double dx = item.pos.x - pos.x;
+                    const double dy = item.pos.y - pos.y;
+                    if (dx * dx + dy * dy <= r * r) {
+                        expected.push_back(item.id);
+                    }
+                }
+                CHECK(found == expected);
+            }
+        }
+
+        WHEN("the grid is rebuilt with another set") {
+            grid.Clear();
+            grid.Add(7, {50.0, 50.0});
+            grid.Build();
+            THEN("only the new items are indexed") {
+                CHECK(grid.Size() == 1);
+                CHECK(grid.Find(0) == nullptr);
+                CHECK(grid.Nearest({0.0, 0.0})->id == 7);
+            }
+        }
+    }
+}
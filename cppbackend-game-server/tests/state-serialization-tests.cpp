@@ -3,6 +3,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <sstream>
 #include <memory>
+#include <span>
+#include <vector>
 
 #include "../src/game_model/game_model.h"
 #include "../src/game_app/players.h"
@@ -261,4 +263,80 @@ SCENARIO_METHOD(Fixture, "GameRepr empty serialization") {
             }
         }
     }
-}
\ No newline at end of file
+}
+//------------------------------------------------------------------------------
+// Players membership indexes – join, retirement and restore
+//------------------------------------------------------------------------------
+namespace {
+
+std::vector<std::uint32_t> PlayerIds(std::span<const app::Player* const> players) {
+    std::vector<std::uint32_t> ids;
+    for (const auto* player : players) {
+        ids.push_back(player->GetId());
+    }
+    return ids;
+}
+
+} // namespace
+
+SCENARIO_METHOD(Fixture, "Players membership indexes") {
+    GIVEN("players joined on two maps") {
+        // Sessions hold strands of the io_context, so it must outlive the game
+        boost::asio::io_context ioc;
+        const model::Map::Id map1_id("map1"s), map2_id("map2"s);
+        auto extra = CreateExtraDataWithLoot(map1_id);
+        extra->AddLootGeneratorConfig({1s, 0.5});
+        model::Game game(extra);
+        game.AddMap(*CreateTestMap(map1_id));
+        game.AddMap(*CreateTestMap(map2_id));
+
+        app::Players players(game);
+        const auto& first = players.AddPlayer("first", "map1", 0ms, ioc);
+        const auto& second = players.AddPlayer("second", "map2", 0ms, ioc);
+        const auto& third = players.AddPlayer("third", "map1", 0ms, ioc);
+        const auto session1 = first.GetGameSession()->GetId();
+        const auto session2 = second.GetGameSession()->GetId();
+
+        THEN("queries return the members ordered by ID") {
+            CHECK(PlayerIds(players.GetPlayersAll()) == std::vector<std::uint32_t>{1, 2, 3});
+            CHECK(PlayerIds(players.GetPlayersByMap(map1_id)) == std::vector<std::uint32_t>{1, 3});
+            CHECK(PlayerIds(players.GetPlayersByMap(map2_id)) == std::vector<std::uint32_t>{2});
+            CHECK(PlayerIds(players.GetPlayersBySession(session1)) == std::vector<std::uint32_t>{1, 3});
+            CHECK(PlayerIds(players.GetPlayersBySession(session2)) == std::vector<std::uint32_t>{2});
+            CHECK(players.GetPlayersByMap(model::Map::Id("unknown"s)).empty());
+        }
+
+        WHEN("a player retires") {
+            players.RemoveRetiredPlayer(third.GetId());
+
+            THEN("it is gone from every index") {
+                CHECK(PlayerIds(players.GetPlayersAll()) == std::vector<std::uint32_t>{1, 2});
+                CHECK(PlayerIds(players.GetPlayersByMap(map1_id)) == std::vector<std::uint32_t>{1});
+                CHECK(PlayerIds(players.GetPlayersBySession(session1)) == std::vector<std::uint32_t>{1});
+            }
+        }
+
+        WHEN("the game is saved and restored") {
+            serialize_game_save::GameRepr repr(game, players);
+            output_archive << repr;
+
+            strm.seekg(0);
+            InputArchive input_archive{strm};
+            serialize_game_save::GameRepr restored_repr;
+            input_archive >> restored_repr;
+
+            boost::asio::io_context restored_ioc;
+            model::Game restored_game(extra);
+            restored_game.AddMap(*CreateTestMap(map1_id));
+            restored_game.AddMap(*CreateTestMap(map2_id));
+            app::Players restored_players(restored_game);
+            restored_repr.Restore(restored_game, restored_players, restored_ioc);
+
+            THEN("restored players are indexed the same way") {
+                CHECK(PlayerIds(restored_players.GetPlayersAll()) == std::vector<std::uint32_t>{1, 2, 3});
+                CHECK(PlayerIds(restored_players.GetPlayersByMap(map1_id)) == std::vector<std::uint32_t>{1, 3});
+                CHECK(PlayerIds(restored_players.GetPlayersBySession(session2)) == std::vector<std::uint32_t>{2});
+            }
+        }
+    }
+}
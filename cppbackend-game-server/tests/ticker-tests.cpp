@@ -0,0 +1,69 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../src/common/metrics.h"
+#include "../src/common/ticker.h"
+
+using namespace std::literals;
+
+SCENARIO("Fixed-step ticker catching up after a slow tick") {
+    using Clock = std::chrono::steady_clock;
+    auto& registry = metrics::Registry::Instance();
+    auto& catch_up_steps = registry.GetCounter("game_tick_catch_up_steps_total", "");
+    auto& dropped_steps = registry.GetCounter("game_tick_dropped_steps_total", "");
+
+    // The registry is process-wide, so the ticker runs once and everything is checked in one THEN
+    GIVEN("a 50 ms fixed-step ticker with at most 3 calls per wakeup whose first call takes 210 ms") {
+        constexpr auto PERIOD = 50ms;
+        constexpr auto SLOW_CALL = 210ms;
+        constexpr size_t CALLS = 5;
+
+        boost::asio::io_context ioc;
+        std::vector<std::chrono::milliseconds> deltas;
+        std::vector<Clock::time_point> call_times;
+        std::shared_ptr<tick::Ticker> ticker;
+        ticker = std::make_shared<tick::Ticker>(
+            boost::asio::make_strand(ioc),
+            tick::TickerOptions{.period = PERIOD, .fixed_step = true, .max_catch_up = 3},
+            [&](std::chrono::milliseconds delta) {
+                deltas.push_back(delta);
+                call_times.push_back(Clock::now());
+                if (deltas.size() == 1) {
+                    // A restart would move the deadlines to now and hide part of the lag below
+                    ticker->Start();
+                    std::this_thread::sleep_for(SLOW_CALL);
+                }
+                if (deltas.size() == CALLS) {
+                    ioc.stop();
+                }
+            });
+        const auto catch_up_before = catch_up_steps.Value();
+        const auto dropped_before = dropped_steps.Value();
+
+        WHEN("it runs until the fifth call") {
+            ticker->Start();
+            ticker->Start();
+            ioc.run_for(5s);
+
+            THEN("the late wakeup runs 3 of the 4 due steps, drops one and moves the deadline by all 4 periods") {
+                REQUIRE(deltas.size() == CALLS);
+                // Every call gets the fixed period, however late it runs
+                for (const auto delta : deltas) {
+                    CHECK(delta == PERIOD);
+                }
+                // The next deadline was 50 ms after the first one, so the wakeup 210 ms after it is
+                // 160 ms late: due = 1 + 160 / 50 = 4 steps, max_catch_up allows 3
+                CHECK(catch_up_steps.Value() - catch_up_before == 2);
+                CHECK(dropped_steps.Value() - dropped_before == 1);
+                // Calls 2-4 run back to back right after the slow one
+                CHECK(call_times[3] - call_times[1] < PERIOD);
+                // The deadline moved by period * due: call 5 waits for first deadline + 5 periods,
+                // while first deadline + 4 periods had already passed when call 4 ran
+                CHECK(call_times[4] - call_times[0] >= 5 * PERIOD - 15ms);
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "../src/common/game_utils/timing_wheel.h"
+
+using Wheel = timing::TimingWheel<std::uint32_t>;
+
+SCENARIO("Timing wheel") {
+    GIVEN("a wheel at time 100") {
+        Wheel wheel(100);
+        std::vector<std::uint32_t> expired;
+
+        WHEN("values are scheduled at different distances") {
+            wheel.Schedule(150, 1);         // level 0
+            wheel.Schedule(5'000, 2);       // level 1
+            wheel.Schedule(300'000, 3);     // level 3
+            wheel.Schedule(101, 4);
+
+            THEN("each fires on the first Advance that reaches its deadline, in deadline order") {
+                wheel.Advance(149, expired);
+                CHECK(expired == std::vector<std::uint32_t>{4});
+                wheel.Advance(150, expired);
+                CHECK(expired == std::vector<std::uint32_t>{4, 1});
+                wheel.Advance(4'999, expired);
+                CHECK(expired.size() == 2);
+                wheel.Advance(1'000'000, expired);
+                CHECK(expired == std::vector<std::uint32_t>{4, 1, 2, 3});
+                CHECK(wheel.Size() == 0);
+                CHECK(wheel.Now() == 1'000'000);
+            }
+        }
+
+        WHEN("a deadline is not in the future") {
+            wheel.Schedule(100, 7);
+            wheel.Schedule(10, 8);
+
+            THEN("it fires on the next Advance, even without moving time") {
+                CHECK(wheel.Size() == 2);
+                wheel.Advance(100, expired);
+                CHECK(expired == std::vector<std::uint32_t>{7, 8});
+            }
+        }
+    }
+
+    GIVEN("random deadlines and irregular steps") {
+        std::mt19937_64 rng(42);
+        Wheel wheel;
+        std::multimap<std::uint64_t, std::uint32_t> reference;
+        std::vector<std::uint64_t> deadline_of;
+        std::uint64_t now = 0;
+        std::uint32_t next_value = 0;
+        bool same = true;
+
+        for (int round = 0; round < 2000 && same; ++round) {
+            // Mostly game-like distances, some far ones
+            const int count = static_cast<int>(rng() % 4);
+            for (int i = 0; i < count; ++i) {
+                const std::uint64_t distance = rng() % 8 == 0 ? rng() % 10'000'000 : rng() % 70'000;
+                wheel.Schedule(now + distance, next_value);
+                reference.emplace(now + distance, next_value);
+                deadline_of.push_back(now + distance);
+                ++next_value;
+            }
+            // Ticks of a few ms to tens of ms, now and then a long manual tick
+            now += rng() % 50 == 0 ? rng() % 5'000'000 : rng() % 60;
+
+            std::vector<std::uint32_t> expired;
+            wheel.Advance(now, expired);
+            std::vector<std::uint32_t> expected;
+            for (auto it = reference.begin(); it != reference.end() && it->first <= now;) {
+                expected.push_back(it->second);
+                it = reference.erase(it);
+            }
+            const bool ordered = std::ranges::is_sorted(expired, {}, [&](std::uint32_t v) { return deadline_of[v]; });
+            // Same set; values with equal deadlines may come in any order
+            std::ranges::sort(expired);
+            std::ranges::sort(expected);
+            same = ordered && expired == expected && wheel.Size() == reference.size();
+        }
+
+        THEN("the wheel fires exactly what a sorted scan would, in deadline order") {
+            CHECK(same);
+        }
+    }
+}
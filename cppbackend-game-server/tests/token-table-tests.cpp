@@ -0,0 +1,215 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cctype>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/game_app/token_table.h"
+
+using namespace std::literals;
+
+SCENARIO("Binary token keys") {
+    GIVEN("a generated token") {
+        app::TokenGen gen;
+        const auto key = gen.NewKey();
+        const auto token = app::FormatToken(key);
+
+        THEN("it is valid and parses back to the same key") {
+            CHECK(app::IsTokenValid(*token));
+            const auto parsed = app::ParseTokenKey(*token);
+            REQUIRE(parsed.has_value());
+            CHECK(*parsed == key);
+        }
+    }
+
+    GIVEN("a known token") {
+        THEN("the first 16 digits are the high half") {
+            const auto key = app::ParseTokenKey("0123456789abcdef00000000000000ff");
+            REQUIRE(key.has_value());
+            CHECK(key->hi == 0x0123456789abcdefull);
+            CHECK(key->lo == 0xffull);
+            CHECK(*app::FormatToken(*key) == "0123456789abcdef00000000000000ff");
+        }
+    }
+
+    GIVEN("malformed tokens") {
+        THEN("they do not parse") {
+            CHECK_FALSE(app::ParseTokenKey(""));
+            CHECK_FALSE(app::ParseTokenKey("0123456789abcdef"));
+            CHECK_FALSE(app::ParseTokenKey("0123456789abcdef0123456789abcdef0"));
+            CHECK_FALSE(app::ParseTokenKey("0123456789abcdeg0123456789abcdef"));
+            // Tokens are issued in lower case only
+            CHECK_FALSE(app::ParseTokenKey("0123456789ABCDEF0123456789abcdef"));
+        }
+    }
+}
+
+SCENARIO("Token format validation") {
+    GIVEN("a valid token") {
+        const std::string valid = "0123456789abcdefABCDEF0123456789";
+
+        THEN("it passes, and any single non-hex character breaks it") {
+            CHECK(app::IsTokenValid(valid));
+            for (size_t pos = 0; pos < valid.size(); ++pos) {
+                for (int c = 0; c < 256; ++c) {
+                    auto token = valid;
+                    token[pos] = static_cast<char>(c);
+                    const bool is_hex = std::isxdigit(c) != 0;
+                    if (app::IsTokenValid(token) != is_hex) {
+                        FAIL("position " << pos << ", character " << c);
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("tokens of a wrong length") {
+        THEN("they are invalid") {
+            CHECK_FALSE(app::IsTokenValid(""));
+            CHECK_FALSE(app::IsTokenValid("0123456789abcdef0123456789abcde"));
+            CHECK_FALSE(app::IsTokenValid("0123456789abcdef0123456789abcdef0"));
+        }
+    }
+}
+
+SCENARIO("ChaCha20 token generator") {
+    GIVEN("two generators with the same key and nonce") {
+        const game_rng::ChaCha20::Key key{1, 2, 3, 4, 5, 6, 7, 8};
+        game_rng::ChaCha20 first(key, {9, 10, 11});
+        game_rng::ChaCha20 second(key, {9, 10, 11});
+        game_rng::ChaCha20 other(key, {9, 10, 12});
+
+        THEN("they give the same sequence across buffer refills, another nonce gives another one") {
+            bool same = true, differs = false;
+            for (int i = 0; i < 1000; ++i) {
+                const auto value = first();
+                same = same && value == second();
+                differs = differs || value != other();
+            }
+            CHECK(same);
+            CHECK(differs);
+        }
+
+        THEN("outputs are the keystream words in order") {
+            const auto block = game_rng::ChaCha20::Generate(key, 0, {9, 10, 11});
+            CHECK(first() == (block[0] | (std::uint64_t{block[1]} << 32)));
+            CHECK(first() == (block[2] | (std::uint64_t{block[3]} << 32)));
+        }
+    }
+
+    GIVEN("a token generator") {
+        app::TokenGen gen;
+
+        THEN("tokens do not repeat") {
+            std::set<std::string> tokens;
+            for (int i = 0; i < 10000; ++i) {
+                tokens.insert(*gen());
+            }
+            CHECK(tokens.size() == 10000);
+        }
+    }
+}
+
+SCENARIO("Token table") {
+    GIVEN("a table with some values") {
+        app::TokenTable<int, 4> table;
+        app::TokenGen gen;
+        std::vector<app::TokenKey> keys;
+        for (int i = 0; i < 100; ++i) {
+            keys.push_back(gen.NewKey());
+            REQUIRE(table.Insert(keys.back(), std::make_shared<int>(i)));
+        }
+
+        THEN("every value is found by its key") {
+            CHECK(table.Size() == 100);
+            for (int i = 0; i < 100; ++i) {
+                auto value = table.Find(keys[i]);
+                REQUIRE(value);
+                CHECK(*value == i);
+            }
+            CHECK_FALSE(table.Find(gen.NewKey()));
+        }
+
+        WHEN("a key is inserted twice") {
+            const bool inserted = table.Insert(keys[0], std::make_shared<int>(-1));
+
+            THEN("the first value stays") {
+                CHECK_FALSE(inserted);
+                CHECK(*table.Find(keys[0]) == 0);
+            }
+        }
+
+        WHEN("a value is erased while a reader holds it") {
+            auto held = table.Find(keys[5]);
+            const bool erased = table.Erase(keys[5]);
+
+            THEN("it is gone from the table but still alive for the reader") {
+                CHECK(erased);
+                CHECK_FALSE(table.Erase(keys[5]));
+                CHECK_FALSE(table.Find(keys[5]));
+                CHECK(table.Size() == 99);
+                CHECK(*held == 5);
+            }
+        }
+
+        WHEN("values matching a predicate are erased") {
+            const size_t erased = table.EraseIf([](const app::TokenKey&, int value) {
+                return value % 2 == 0;
+            });
+
+            THEN("only the others are left") {
+                CHECK(erased == 50);
+                CHECK(table.Size() == 50);
+                CHECK_FALSE(table.Find(keys[0]));
+                CHECK(*table.Find(keys[1]) == 1);
+                CHECK(table.EraseIf([](const app::TokenKey&, int) { return false; }) == 0);
+            }
+        }
+    }
+
+    GIVEN("readers on several threads and a writer") {
+        app::TokenTable<int, 2> table;
+        app::TokenGen gen;
+        std::vector<app::TokenKey> stable_keys;
+        for (int i = 0; i < 64; ++i) {
+            stable_keys.push_back(gen.NewKey());
+            table.Insert(stable_keys.back(), std::make_shared<int>(i));
+        }
+
+        std::atomic_bool stop{false};
+        std::atomic<int> wrong{0};
+        std::vector<std::jthread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&, t] {
+                size_t i = t;
+                while (!stop.load()) {
+                    const auto& key = stable_keys[i++ % stable_keys.size()];
+                    auto value = table.Find(key);
+                    if (!value || *value != static_cast<int>((i - 1) % stable_keys.size())) {
+                        ++wrong;
+                    }
+                }
+            });
+        }
+
+        WHEN("the writer keeps adding and removing other keys") {
+            for (int i = 0; i < 2000; ++i) {
+                const auto key = gen.NewKey();
+                table.Insert(key, std::make_shared<int>(-1));
+                table.Erase(key);
+            }
+            stop = true;
+            readers.clear();
+
+            THEN("readers always see the stable values") {
+                CHECK(wrong.load() == 0);
+                CHECK(table.Size() == stable_keys.size());
+            }
+        }
+        stop = true;
+    }
+}
@@ -0,0 +1,138 @@
+#include "../src/common/sdk.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/program_options.hpp>
+
+#include "../src/common/boost_logger.h"
+#include "../src/common/cmd_parser.h"
+#include "../src/common/json_loader.h"
+#include "../src/game_app/application.h"
+#include "../src/game_app/replay_log.h"
+#include "../src/game_db/mock_database.h"
+
+// Re-runs a log recorded with `game_server --record-replay` without network and timers, as fast as possible.
+// Prints ticks per second and a hash of the final world: the same log must always give the same hash.
+
+namespace {
+
+namespace po = boost::program_options;
+using namespace std::literals;
+
+struct ReplayArgs {
+    std::string replay_file;
+    std::string config_file;        // empty - path stored in the log
+    uint32_t bot_threads{0};
+};
+
+[[nodiscard]] std::optional<ReplayArgs> ParseReplayArgs(int argc, const char* const argv[]) {
+    ReplayArgs args;
+    po::options_description options("Usage: game_replay <replay-file> [options]");
+    options.add_options()
+        ("help,h", "Show help")
+        ("replay-file", po::value(&args.replay_file)->value_name("file"s),
+            "Replay log written by game_server --record-replay")
+        ("config-file,c", po::value(&args.config_file)->value_name("file"s),
+            "Game config (default - path stored in the replay log)")
+        ("bot-threads", po::value(&args.bot_threads)->value_name("count"s),
+            "Extra threads computing bot decisions in parallel (default - 0)");
+
+    po::positional_options_description positional;
+    positional.add("replay-file", 1);
+
+    po::variables_map vm;
+    try {
+        po::store(po::command_line_parser(argc, argv).options(options).positional(positional).run(), vm);
+        po::notify(vm);
+    } catch (const po::error& e) {
+        std::cerr << "Command line parsing error: " << e.what() << std::endl;
+        std::cout << options << std::endl;
+        return std::nullopt;
+    }
+    if (vm.contains("help"s) || args.replay_file.empty()) {
+        std::cout << options;
+        return std::nullopt;
+    }
+    if (args.bot_threads > parse::MAX_BOT_THREADS) {
+        std::cerr << "Error: bot-threads cannot exceed " << parse::MAX_BOT_THREADS << std::endl;
+        return std::nullopt;
+    }
+    return args;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[]) {
+    try {
+        auto replay_args = ParseReplayArgs(argc, argv);
+        if (!replay_args) {
+            return EXIT_FAILURE;
+        }
+        boost_logger::InitBoostLogSetFilter(boost::log::trivial::warning);
+
+        replay::ReplayReader reader(replay_args->replay_file);
+        const auto& header = reader.GetHeader();
+
+        // Same settings as the recorded server, without database and with retirement as it was
+        parse::Args args;
+        args.config_file = replay_args->config_file.empty() ? header.config_file : replay_args->config_file;
+        args.enable_bots = header.enable_bots;
+        args.bot_threads = replay_args->bot_threads;
+        args.bot_seed = header.bot_seed;
+        args.bot_plan_budget = header.bot_plan_budget;
+        args.game_seed = header.game_seed;
+        args.randomize_spawn_points = header.randomize_spawn_points;
+        args.no_database = !header.enable_retirement;
+
+        auto game = json_loader::LoadGame(args.config_file);
+        boost::asio::io_context ioc;
+        db::MockDatabase database;
+        app::Application app(game, args, ioc, database);
+
+        std::uint64_t ticks = 0, joins = 0, actions = 0;
+        std::chrono::milliseconds game_time{0};
+        replay::Record record;
+
+        const auto start = std::chrono::steady_clock::now();
+        while (reader.Next(record)) {
+            switch (record.type) {
+                case replay::RecordType::TICK:
+                    app.Tick(record.delta);
+                    game_time += record.delta;
+                    ++ticks;
+                    break;
+                case replay::RecordType::JOIN:
+                    (void)app.AddPlayer(record.name, record.map);
+                    ++joins;
+                    break;
+                case replay::RecordType::ACTION:
+                    // Retired players cannot act, so the player must exist
+                    if (auto player = app.GetPlayers().FindPlayerById(record.player_id)) {
+                        app.SetPlayerDirection(*player, record.direction);
+                    }
+                    ++actions;
+                    break;
+            }
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "config:      " << args.config_file << '\n'
+                  << "records:     " << ticks << " ticks, " << joins << " joins, " << actions << " actions\n"
+                  << "game time:   " << game_time.count() << " ms\n"
+                  << "wall time:   " << std::fixed << std::setprecision(3) << elapsed.count() << " s\n"
+                  << "ticks/sec:   " << std::setprecision(1)
+                  << (elapsed.count() > 0 ? static_cast<double>(ticks) / elapsed.count() : 0.0) << '\n'
+                  << "state hash:  " << std::hex << std::setw(16) << std::setfill('0')
+                  << replay::HashGameState(game) << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "game_replay: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}